@@ -0,0 +1,228 @@
+// Copyright (c) 2020 The ShroudX developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(HAVE_CONFIG_H)
+#include "config/bitcoin-config.h"
+#endif
+
+#include "bench.h"
+#include "arith_uint256.h"
+#include "chain.h"
+#include "chainparams.h"
+#include "coins.h"
+#include "consensus/consensus.h"
+#include "consensus/merkle.h"
+#include "consensus/validation.h"
+#include "key.h"
+#include "keystore.h"
+#include "main.h"
+#include "miner.h"
+#include "pos.h"
+#include "random.h"
+#include "script/sign.h"
+#include "script/standard.h"
+#include "util.h"
+#ifdef ENABLE_WALLET
+#include "wallet/wallet.h"
+#endif
+
+#include <boost/filesystem.hpp>
+
+#include <memory>
+
+/* Stakeable outputs in the chain, their blocks and the blocks that make them mature */
+static const int STAKE_OUTPUTS = 2000;
+static const int STAKE_OUTPUTS_PER_BLOCK = 10;
+static const CAmount STAKE_VALUE = 100 * COIN;
+
+/* A chain of blocks written to a temporary data directory with STAKE_OUTPUTS mature outputs to one key, set up as
+ * the active chain and coins tip. Stake inputs are then looked up the way a node does, from the coins to the block
+ * on disk */
+class StakingChain
+{
+public:
+    CBasicKeyStore keystore;
+    CKey key;
+    CScript script;
+    std::vector<COutPoint> stakes;
+    std::vector<std::unique_ptr<CBlockIndex>> blocks;
+#ifdef ENABLE_WALLET
+    CWallet wallet;
+#endif
+
+    StakingChain()
+    {
+        ClearDatadirCache();
+        pathTemp = boost::filesystem::temp_directory_path() / strprintf("bench_pos_%lu_%i", (unsigned long)GetTime(), (int)GetRand(100000));
+        boost::filesystem::create_directories(pathTemp);
+        mapArgs["-datadir"] = pathTemp.string();
+        pcoinsTip = &coins;
+
+        key.MakeNewKey(true);
+        keystore.AddKey(key);
+        script = GetScriptForDestination(key.GetPubKey().GetID());
+#ifdef ENABLE_WALLET
+        {
+            LOCK(wallet.cs_wallet);
+            wallet.AddKeyPubKey(key, key.GetPubKey());
+        }
+#endif
+
+        int stakeBlocks = STAKE_OUTPUTS / STAKE_OUTPUTS_PER_BLOCK;
+        CDiskBlockPos pos(0, 0);
+        for (int height = 0; height <= stakeBlocks + COINBASE_MATURITY; height++) {
+            CBlock block;
+            block.nVersion = 4;
+            block.hashPrevBlock = blocks.empty() ? uint256() : blocks.back()->GetBlockHash();
+            block.nTime = 1583020800 + height * 120;
+            block.nBits = UintToArith256(Params().GetConsensus().powLimit).GetCompact();
+
+            CMutableTransaction coinbase;
+            coinbase.vin.resize(1);
+            coinbase.vin[0].prevout.SetNull();
+            coinbase.vin[0].scriptSig = CScript() << height << OP_0;
+            coinbase.vout.push_back(CTxOut(0, CScript() << OP_TRUE));
+            block.vtx.push_back(coinbase);
+
+            for (int i = 0; height > 0 && height <= stakeBlocks && i < STAKE_OUTPUTS_PER_BLOCK; i++) {
+                CMutableTransaction tx;
+                tx.vin.push_back(CTxIn(COutPoint(ArithToUint256(arith_uint256(stakes.size() + 1)), 0)));
+                tx.vout.push_back(CTxOut(STAKE_VALUE, script));
+                block.vtx.push_back(tx);
+                stakes.push_back(COutPoint(block.vtx.back().GetHash(), 0));
+            }
+            block.hashMerkleRoot = BlockMerkleRoot(block);
+
+            bool fWritten = WriteBlockToDisk(block, pos, Params().MessageStart());
+            assert(fWritten);
+            AddBlock(block, pos);
+            pos.nPos += ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+        }
+
+        chainActive.SetTip(blocks.back().get());
+        pindexBestHeader = blocks.back().get();
+    }
+
+    ~StakingChain()
+    {
+        chainActive.SetTip(NULL);
+        pindexBestHeader = NULL;
+        mapBlockIndex.clear();
+        pcoinsTip = NULL;
+        boost::filesystem::remove_all(pathTemp);
+    }
+
+    static StakingChain& Get()
+    {
+        static StakingChain chain;
+        return chain;
+    }
+
+private:
+    boost::filesystem::path pathTemp;
+    CCoinsView coinsDummy;
+    CCoinsViewCache coins{&coinsDummy};
+
+    void AddBlock(const CBlock& block, const CDiskBlockPos& pos)
+    {
+        blocks.emplace_back(new CBlockIndex(block));
+        CBlockIndex* pindex = blocks.back().get();
+        pindex->phashBlock = &mapBlockIndex.insert(std::make_pair(block.GetHash(), pindex)).first->first;
+        pindex->pprev = blocks.size() > 1 ? blocks[blocks.size() - 2].get() : NULL;
+        pindex->nHeight = blocks.size() - 1;
+        pindex->nStakeModifier = GetRandHash();
+        pindex->nFile = pos.nFile;
+        pindex->nDataPos = pos.nPos;
+        pindex->nStatus = BLOCK_HAVE_DATA | BLOCK_VALID_SCRIPTS;
+        pindex->BuildSkip();
+
+#ifdef ENABLE_WALLET
+        LOCK(wallet.cs_wallet);
+#endif
+        for (size_t i = 1; i < block.vtx.size(); i++) {
+            const CTransaction& tx = block.vtx[i];
+            coins.AddCoin(COutPoint(tx.GetHash(), 0), Coin(tx.vout[0], pindex->nHeight, false, false), false);
+#ifdef ENABLE_WALLET
+            CWalletTx wtx(&wallet, tx);
+            wtx.hashBlock = pindex->GetBlockHash();
+            wtx.nIndex = i;
+            wallet.AddToWallet(wtx, true, NULL);
+#endif
+        }
+    }
+};
+
+/* The kernel hash of one output against the target, over all the outputs of the chain in turn */
+static void PoS_CheckStakeKernelHash(benchmark::State& state)
+{
+    StakingChain& chain = StakingChain::Get();
+    const CBlockIndex* pindexPrev = chainActive.Tip();
+    unsigned int nTime = pindexPrev->GetBlockTime() + 120;
+
+    std::vector<Coin> coins;
+    for (const COutPoint& stake : chain.stakes)
+        coins.push_back(pcoinsTip->AccessCoin(stake));
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        CheckStakeKernelHash(pindexPrev, pindexPrev->nBits, pindexPrev->GetBlockTime(), coins[i], chain.stakes[i], nTime);
+        i = (i + 1) % coins.size();
+    }
+}
+
+/* A coinstake as block validation checks it, with the lookup of the staked output and its block and the check of
+ * the signature. The target is set so that the kernel hash meets it */
+static void PoS_CheckProofOfStake(benchmark::State& state)
+{
+    StakingChain& chain = StakingChain::Get();
+    CBlockIndex* pindexPrev = chainActive.Tip();
+    unsigned int nTime = pindexPrev->GetBlockTime() + 120;
+    arith_uint256 target = ~arith_uint256();
+    target /= STAKE_VALUE;
+    unsigned int nBits = target.GetCompact();
+
+    CBlock block;
+    bool fRead = ReadBlockFromDisk(block, pindexPrev->GetAncestor(1), Params().GetConsensus());
+    assert(fRead);
+    const CTransaction& txPrev = block.vtx[1];
+
+    CMutableTransaction coinstake;
+    coinstake.vin.push_back(CTxIn(txPrev.GetHash(), 0));
+    coinstake.vout.push_back(CTxOut());
+    coinstake.vout.push_back(CTxOut(STAKE_VALUE, chain.script));
+    bool fSigned = SignSignature(chain.keystore, txPrev, coinstake, 0, SIGHASH_ALL);
+    assert(fSigned);
+    CTransaction tx(coinstake);
+
+    while (state.KeepRunning()) {
+        CValidationState validationState;
+        bool fValid = CheckProofOfStake(pindexPrev, tx, nTime, nBits, validationState, NULL);
+        assert(fValid);
+    }
+}
+
+BENCHMARK(PoS_CheckStakeKernelHash);
+BENCHMARK(PoS_CheckProofOfStake);
+
+#ifdef ENABLE_WALLET
+/* One pass of the staker over all the outputs of the wallet, as the miner runs it every second. The target is out
+ * of reach so every output is checked */
+static void PoS_CreateCoinStake(benchmark::State& state)
+{
+    StakingChain& chain = StakingChain::Get();
+    unsigned int nBits = arith_uint256(1).GetCompact();
+    int64_t nTime = chainActive.Tip()->GetBlockTime() + 120;
+
+    while (state.KeepRunning()) {
+        CAmount nFees = 0;
+        CMutableTransaction coinstake;
+        CKey key;
+        CBlockTemplate blockTemplate;
+        bool fStaked = chain.wallet.CreateCoinStake(chain.wallet, nBits, nTime, 1, nFees, coinstake, key, &blockTemplate);
+        assert(!fStaked);
+    }
+}
+
+BENCHMARK(PoS_CreateCoinStake);
+#endif
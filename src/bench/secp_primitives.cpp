@@ -0,0 +1,101 @@
+// Copyright (c) 2020 The ShroudX developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "coin_containers.h"
+#include "secp256k1/include/GroupElement.h"
+#include "secp256k1/include/MultiExponent.h"
+#include "secp256k1/include/Scalar.h"
+
+#include <vector>
+
+using namespace secp_primitives;
+
+static void GroupElement_Multiply(benchmark::State& state)
+{
+    GroupElement point;
+    point.randomize();
+    Scalar multiplier;
+    multiplier.randomize();
+    while (state.KeepRunning()) {
+        point *= multiplier;
+    }
+}
+
+/* Conversion of a sum, which is in jacobian form, to affine form */
+static void GroupElement_Normalize(benchmark::State& state)
+{
+    GroupElement g, sum;
+    g.randomize();
+    sum.randomize();
+    sum += g;
+    while (state.KeepRunning()) {
+        GroupElement point(sum);
+        point.normalize();
+    }
+}
+
+/* sum of powers[i] * generators[i], the core of sigma proof verification */
+static void MultiExponentiation(benchmark::State& state, size_t size)
+{
+    std::vector<GroupElement> generators(size);
+    std::vector<Scalar> powers(size);
+    for (size_t i = 0; i < size; i++) {
+        generators[i].randomize();
+        powers[i].randomize();
+    }
+
+    MultiExponent multiExponent(generators, powers);
+    while (state.KeepRunning()) {
+        multiExponent.get_multiple();
+    }
+}
+
+static void MultiExponent_16(benchmark::State& state)
+{
+    MultiExponentiation(state, 16);
+}
+
+static void MultiExponent_256(benchmark::State& state)
+{
+    MultiExponentiation(state, 256);
+}
+
+static void MultiExponent_16384(benchmark::State& state)
+{
+    MultiExponentiation(state, 16384);
+}
+
+/* The hashers of the mint and spend containers of the sigma state */
+static void CScalarHash_Hash(benchmark::State& state)
+{
+    sigma::CScalarHash hasher;
+    Scalar serial;
+    serial.randomize();
+    size_t hash = 0;
+    while (state.KeepRunning()) {
+        hash ^= hasher(serial);
+    }
+}
+
+static void CPublicCoinHash_Hash(benchmark::State& state)
+{
+    sigma::CPublicCoinHash hasher;
+    GroupElement value;
+    value.randomize();
+    value.normalize();
+    sigma::PublicCoin coin(value, sigma::CoinDenomination::SIGMA_DENOM_1);
+    size_t hash = 0;
+    while (state.KeepRunning()) {
+        hash ^= hasher(coin);
+    }
+}
+
+BENCHMARK(GroupElement_Multiply);
+BENCHMARK(GroupElement_Normalize);
+BENCHMARK(MultiExponent_16);
+BENCHMARK(MultiExponent_256);
+BENCHMARK(MultiExponent_16384);
+BENCHMARK(CScalarHash_Hash);
+BENCHMARK(CPublicCoinHash_Hash);
@@ -0,0 +1,150 @@
+// Copyright (c) 2020 The ShroudX developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "libzerocoin/ParallelTasks.h"
+#include "sigma/coinspend.h"
+
+/* Size of the anonymity set of a spend, n^m */
+static size_t AnonymitySetSize(const sigma::Params* params)
+{
+    size_t setSize = params->get_n();
+    for (uint64_t i = 1; i < params->get_m(); i++)
+        setSize *= params->get_n();
+    return setSize;
+}
+
+/* A full anonymity set ending with the coins, the rest of the set doesn't need to be real coins */
+static std::vector<sigma::PublicCoin> MakeAnonymitySet(const sigma::Params* params, const std::vector<sigma::PrivateCoin>& coins)
+{
+    size_t setSize = AnonymitySetSize(params);
+
+    std::vector<sigma::PublicCoin> anonymitySet;
+    anonymitySet.reserve(setSize);
+    GroupElement g, value;
+    g.set_base_g();
+    value.set_base_g();
+    for (size_t i = 0; i < setSize - coins.size(); i++) {
+        value += g;
+        anonymitySet.emplace_back(value, sigma::CoinDenomination::SIGMA_DENOM_1);
+    }
+    for (const sigma::PrivateCoin& coin : coins)
+        anonymitySet.push_back(coin.getPublicCoin());
+    return anonymitySet;
+}
+
+/* Creation of the spend proofs of a transaction, by the number of inputs. Inputs are spent from a full
+ * anonymity set and their proofs are created on the thread pool, like the wallet does */
+static void SigmaSpend(benchmark::State& state, size_t inputs)
+{
+    const sigma::Params* params = sigma::Params::get_default();
+
+    std::vector<sigma::PrivateCoin> coins;
+    for (size_t i = 0; i < inputs; i++)
+        coins.emplace_back(params, sigma::CoinDenomination::SIGMA_DENOM_1);
+
+    std::vector<sigma::PublicCoin> anonymitySet = MakeAnonymitySet(params, coins);
+    sigma::SpendMetaData metaData(1, uint256S("1"), uint256S("2"));
+
+    while (state.KeepRunning()) {
+        libzerocoin::ParallelTasks tasks(inputs);
+        for (const sigma::PrivateCoin& coin : coins) {
+            tasks.Add([params, &coin, &anonymitySet, &metaData] {
+                sigma::CoinSpend spend(params, coin, anonymitySet, metaData, true);
+            });
+        }
+        tasks.Wait();
+    }
+}
+
+static void SigmaSpend_1Input(benchmark::State& state)
+{
+    SigmaSpend(state, 1);
+}
+
+static void SigmaSpend_4Inputs(benchmark::State& state)
+{
+    SigmaSpend(state, 4);
+}
+
+static void SigmaSpend_16Inputs(benchmark::State& state)
+{
+    SigmaSpend(state, 16);
+}
+
+BENCHMARK(SigmaSpend_1Input);
+BENCHMARK(SigmaSpend_4Inputs);
+BENCHMARK(SigmaSpend_16Inputs);
+
+/* Verification of one spend against a full anonymity set, what a node does for every sigma input it accepts */
+static void SigmaSpend_Verify(benchmark::State& state)
+{
+    const sigma::Params* params = sigma::Params::get_default();
+
+    std::vector<sigma::PrivateCoin> coins;
+    coins.emplace_back(params, sigma::CoinDenomination::SIGMA_DENOM_1);
+    std::vector<sigma::PublicCoin> anonymitySet = MakeAnonymitySet(params, coins);
+    sigma::SpendMetaData metaData(1, uint256S("1"), uint256S("2"));
+    sigma::CoinSpend spend(params, coins[0], anonymitySet, metaData, true);
+
+    while (state.KeepRunning()) {
+        assert(spend.Verify(anonymitySet, metaData, true));
+    }
+}
+
+BENCHMARK(SigmaSpend_Verify);
+
+/* The one-out-of-many proof alone at the production n and m, without the serial number and the signature of
+ * CoinSpend */
+struct SigmaPlusSetup {
+    typedef sigma::SigmaPlusProof<Scalar, GroupElement> Proof;
+
+    const sigma::Params* params;
+    std::vector<GroupElement> commits;
+    size_t index;
+    Scalar r;
+
+    SigmaPlusSetup() : params(sigma::Params::get_default())
+    {
+        size_t setSize = AnonymitySetSize(params);
+        commits.resize(setSize);
+        for (GroupElement& commit : commits)
+            commit.randomize();
+
+        // the commitment to zero being proven is in the middle of the set
+        index = setSize / 2;
+        r.randomize();
+        commits[index] = sigma::SigmaPrimitives<Scalar, GroupElement>::commit(params->get_g(), Scalar(uint64_t(0)), params->get_h0(), r);
+    }
+
+    Proof MakeProof() const
+    {
+        sigma::SigmaPlusProver<Scalar, GroupElement> prover(params->get_g(), params->get_h(), params->get_n(), params->get_m());
+        Proof proof(params->get_n(), params->get_m());
+        prover.proof(commits, index, r, true, proof);
+        return proof;
+    }
+};
+
+static void SigmaPlus_Prove(benchmark::State& state)
+{
+    SigmaPlusSetup setup;
+    while (state.KeepRunning()) {
+        setup.MakeProof();
+    }
+}
+
+static void SigmaPlus_Verify(benchmark::State& state)
+{
+    SigmaPlusSetup setup;
+    SigmaPlusSetup::Proof proof = setup.MakeProof();
+    const sigma::Params* params = setup.params;
+    sigma::SigmaPlusVerifier<Scalar, GroupElement> verifier(params->get_g(), params->get_h(), params->get_n(), params->get_m());
+    while (state.KeepRunning()) {
+        assert(verifier.verify(setup.commits, proof, true));
+    }
+}
+
+BENCHMARK(SigmaPlus_Prove);
+BENCHMARK(SigmaPlus_Verify);
@@ -0,0 +1,108 @@
+// Copyright (c) 2020 The ShroudX developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "chain.h"
+#include "sigma.h"
+
+/* Number of mints and spends in the state, roughly the size of the main net sigma state */
+static const size_t STATE_MINTS = 100000;
+static const size_t STATE_SPENDS = 50000;
+
+/* Coin values as they come out of a transaction, i.e. deserialized and in affine form */
+static std::vector<GroupElement> MakeCoinValues(size_t count)
+{
+    std::vector<GroupElement> values;
+    values.reserve(count);
+
+    GroupElement g, point;
+    g.set_base_g();
+    point.set_base_g();
+
+    unsigned char buffer[GroupElement::serialize_size];
+    for (size_t i = 0; i < count; i++) {
+        point += g;
+        point.serialize(buffer);
+        values.emplace_back();
+        values.back().deserialize(buffer);
+    }
+    return values;
+}
+
+static std::vector<Scalar> MakeSerials(size_t count)
+{
+    std::vector<Scalar> serials;
+    serials.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        serials.emplace_back();
+        serials.back().randomize();
+    }
+    return serials;
+}
+
+static void FillState(sigma::CSigmaState& state, CBlockIndex& index, const std::vector<GroupElement>& values, const std::vector<Scalar>& serials)
+{
+    index.nHeight = 1;
+    std::vector<sigma::PublicCoin>& mints = index.PrivacyData().sigmaMintedPubCoins[std::make_pair(sigma::CoinDenomination::SIGMA_DENOM_1, 1)];
+    for (const GroupElement& value : values)
+        mints.emplace_back(value, sigma::CoinDenomination::SIGMA_DENOM_1);
+    for (const Scalar& serial : serials)
+        index.PrivacyData().sigmaSpentSerials[serial] = sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
+
+    state.AddBlock(&index);
+}
+
+static void SigmaState_HasCoin(benchmark::State& state)
+{
+    std::vector<GroupElement> values = MakeCoinValues(STATE_MINTS);
+    sigma::CSigmaState sigmaState;
+    CBlockIndex index;
+    FillState(sigmaState, index, values, {});
+
+    // Lookups of new coin objects, like the ones created for every mint being checked
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        sigma::PublicCoin coin(values[i++ % values.size()], sigma::CoinDenomination::SIGMA_DENOM_1);
+        sigmaState.HasCoin(coin);
+    }
+}
+
+static void SigmaState_IsUsedCoinSerial(benchmark::State& state)
+{
+    std::vector<Scalar> serials = MakeSerials(STATE_SPENDS);
+    sigma::CSigmaState sigmaState;
+    CBlockIndex index;
+    FillState(sigmaState, index, {}, serials);
+
+    size_t i = 0;
+    while (state.KeepRunning())
+        sigmaState.IsUsedCoinSerial(serials[i++ % serials.size()]);
+}
+
+static void SigmaState_CanAddToMempool(benchmark::State& state)
+{
+    std::vector<GroupElement> values = MakeCoinValues(STATE_MINTS);
+    std::vector<Scalar> serials = MakeSerials(STATE_SPENDS);
+    sigma::CSigmaState sigmaState;
+    CBlockIndex index;
+    FillState(sigmaState, index, values, serials);
+
+    // Mempool transactions spend and mint coins which are not in the chain yet
+    std::vector<GroupElement> mempoolValues = MakeCoinValues(STATE_MINTS + STATE_MINTS / 10);
+    mempoolValues.erase(mempoolValues.begin(), mempoolValues.begin() + STATE_MINTS);
+    std::vector<Scalar> mempoolSerials = MakeSerials(STATE_SPENDS / 10);
+    sigmaState.AddMintsToMempool(mempoolValues);
+    sigmaState.AddSpendToMempool(mempoolSerials, uint256());
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        sigmaState.CanAddMintToMempool(mempoolValues[i % mempoolValues.size()]);
+        sigmaState.CanAddSpendToMempool(mempoolSerials[i % mempoolSerials.size()]);
+        i++;
+    }
+}
+
+BENCHMARK(SigmaState_HasCoin);
+BENCHMARK(SigmaState_IsUsedCoinSerial);
+BENCHMARK(SigmaState_CanAddToMempool);
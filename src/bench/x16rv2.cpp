@@ -0,0 +1,123 @@
+// Copyright (c) 2020 The ShroudX developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "chainparams.h"
+#include "chainparamsbase.h"
+#include "primitives/block.h"
+#include "uint256.h"
+#include "crypto/x16Rv2/hash_algos.h"
+
+#include <vector>
+
+/* X16Rv2 of an 80 byte header where the previous block hash makes every round run the same algorithm. Comparing
+ * them shows which of the sixteen algorithms a chain of rounds spends its time in */
+static void X16RV2Rounds(benchmark::State& state, int algorithm)
+{
+    uint256 prevBlockHash = uint256S(std::string(64, "0123456789abcdef"[algorithm]));
+    std::vector<unsigned char> header(80, 0);
+    uint256 hash;
+    while (state.KeepRunning()) {
+        hash = HashX16RV2(header.begin(), header.end(), prevBlockHash);
+        header[0] = *hash.begin();
+    }
+}
+
+#define X16RV2_ROUNDS_BENCHMARK(algorithm, name) \
+    static void X16RV2_##name(benchmark::State& state) { X16RV2Rounds(state, algorithm); } \
+    BENCHMARK(X16RV2_##name);
+
+X16RV2_ROUNDS_BENCHMARK(0, Blake)
+X16RV2_ROUNDS_BENCHMARK(1, Bmw)
+X16RV2_ROUNDS_BENCHMARK(2, Groestl)
+X16RV2_ROUNDS_BENCHMARK(3, Jh)
+X16RV2_ROUNDS_BENCHMARK(4, TigerKeccak)
+X16RV2_ROUNDS_BENCHMARK(5, Skein)
+X16RV2_ROUNDS_BENCHMARK(6, TigerLuffa)
+X16RV2_ROUNDS_BENCHMARK(7, Cubehash)
+X16RV2_ROUNDS_BENCHMARK(8, Shavite)
+X16RV2_ROUNDS_BENCHMARK(9, Simd)
+X16RV2_ROUNDS_BENCHMARK(10, Echo)
+X16RV2_ROUNDS_BENCHMARK(11, Hamsi)
+X16RV2_ROUNDS_BENCHMARK(12, Fugue)
+X16RV2_ROUNDS_BENCHMARK(13, Shabal)
+X16RV2_ROUNDS_BENCHMARK(14, Whirlpool)
+X16RV2_ROUNDS_BENCHMARK(15, TigerSha512)
+
+/* Every algorithm once, the average cost of a header hash */
+static void X16RV2_AllAlgorithms(benchmark::State& state)
+{
+    uint256 prevBlockHash = uint256S("fedcba98765432100123456789abcdef0123456789abcdef0123456789abcdef");
+    std::vector<unsigned char> header(80, 0);
+    uint256 hash;
+    while (state.KeepRunning()) {
+        hash = HashX16RV2(header.begin(), header.end(), prevBlockHash);
+        header[0] = *hash.begin();
+    }
+}
+
+/* The header of the mainnet genesis block, hashed the way block validation does */
+static void X16RV2_BlockHeaderGetHash(benchmark::State& state)
+{
+    CBlockHeader header = Params(CBaseChainParams::MAIN).GenesisBlock().GetBlockHeader();
+    while (state.KeepRunning()) {
+        header.GetHash();
+        header.nNonce++;
+    }
+}
+
+/* Eight nonces of the same header at a time, the way generateBlocks scans them */
+static void X16RV2_BlockHeaderGetPoWHashes8(benchmark::State& state)
+{
+    CBlockHeader header = Params(CBaseChainParams::MAIN).GenesisBlock().GetBlockHeader();
+    uint256 hashes[8];
+    while (state.KeepRunning()) {
+        header.GetPoWHashes(8, hashes);
+        header.nNonce += 8;
+    }
+}
+
+BENCHMARK(X16RV2_AllAlgorithms);
+BENCHMARK(X16RV2_BlockHeaderGetHash);
+BENCHMARK(X16RV2_BlockHeaderGetPoWHashes8);
+
+/* A single sph kernel from init to close on an 80 byte input (the first round) or a 64 byte input (the others) */
+template<typename Context>
+static void SphHash(benchmark::State& state, size_t len, void (*init)(void*),
+                    void (*update)(void*, const void*, size_t), void (*close)(void*, void*))
+{
+    Context context;
+    std::vector<unsigned char> in(len, 0);
+    unsigned char hash[64];
+    while (state.KeepRunning()) {
+        init(&context);
+        update(&context, in.data(), in.size());
+        close(&context, hash);
+        in[0] = hash[0];
+    }
+}
+
+#define SPH_BENCHMARK(name, context, init, update, close) \
+    static void Sph_##name##_80b(benchmark::State& state) { SphHash<context>(state, 80, init, update, close); } \
+    static void Sph_##name##_64b(benchmark::State& state) { SphHash<context>(state, 64, init, update, close); } \
+    BENCHMARK(Sph_##name##_80b); \
+    BENCHMARK(Sph_##name##_64b);
+
+SPH_BENCHMARK(Blake512, sph_blake512_context, sph_blake512_init, sph_blake512, sph_blake512_close)
+SPH_BENCHMARK(Bmw512, sph_bmw512_context, sph_bmw512_init, sph_bmw512, sph_bmw512_close)
+SPH_BENCHMARK(Groestl512, sph_groestl512_context, sph_groestl512_init, sph_groestl512, sph_groestl512_close)
+SPH_BENCHMARK(Jh512, sph_jh512_context, sph_jh512_init, sph_jh512, sph_jh512_close)
+SPH_BENCHMARK(Keccak512, sph_keccak512_context, sph_keccak512_init, sph_keccak512, sph_keccak512_close)
+SPH_BENCHMARK(Skein512, sph_skein512_context, sph_skein512_init, sph_skein512, sph_skein512_close)
+SPH_BENCHMARK(Luffa512, sph_luffa512_context, sph_luffa512_init, sph_luffa512, sph_luffa512_close)
+SPH_BENCHMARK(Cubehash512, sph_cubehash512_context, sph_cubehash512_init, sph_cubehash512, sph_cubehash512_close)
+SPH_BENCHMARK(Shavite512, sph_shavite512_context, sph_shavite512_init, sph_shavite512, sph_shavite512_close)
+SPH_BENCHMARK(Simd512, sph_simd512_context, sph_simd512_init, sph_simd512, sph_simd512_close)
+SPH_BENCHMARK(Echo512, sph_echo512_context, sph_echo512_init, sph_echo512, sph_echo512_close)
+SPH_BENCHMARK(Hamsi512, sph_hamsi512_context, sph_hamsi512_init, sph_hamsi512, sph_hamsi512_close)
+SPH_BENCHMARK(Fugue512, sph_fugue512_context, sph_fugue512_init, sph_fugue512, sph_fugue512_close)
+SPH_BENCHMARK(Shabal512, sph_shabal512_context, sph_shabal512_init, sph_shabal512, sph_shabal512_close)
+SPH_BENCHMARK(Whirlpool, sph_whirlpool_context, sph_whirlpool_init, sph_whirlpool, sph_whirlpool_close)
+SPH_BENCHMARK(Sha512, sph_sha512_context, sph_sha512_init, sph_sha512, sph_sha512_close)
+SPH_BENCHMARK(Tiger, sph_tiger_context, sph_tiger_init, sph_tiger, sph_tiger_close)
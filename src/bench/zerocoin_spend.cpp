@@ -0,0 +1,43 @@
+// Copyright (c) 2020 The ShroudX developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "libzerocoin/Zerocoin.h"
+#include "streams.h"
+#include "version.h"
+#include "zerocoin.h"
+#include "zerocoin_params.h"
+
+/* Verification of a zerocoin spend shaped like the ones on mainnet: a version 2 spend under the second
+ * modulus from an accumulator holding several coins, deserialized from the wire before it is verified */
+static void ZerocoinSpendVerify(benchmark::State& state)
+{
+    const libzerocoin::Params* params = ZCParamsV2;
+    const libzerocoin::CoinDenomination denomination = libzerocoin::ZQ_GOLDWASSER;
+
+    libzerocoin::PrivateCoin coin(params, denomination, ZEROCOIN_TX_VERSION_2);
+    libzerocoin::Accumulator accumulator(params, denomination);
+    libzerocoin::AccumulatorWitness witness(params, accumulator, coin.getPublicCoin());
+    for (int i = 0; i < 10; i++) {
+        libzerocoin::PrivateCoin other(params, denomination, ZEROCOIN_TX_VERSION_2);
+        accumulator += other.getPublicCoin();
+        witness += other.getPublicCoin();
+    }
+    accumulator += coin.getPublicCoin();
+
+    libzerocoin::SpendMetaData metaData(ZC_MODULUS_V2_BASE_ID + 1, uint256S("1"));
+    libzerocoin::CoinSpend spend(params, coin, accumulator, witness, metaData, uint256S("2"));
+    spend.setVersion(ZEROCOIN_TX_VERSION_2);
+
+    CDataStream serialized(SER_NETWORK, PROTOCOL_VERSION);
+    serialized << spend;
+    libzerocoin::CoinSpend received(params, serialized);
+
+    while (state.KeepRunning()) {
+        if (!received.Verify(accumulator, metaData))
+            throw std::runtime_error("ZerocoinSpendVerify : spend doesn't verify");
+    }
+}
+
+BENCHMARK(ZerocoinSpendVerify);
@@ -106,6 +106,43 @@ const CBlockIndex* CBlockIndex::GetAncestor(int height) const
     return const_cast<CBlockIndex*>(this)->GetAncestor(height);
 }
 
+CBlockIndexPrivacyDataStore *pprivacydatastore = NULL;
+
+const CBlockIndexPrivacyData& CBlockIndex::GetPrivacyData() const
+{
+    static const CBlockIndexPrivacyData emptyPrivacyData;
+
+    // Don't allocate a payload for every block walked over, most of them don't have any
+    if (!privacyData && !(nStatus & BLOCK_HAVE_PRIVACY_DATA))
+        return emptyPrivacyData;
+    return const_cast<CBlockIndex*>(this)->PrivacyData();
+}
+
+CBlockIndexPrivacyData& CBlockIndex::PrivacyData()
+{
+    bool fTracked = pprivacydatastore != NULL && phashBlock != NULL;
+    if (privacyData) {
+        if (fTracked)
+            pprivacydatastore->TouchPrivacyData(*this);
+    }
+    else {
+        privacyData = std::make_shared<CBlockIndexPrivacyData>();
+        if (fTracked)
+            pprivacydatastore->LoadPrivacyData(*this, *privacyData);
+    }
+    return *privacyData;
+}
+
+void CBlockIndex::UpdatePrivacyDataStatus()
+{
+    if (!privacyData)
+        return;
+    if (privacyData->IsNull())
+        nStatus &= ~BLOCK_HAVE_PRIVACY_DATA;
+    else
+        nStatus |= BLOCK_HAVE_PRIVACY_DATA;
+}
+
 void CBlockIndex::BuildSkip()
 {
     if (pprev)
@@ -22,6 +22,7 @@
 #include "coin_containers.h"
 #include "streams.h"
 
+#include <memory>
 #include <vector>
 #include <unordered_set>
 
@@ -161,8 +162,84 @@ enum BlockStatus: uint32_t {
     BLOCK_PROOF_OF_STAKE     =   256, //! is proof-of-stake block
     BLOCK_STAKE_ENTROPY      =   512,
     BLOCK_STAKE_MODIFIER     =   1024,
+
+    BLOCK_PRIVACY_DATA_EXTERNAL = 2048, //!< zerocoin/sigma payload is not stored inline in the block index entry
+    BLOCK_HAVE_PRIVACY_DATA     = 4096, //!< block tree database has a zerocoin/sigma payload record for this block
 };
 
+/** Zerocoin and sigma mints and spends of a block, stored apart from the block index entry. */
+class CBlockIndexPrivacyData
+{
+public:
+    //! Public coin values of mints in this block, ordered by serialized value of public coin
+    //! Maps <denomination,id> to vector of public coins
+    map<pair<int,int>, vector<CBigNum>> mintedPubCoins;
+
+    //! Accumulator updates. Contains only changes made by mints in this block
+    //! Maps <denomination, id> to <accumulator value (CBigNum), number of such mints in this block>
+    map<pair<int,int>, pair<CBigNum,int>> accumulatorChanges;
+
+    //! (memory only) Same as accumulatorChanges but for alternative modulus
+    map<pair<int,int>, pair<CBigNum,int>> alternativeAccumulatorChanges;
+
+    //! Values of coin serials spent in this block
+    set<CBigNum> spentSerials;
+
+    //! Public coin values of sigma mints in this block, ordered by serialized value of public coin
+    //! Maps <denomination,id> to vector of public coins
+    std::map<pair<sigma::CoinDenomination, int>, vector<sigma::PublicCoin>> sigmaMintedPubCoins;
+
+    //! Values of sigma coin serials spent in this block
+    sigma::spend_info_container sigmaSpentSerials;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
+        READWRITE(mintedPubCoins);
+        READWRITE(accumulatorChanges);
+        READWRITE(spentSerials);
+        READWRITE(sigmaMintedPubCoins);
+        READWRITE(sigmaSpentSerials);
+    }
+
+    void SetNull()
+    {
+        mintedPubCoins.clear();
+        accumulatorChanges.clear();
+        alternativeAccumulatorChanges.clear();
+        spentSerials.clear();
+        sigmaMintedPubCoins.clear();
+        sigmaSpentSerials.clear();
+    }
+
+    //! True if there is nothing to store on disk
+    bool IsNull() const
+    {
+        return mintedPubCoins.empty() && accumulatorChanges.empty() && spentSerials.empty()
+            && sigmaMintedPubCoins.empty() && sigmaSpentSerials.empty();
+    }
+};
+
+class CBlockIndex;
+
+/**
+ * Source of the block index payloads, implemented by the block tree database. It loads a payload on
+ * the first access to it and keeps track of the recently used ones so that the rest can be released.
+ */
+class CBlockIndexPrivacyDataStore
+{
+public:
+    virtual ~CBlockIndexPrivacyDataStore() {}
+
+    //! Read the payload of the block if it has one and start tracking it
+    virtual void LoadPrivacyData(const CBlockIndex& index, CBlockIndexPrivacyData& data) = 0;
+    //! Mark the payload of the block as recently used
+    virtual void TouchPrivacyData(const CBlockIndex& index) = 0;
+};
+
+extern CBlockIndexPrivacyDataStore *pprivacydatastore;
+
 /** The block chain is a tree shaped structure starting with the
  * genesis block at the root, with each block potentially having multiple
  * candidates to be the next block. A blockindex may have multiple pprev pointing
@@ -222,28 +299,8 @@ public:
     //! (memory only) Sequential id assigned to distinguish order in which blocks are received.
     uint32_t nSequenceId;
 
-    //! Public coin values of mints in this block, ordered by serialized value of public coin
-    //! Maps <denomination,id> to vector of public coins
-    map<pair<int,int>, vector<CBigNum>> mintedPubCoins;
-
-    //! Accumulator updates. Contains only changes made by mints in this block
-    //! Maps <denomination, id> to <accumulator value (CBigNum), number of such mints in this block>
-    map<pair<int,int>, pair<CBigNum,int>> accumulatorChanges;
-
-	//! Same as accumulatorChanges but for alternative modulus
-	map<pair<int,int>, pair<CBigNum,int>> alternativeAccumulatorChanges;
-
-    //! Values of coin serials spent in this block
-	set<CBigNum> spentSerials;
-
-/////////////////////// Sigma index entries. ////////////////////////////////////////////
-
-    //! Public coin values of mints in this block, ordered by serialized value of public coin
-    //! Maps <denomination,id> to vector of public coins
-    std::map<pair<sigma::CoinDenomination, int>, vector<sigma::PublicCoin>> sigmaMintedPubCoins;
-
-    //! Values of coin serials spent in this block
-    sigma::spend_info_container sigmaSpentSerials;
+    //! Zerocoin and sigma payload if it's in memory. Use GetPrivacyData() and PrivacyData() to access it
+    mutable std::shared_ptr<CBlockIndexPrivacyData> privacyData;
 
     void SetNull()
     {
@@ -267,11 +324,7 @@ public:
         nNonce         = 0;
         vchBlockSig.clear();
 
-        mintedPubCoins.clear();
-        sigmaMintedPubCoins.clear();
-        accumulatorChanges.clear();
-        spentSerials.clear();
-        sigmaSpentSerials.clear();
+        privacyData.reset();
         //PoS
         nStakeModifier = uint256();
     }
@@ -457,6 +510,17 @@ public:
         return false;
     }
 
+    //! Zerocoin and sigma payload of the block, read from the block tree database if it's not in memory.
+    //! Blocks without a payload share an empty instance. Requires cs_main
+    const CBlockIndexPrivacyData& GetPrivacyData() const;
+
+    //! Same as GetPrivacyData() but for modification. The entry has to be written to the block tree
+    //! database afterwards, i.e. added to setDirtyBlockIndex
+    CBlockIndexPrivacyData& PrivacyData();
+
+    //! Set BLOCK_HAVE_PRIVACY_DATA according to the payload in memory, called before the entry is written
+    void UpdatePrivacyDataStatus();
+
     //! Build the skiplist pointer for this entry.
     void BuildSkip();
 
@@ -485,6 +549,7 @@ public:
     explicit CDiskBlockIndex(const CBlockIndex* pindex) : CBlockIndex(*pindex) {
         hashPrev = (pprev ? pprev->GetBlockHash() : uint256());
         nDiskBlockVersion = 0;
+        nStatus |= BLOCK_PRIVACY_DATA_EXTERNAL;
     }
 
     ADD_SERIALIZE_METHODS;
@@ -514,15 +579,19 @@ public:
         if(nNonce == 0)
             READWRITE(vchBlockSig); // qtum
 
-        if (!(nType & SER_GETHASH) && nVersion >= ZC_ADVANCED_INDEX_VERSION) {
-            READWRITE(mintedPubCoins);
-		    READWRITE(accumulatorChanges);
-            READWRITE(spentSerials);
-	    }
-
-        if (!(nType & SER_GETHASH) && nHeight >= Params().GetConsensus().nSigmaStartBlock) {
-            READWRITE(sigmaMintedPubCoins);
-            READWRITE(sigmaSpentSerials);
+        // Entries written by older versions keep the zerocoin/sigma payload inline,
+        // see CBlockTreeDB::LoadBlockIndexGuts for their conversion
+        if (!(nType & SER_GETHASH) && !(nStatus & BLOCK_PRIVACY_DATA_EXTERNAL)) {
+            if (nVersion >= ZC_ADVANCED_INDEX_VERSION) {
+                READWRITE(PrivacyData().mintedPubCoins);
+                READWRITE(PrivacyData().accumulatorChanges);
+                READWRITE(PrivacyData().spentSerials);
+            }
+
+            if (nHeight >= Params().GetConsensus().nSigmaStartBlock) {
+                READWRITE(PrivacyData().sigmaMintedPubCoins);
+                READWRITE(PrivacyData().sigmaSpentSerials);
+            }
         }
 
 	    // PoS
@@ -125,9 +125,12 @@ UniValue rebroadcast(Type type, const UniValue& data, const UniValue& auth, bool
     }
 
     CCoinsViewCache &view = *pcoinsTip;
-    const CCoins* existingCoins = view.AccessCoins(hash);
+    bool fHaveChain = false;
+    for (size_t o = 0; !fHaveChain && o < wtx->vout.size(); o++) {
+        const Coin& existingCoin = view.AccessCoin(COutPoint(hash, o));
+        fHaveChain = !existingCoin.IsSpent();
+    }
     bool fHaveMempool = mempool.exists(hash);
-    bool fHaveChain = existingCoins && existingCoins->nHeight < 1000000000;
     if (!fHaveMempool && !fHaveChain) {
         // push to local node and sync with wallets
         CValidationState state;
@@ -149,12 +152,12 @@ UniValue rebroadcast(Type type, const UniValue& data, const UniValue& auth, bool
 }
 
 static const CAPICommand commands[] =
-{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk
-  //  --------------------- ------------       ----------------          -------- --------------   --------
-    { "blockchain",         "blockchain",      &blockchain,              true,      false,           false  },
-    { "blockchain",         "block",           &block,                   true,      false,           false  },
-    { "blockchain",         "rebroadcast",     &rebroadcast,             true,      false,           false  },
-    { "blockchain",         "transaction",     &transaction,             true,      false,           false  }
+{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk    concurrency
+  //  --------------------- ------------       ----------------          -------- --------------   --------   -----------
+    { "blockchain",         "blockchain",      &blockchain,              true,      false,           false,      API_PARALLEL },
+    { "blockchain",         "block",           &block,                   true,      false,           false,      API_PARALLEL },
+    { "blockchain",         "rebroadcast",     &rebroadcast,             true,      false,           false,      API_SERIAL   },
+    { "blockchain",         "transaction",     &transaction,             true,      false,           false,      API_PARALLEL }
     
 };
 void RegisterBlockchainAPICommands(CAPITable &tableAPI)
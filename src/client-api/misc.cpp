@@ -17,6 +17,7 @@
 #include "shroudnodeman.h"
 #include "activeshroudnode.h"
 #include <zmqserver/zmqabstract.h>
+#include <zmqserver/zmqinterface.h>
 #include "univalue.h"
 
 #include <boost/algorithm/string/split.hpp>
@@ -180,9 +181,31 @@ UniValue apistatus(Type type, const UniValue& data, const UniValue& auth, bool f
 #endif
     obj.push_back(Pair("modules",       modules));
 
+    CZMQPublisherStats publisherStats;
+    if (GetZMQPublisherStats(publisherStats)) {
+        UniValue publisher(UniValue::VOBJ);
+        publisher.push_back(Pair("queued",     publisherStats.nQueued));
+        publisher.push_back(Pair("coalesced",  publisherStats.nCoalesced));
+        publisher.push_back(Pair("dropped",    publisherStats.nDropped));
+        publisher.push_back(Pair("published",  publisherStats.nPublished));
+        publisher.push_back(Pair("queueSize",  (uint64_t)publisherStats.nQueueSize));
+        publisher.push_back(Pair("lastLagMs",  publisherStats.nLastLag / 1000));
+        publisher.push_back(Pair("maxLagMs",   publisherStats.nMaxLag / 1000));
+        obj.push_back(Pair("publisher", publisher));
+    }
+
     return obj;
 }
 
+UniValue apilatency(Type type, const UniValue& data, const UniValue& auth, bool fHelp)
+{
+    UniValue ret(UniValue::VOBJ);
+    std::map<std::string, CAPILatencyHistogram> histograms = tableAPI.getLatencyHistograms();
+    for (std::map<std::string, CAPILatencyHistogram>::const_iterator it = histograms.begin(); it != histograms.end(); ++it)
+        ret.push_back(Pair(it->first, it->second.ToJSON()));
+    return ret;
+}
+
 UniValue backup(Type type, const UniValue& data, const UniValue& auth, bool fHelp)
 {
     string directory = find_value(data, "directory").get_str();
@@ -275,12 +298,13 @@ UniValue rpc(Type type, const UniValue& data, const UniValue& auth, bool fHelp)
 }
 
 static const CAPICommand commands[] =
-{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk
-  //  --------------------- ------------       ----------------          -------- --------------   --------
-    { "misc",               "apiStatus",       &apistatus,               false,     false,           true   },
-    { "misc",               "backup",          &backup,                  true,      false,           false  },
-    { "misc",               "rpc",             &rpc,                     true,      false,           false  },
-    { "misc",               "stop",            &stop,                    true,      false,           false  }
+{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk    concurrency
+  //  --------------------- ------------       ----------------          -------- --------------   --------   -----------
+    { "misc",               "apiStatus",       &apistatus,               false,     false,           true,       API_PARALLEL },
+    { "misc",               "apiLatency",      &apilatency,              true,      false,           true,       API_PARALLEL },
+    { "misc",               "backup",          &backup,                  true,      false,           false,      API_SERIAL   },
+    { "misc",               "rpc",             &rpc,                     true,      false,           false,      API_SERIAL   },
+    { "misc",               "stop",            &stop,                    true,      false,           false,      API_SERIAL   }
 };
 
 void RegisterMiscAPICommands(CAPITable &tableAPI)
@@ -521,12 +521,12 @@ UniValue paymentrequest(Type type, const UniValue& data, const UniValue& auth, b
 
 
 static const CAPICommand commands[] =
-{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk
-  //  --------------------- ------------       ----------------          -------- --------------   --------
-    { "send",            "paymentRequest",  &paymentrequest,          true,      false,           false  },
-    { "send",            "txFee",           &txfee,                   true,      false,           false  },
-    { "send",            "updateLabels",    &updatelabels,            true,      false,           false  },
-    { "send",            "sendZcoin",       &sendzcoin,               true,      true,            false  }
+{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk    concurrency
+  //  --------------------- ------------       ----------------          -------- --------------   --------   -----------
+    { "send",            "paymentRequest",  &paymentrequest,          true,      false,           false,      API_SERIAL   },
+    { "send",            "txFee",           &txfee,                   true,      false,           false,      API_SERIAL   },
+    { "send",            "updateLabels",    &updatelabels,            true,      false,           false,      API_SERIAL   },
+    { "send",            "sendZcoin",       &sendzcoin,               true,      true,            false,      API_SERIAL   }
 
 };
 
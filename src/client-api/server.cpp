@@ -11,6 +11,8 @@ static bool fAPIRunning = false;
 static bool fAPIInWarmup = true;
 static std::string apiWarmupStatus("API server started");
 static CCriticalSection cs_apiWarmup;
+/** Held while an API_SERIAL command runs */
+static CCriticalSection cs_apiSerial;
 
 static struct CAPISignals
 {
@@ -63,6 +65,36 @@ bool APIIsInWarmup()
     return fAPIInWarmup;
 }
 
+CAPILatencyHistogram::CAPILatencyHistogram() : nCount(0), nTotal(0), nMax(0)
+{
+    std::fill(buckets, buckets + BUCKETS, 0);
+}
+
+void CAPILatencyHistogram::Add(int64_t nMicros)
+{
+    int bucket = 0;
+    for (int64_t nMillis = nMicros / 1000; nMillis > 0 && bucket < BUCKETS - 1; nMillis >>= 1)
+        bucket++;
+    buckets[bucket]++;
+    nCount++;
+    nTotal += nMicros;
+    nMax = std::max(nMax, nMicros);
+}
+
+UniValue CAPILatencyHistogram::ToJSON() const
+{
+    UniValue ret(UniValue::VOBJ);
+    UniValue histogram(UniValue::VARR);
+    for (int i = 0; i < BUCKETS; i++)
+        histogram.push_back(buckets[i]);
+
+    ret.push_back(Pair("count", nCount));
+    ret.push_back(Pair("averageMs", nCount ? (double)nTotal / nCount / 1000 : 0.0));
+    ret.push_back(Pair("maxMs", (double)nMax / 1000));
+    ret.push_back(Pair("histogram", histogram));
+    return ret;
+}
+
 CAPITable::CAPITable(){}
 
 const CAPICommand *CAPITable::operator[](const std::string &name) const
@@ -73,6 +105,12 @@ const CAPICommand *CAPITable::operator[](const std::string &name) const
     return (*it).second;
 }
 
+std::map<std::string, CAPILatencyHistogram> CAPITable::getLatencyHistograms() const
+{
+    LOCK(cs_latency);
+    return mapLatency;
+}
+
 bool CAPITable::appendCommand(const std::string& name, const CAPICommand* pcmd)
 {
     if (IsAPIRunning())
@@ -161,10 +199,41 @@ void APIJSONRequest::parse(const UniValue& valRequest)
 
 }
 
+static UniValue ExecuteCommand(const CAPICommand *pcmd, const APIJSONRequest& request)
+{
+    const CAPICommand *walletlock = tableAPI["lockWallet"];
+    try
+    {
+        // If this method requires passphrase, lock and unlock the wallet accordingly
+        if(pcmd->authPassphrase && (pwalletMain && pwalletMain->IsCrypted())){
+            if(request.auth.isNull()){
+                throw JSONAPIError(API_INVALID_PARAMETER, "Missing auth field");
+            }
+
+            // execute wallet unlock, call method, relock following call. 
+            const CAPICommand *walletunlock = tableAPI["unlockWallet"];
+            UniValue lock = walletunlock->actor(request.type, NullUniValue, request.auth, false);
+            if(lock.isNull()){
+                throw JSONAPIError(API_MISC_ERROR, "wallet could not be unlocked.");
+            }
+            UniValue result = pcmd->actor(request.type, request.data, NullUniValue, false);
+            walletlock->actor(request.type, NullUniValue, NullUniValue, false);
+            return result;
+
+        }
+        return pcmd->actor(request.type, request.data, request.auth, false);
+    }
+    catch (const std::exception& e)
+    {
+        //walletlock->actor(request.type, NullUniValue, NullUniValue, false); //ensure to relock should an error occur
+        throw JSONAPIError(API_MISC_ERROR, e.what());
+    }
+}
+
 UniValue CAPITable::execute(APIJSONRequest request, const bool authPort) const
 {
     if(request.collection!="apiStatus")
-        LogPrintf("executing method %s\n",  request.collection);
+        LogPrint("api", "executing method %s\n",  request.collection);
     
     const CAPICommand *pcmd = tableAPI[request.collection];
     if (!pcmd){
@@ -188,36 +257,34 @@ UniValue CAPITable::execute(APIJSONRequest request, const bool authPort) const
         throw JSONAPIError(API_NOT_AUTHENTICATED, "Not authenticated for this method");
     }
 
-    const CAPICommand *walletlock = tableAPI["lockWallet"];
     g_apiSignals.PreCommand (*pcmd);
+
+    UniValue result;
+    int64_t nTimeStart = GetTimeMicros();
     try
     {
-        // If this method requires passphrase, lock and unlock the wallet accordingly
-        if(pcmd->authPassphrase && (pwalletMain && pwalletMain->IsCrypted())){
-            if(request.auth.isNull()){
-                throw JSONAPIError(API_INVALID_PARAMETER, "Missing auth field");
-            }
-
-            // execute wallet unlock, call method, relock following call. 
-            const CAPICommand *walletunlock = tableAPI["unlockWallet"];
-            UniValue lock = walletunlock->actor(request.type, NullUniValue, request.auth, false);
-            if(lock.isNull()){
-                throw JSONAPIError(API_MISC_ERROR, "wallet could not be unlocked.");
-            }
-            UniValue result = pcmd->actor(request.type, request.data, NullUniValue, false);
-            walletlock->actor(request.type, NullUniValue, NullUniValue, false);
-            return result;
-
+        if (pcmd->concurrency == API_SERIAL) {
+            LOCK(cs_apiSerial);
+            result = ExecuteCommand(pcmd, request);
+        }
+        else {
+            result = ExecuteCommand(pcmd, request);
         }
-        return pcmd->actor(request.type, request.data, request.auth, false);
     }
-    catch (const std::exception& e)
+    catch (...)
     {
-        //walletlock->actor(request.type, NullUniValue, NullUniValue, false); //ensure to relock should an error occur
-        throw JSONAPIError(API_MISC_ERROR, e.what());
+        LOCK(cs_latency);
+        mapLatency[pcmd->collection].Add(GetTimeMicros() - nTimeStart);
+        throw;
+    }
+
+    {
+        LOCK(cs_latency);
+        mapLatency[pcmd->collection].Add(GetTimeMicros() - nTimeStart);
     }
 
     g_apiSignals.PostCommand(*pcmd);
+    return result;
 }
 
 CAPITable tableAPI;
@@ -1,4 +1,9 @@
 #include "univalue.h"
+#include "sync.h"
+
+#include <map>
+#include <string>
+#include <vector>
 
 using namespace std;
 
@@ -42,6 +47,12 @@ public:
     void parseType(std::string typeRequest);
 };
 
+/** Whether a command may run alongside other API calls */
+enum APIConcurrency {
+    API_PARALLEL,   // only reads the wallet or node state
+    API_SERIAL      // changes the wallet or node state, runs one at a time
+};
+
 typedef UniValue(*apifn_type)(Type type, const UniValue& data, const UniValue& auth, bool fHelp);
 
 class CAPICommand
@@ -53,12 +64,33 @@ public:
     bool authPort;          // command can only be called through authenticated port
     bool authPassphrase;    // command requires unlocking before being ran.
     bool warmupOk;          // command can be executed during program warmup.
+    APIConcurrency concurrency;
+};
+
+/** Call count and latency distribution of an API method */
+class CAPILatencyHistogram
+{
+public:
+    //! Bucket i counts the calls which took less than 2^i milliseconds, the last one all slower calls
+    static const int BUCKETS = 16;
+
+    uint64_t nCount;
+    int64_t nTotal;     //!< microseconds
+    int64_t nMax;       //!< microseconds
+    uint64_t buckets[BUCKETS];
+
+    CAPILatencyHistogram();
+    void Add(int64_t nMicros);
+    UniValue ToJSON() const;
 };
 
 class CAPITable
 {
 private:
     std::map<std::string, const CAPICommand*> mapCommands;
+
+    mutable CCriticalSection cs_latency;
+    mutable std::map<std::string, CAPILatencyHistogram> mapLatency;
 public:
     CAPITable();
     const CAPICommand* operator[](const std::string& name) const;
@@ -79,6 +111,9 @@ public:
     */
     std::vector<std::string> listCommands() const; // TODO
 
+    /** Returns the latency histograms of the methods called so far */
+    std::map<std::string, CAPILatencyHistogram> getLatencyHistograms() const;
+
 
     /**
      * Appends a CAPICommand to the dispatch table.
@@ -253,10 +253,10 @@ UniValue setting(Type type, const UniValue& data, const UniValue& auth, bool fHe
 }
 
 static const CAPICommand commands[] =
-{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk
-  //  --------------------- ------------       ----------------          --------   --------------   --------
-    { "wallet",             "setting",         &setting,                 true,      false,           false  },
-    { "wallet",             "readSettings",    &readsettings,            true,      false,           false  }
+{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk    concurrency
+  //  --------------------- ------------       ----------------          --------   --------------   --------   -----------
+    { "wallet",             "setting",         &setting,                 true,      false,           false,      API_SERIAL   },
+    { "wallet",             "readSettings",    &readsettings,            true,      false,           false,      API_PARALLEL }
 };
 
 void RegisterSettingsAPICommands(CAPITable &tableAPI)
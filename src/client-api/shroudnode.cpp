@@ -258,12 +258,12 @@ UniValue shroudnodeupdate(Type type, const UniValue& data, const UniValue& auth,
 }
 
 static const CAPICommand commands[] =
-{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk
-  //  --------------------- ------------       ----------------          -------- --------------   --------
-    { "shroudnode",              "shroudnodeControl",    &shroudnodecontrol,            true,      true,            false  },
-    { "shroudnode",              "shroudnodeKey",        &shroudnodekey,                true,      false,           false  },
-    { "shroudnode",              "shroudnodeList",       &shroudnodelist,               true,      false,           false  },
-    { "shroudnode",              "shroudnodeUpdate",     &shroudnodeupdate,             true,      false,           false  }
+{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk    concurrency
+  //  --------------------- ------------       ----------------          -------- --------------   --------   -----------
+    { "shroudnode",              "shroudnodeControl",    &shroudnodecontrol,            true,      true,            false,      API_SERIAL   },
+    { "shroudnode",              "shroudnodeKey",        &shroudnodekey,                true,      false,           false,      API_PARALLEL },
+    { "shroudnode",              "shroudnodeList",       &shroudnodelist,               true,      false,           false,      API_PARALLEL },
+    { "shroudnode",              "shroudnodeUpdate",     &shroudnodeupdate,             true,      false,           false,      API_PARALLEL }
 };
 void RegisterShroudnodeAPICommands(CAPITable &tableAPI)
 {
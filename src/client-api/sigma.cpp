@@ -141,7 +141,8 @@ bool createSigmaSpendAPITransaction(CWalletTx& wtx,
     if (!sigma::IsSigmaAllowed()) {
         throw JSONAPIError(API_WALLET_ERROR, "Sigma is not activated yet");
     }
-    LOCK2(cs_main, pwalletMain->cs_wallet);
+    // CreateSigmaSpendTransaction takes cs_main and cs_wallet itself, holding them here would keep them locked
+    // while the spend proofs are created
     UniValue outputs(UniValue::VARR);
     outputs = find_value(data, "outputs").get_array();
     std::string label = find_value(data, "label").get_str();
@@ -399,14 +400,14 @@ UniValue listmints(Type type, const UniValue& data, const UniValue& auth, bool f
 }
 
 static const CAPICommand commands[] =
-{ //  category              collection            actor (function)          authPort   authPassphrase   warmupOk
-  //  --------------------- ------------          ----------------          --------   --------------   --------
-    { "sigma",              "mint",               &mint,                    true,      true,            false  },
-    { "sigma",              "sendPrivate",        &sendprivate,             true,      true,            false  },
-    { "sigma",              "listMints",          &listmints,               true,      true,            false  },
-    { "sigma",              "mintTxFee",          &minttxfee,               true,      false,            false },
-    { "sigma",              "privateTxFee",       &privatetxfee,            true,      false,           false  },
-    { "sigma",              "mintStatus",         &mintstatus,              true,      false,           false  }
+{ //  category              collection            actor (function)          authPort   authPassphrase   warmupOk    concurrency
+  //  --------------------- ------------          ----------------          --------   --------------   --------   -----------
+    { "sigma",              "mint",               &mint,                    true,      true,            false,      API_SERIAL   },
+    { "sigma",              "sendPrivate",        &sendprivate,             true,      true,            false,      API_SERIAL   },
+    { "sigma",              "listMints",          &listmints,               true,      true,            false,      API_SERIAL   },
+    { "sigma",              "mintTxFee",          &minttxfee,               true,      false,            false,      API_SERIAL   },
+    { "sigma",              "privateTxFee",       &privatetxfee,            true,      false,           false,      API_SERIAL   },
+    { "sigma",              "mintStatus",         &mintstatus,              true,      false,           false,      API_PARALLEL }
 };
 void RegisterSigmaAPICommands(CAPITable &tableAPI)
 {
@@ -20,20 +20,8 @@ using namespace boost::chrono;
 using namespace std;
 
 void GetSigmaBalance(CAmount& sigmaAll, CAmount& sigmaConfirmed) {
-    auto coins = zwalletMain->GetTracker().ListMints(true, false, false);
-    for (const auto& coin : coins) {
-        // ignore spent coin
-        if (coin.isUsed)
-            continue;
-
-        int64_t coinValue;
-        DenominationToInteger(coin.denom, coinValue);
-
-        sigmaAll += coinValue;
-        if (coin.nHeight > 0
-            && coin.nHeight + (ZC_MINT_CONFIRMATIONS-1) <= chainActive.Height())
-            sigmaConfirmed += coinValue;
-    }
+    LOCK2(cs_main, pwalletMain->cs_wallet);
+    zwalletMain->GetTracker().GetBalance(sigmaAll, sigmaConfirmed, chainActive.Height());
 }
 
 UniValue getTxMetadataEntry(string txid, string address, CAmount amount){
@@ -418,9 +406,9 @@ UniValue StateSinceBlock(UniValue& ret, std::string block){
 
     UniValue transactions(UniValue::VOBJ);
 
-    for (map<uint256, CWalletTx>::iterator it = pwalletMain->mapWallet.begin(); it != pwalletMain->mapWallet.end(); it++)
+    for (map<uint256, CWalletTx>::const_iterator it = pwalletMain->mapWallet.begin(); it != pwalletMain->mapWallet.end(); it++)
     {
-        CWalletTx tx = (*it).second;
+        const CWalletTx& tx = (*it).second;
 
         if (depth == -1 || tx.GetDepthInMainChain() <= depth)
             ListAPITransactions(tx, transactions, filter);
@@ -431,6 +419,61 @@ UniValue StateSinceBlock(UniValue& ret, std::string block){
     return ret;
 }
 
+static std::string FormatStateCursor(uint64_t nEpoch, uint64_t nSequence)
+{
+    return strprintf("%016x:%d", nEpoch, nSequence);
+}
+
+static bool ParseStateCursor(const std::string& cursor, uint64_t& nEpoch, uint64_t& nSequence)
+{
+    size_t pos = cursor.find(':');
+    if (pos != 16 || !IsHex(cursor.substr(0, pos)))
+        return false;
+
+    int64_t nSequenceSigned;
+    if (!ParseInt64(cursor.substr(pos + 1), &nSequenceSigned) || nSequenceSigned < 0)
+        return false;
+
+    nEpoch = strtoull(cursor.substr(0, pos).c_str(), NULL, 16);
+    nSequence = nSequenceSigned;
+    return true;
+}
+
+UniValue StateSinceSequence(UniValue& ret, uint64_t nSequence, size_t nLimit){
+
+    LOCK2(cs_main, pwalletMain->cs_wallet);
+
+    isminefilter filter = ISMINE_SPENDABLE;
+
+    // Fetch one more change than requested to tell whether there is another chunk
+    std::vector<std::pair<uint64_t, uint256> > changes;
+    pwalletMain->ListTxChangesSince(nSequence, nLimit < std::numeric_limits<size_t>::max() ? nLimit + 1 : nLimit, changes);
+    bool fMore = changes.size() > nLimit;
+    if (fMore)
+        changes.resize(nLimit);
+
+    UniValue transactions(UniValue::VOBJ);
+    UniValue removed(UniValue::VARR);
+
+    BOOST_FOREACH(const PAIRTYPE(uint64_t, uint256)& change, changes)
+    {
+        map<uint256, CWalletTx>::const_iterator it = pwalletMain->mapWallet.find(change.second);
+        if (it != pwalletMain->mapWallet.end())
+            ListAPITransactions(it->second, transactions, filter);
+        else
+            removed.push_back(change.second.GetHex());
+    }
+
+    uint64_t nLastSequence = changes.empty() ? nSequence : changes.back().first;
+
+    ret.push_back(Pair("addresses", transactions));
+    ret.push_back(Pair("removed", removed));
+    ret.push_back(Pair("cursor", FormatStateCursor(pwalletMain->nTxSequenceEpoch, nLastSequence)));
+    ret.push_back(Pair("more", fMore));
+
+    return ret;
+}
+
 UniValue StateBlock(UniValue& ret, std::string blockhash){
 
     LOCK2(cs_main, pwalletMain->cs_wallet);
@@ -475,9 +518,34 @@ UniValue statewallet(Type type, const UniValue& data, const UniValue& auth, bool
 
     UniValue ret(UniValue::VOBJ);
 
-    std::string genesisBlock = chainActive[0]->GetBlockHash().ToString();
+    // Without cursor and limit the whole wallet is returned in one reply
+    uint64_t nSequence = 0;
+    size_t nLimit = std::numeric_limits<size_t>::max();
+    bool fReset = false;
+
+    UniValue cursor = find_value(data, "cursor");
+    if (!cursor.isNull()) {
+        uint64_t nEpoch;
+        if (!cursor.isStr() || !ParseStateCursor(cursor.get_str(), nEpoch, nSequence))
+            throw JSONAPIError(API_INVALID_PARAMETER, "Invalid cursor");
+
+        // Cursor from before a restart of the wallet, start over
+        LOCK(pwalletMain->cs_wallet);
+        if (nEpoch != pwalletMain->nTxSequenceEpoch) {
+            nSequence = 0;
+            fReset = true;
+        }
+    }
+
+    UniValue limit = find_value(data, "limit");
+    if (!limit.isNull()) {
+        if (!limit.isNum() || limit.get_int() <= 0)
+            throw JSONAPIError(API_INVALID_PARAMETER, "limit must be a positive number");
+        nLimit = limit.get_int();
+    }
 
-    StateSinceBlock(ret, genesisBlock);
+    StateSinceSequence(ret, nSequence, nLimit);
+    ret.push_back(Pair("reset", fReset));
 
     return ret;
 }
@@ -672,13 +740,13 @@ UniValue balance(Type type, const UniValue& data, const UniValue& auth, bool fHe
 }
 
 static const CAPICommand commands[] =
-{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk
-  //  --------------------- ------------       ----------------          -------- --------------   --------
-    { "wallet",             "lockWallet",      &lockwallet,              true,      false,           false  },
-    { "wallet",             "unlockWallet",    &unlockwallet,            true,      false,           false  },
-    { "wallet",             "stateWallet",     &statewallet,             true,      false,           false  },
-    { "wallet",             "setPassphrase",   &setpassphrase,           true,      false,           false  },
-    { "wallet",             "balance",         &balance,                 true,      false,           false  }
+{ //  category              collection         actor (function)          authPort   authPassphrase   warmupOk    concurrency
+  //  --------------------- ------------       ----------------          -------- --------------   --------   -----------
+    { "wallet",             "lockWallet",      &lockwallet,              true,      false,           false,      API_SERIAL   },
+    { "wallet",             "unlockWallet",    &unlockwallet,            true,      false,           false,      API_SERIAL   },
+    { "wallet",             "stateWallet",     &statewallet,             true,      false,           false,      API_PARALLEL },
+    { "wallet",             "setPassphrase",   &setpassphrase,           true,      false,           false,      API_SERIAL   },
+    { "wallet",             "balance",         &balance,                 true,      false,           false,      API_PARALLEL }
     
 };
 void RegisterWalletAPICommands(CAPITable &tableAPI)
@@ -10,4 +10,6 @@
 void ListAPITransactions(const CWalletTx& wtx, UniValue& ret, const isminefilter& filter);
 
 UniValue StateSinceBlock(UniValue& ret, std::string block);
+/** Wallet transactions changed after nSequence, at most nLimit of them, with the cursor to continue from */
+UniValue StateSinceSequence(UniValue& ret, uint64_t nSequence, size_t nLimit);
 UniValue StateBlock(UniValue& ret, std::string blockhash);
\ No newline at end of file
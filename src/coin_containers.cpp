@@ -1,29 +1,33 @@
 #include "coin_containers.h"
-#include "crypto/sha256.h"
+#include "hash.h"
+#include "random.h"
 
-#include <vector>
+#include <limits>
 
 namespace sigma {
 
+CScalarHash::CScalarHash()
+    : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {
+}
+
 std::size_t CScalarHash::operator ()(const Scalar& bn) const noexcept {
-    vector<unsigned char> bnData(bn.memoryRequired());
-    bn.serialize(&bnData[0]);
+    uint256 data;
+    bn.serialize(data.begin());
+    return SipHashUint256(k0, k1, data);
+}
 
-    unsigned char hash[CSHA256::OUTPUT_SIZE];
-    CSHA256().Write(&bnData[0], bnData.size()).Finalize(hash);
+CGroupElementHash::CGroupElementHash()
+    : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {
+}
 
-    // take the first bytes of "hash".
-    std::size_t result;
-    std::memcpy(&result, hash, sizeof(std::size_t));
-    return result;
+std::size_t CGroupElementHash::operator ()(const GroupElement& element) const noexcept {
+    unsigned char coord[GroupElement::affine_size];
+    element.get_affine_coordinates(coord);
+    return CSipHasher(k0, k1).Write(coord, sizeof(coord)).Finalize();
 }
 
 std::size_t CPublicCoinHash::operator ()(const sigma::PublicCoin& coin) const noexcept {
-    uint256 hash = coin.getValueHash();
-
-    std::size_t result;
-    std::memcpy(&result, hash.begin(), sizeof(std::size_t));
-    return result;
+    return hasher(coin.getValue());
 }
 
 
@@ -8,14 +8,30 @@
 
 namespace sigma {
 
-// Custom hash for Scalar values.
+// Salted SipHash of the serialized scalar, the salt is random for every container.
 struct CScalarHash {
+    CScalarHash();
     std::size_t operator()(const secp_primitives::Scalar& bn) const noexcept;
+
+private:
+    uint64_t k0, k1;
 };
 
-// Custom hash for the public coin.
+// Salted SipHash of the affine coordinates of a group element.
+struct CGroupElementHash {
+    CGroupElementHash();
+    std::size_t operator()(const secp_primitives::GroupElement& element) const noexcept;
+
+private:
+    uint64_t k0, k1;
+};
+
+// Custom hash for the public coin, hashes the coin value only like PublicCoin::operator==.
 struct CPublicCoinHash {
     std::size_t operator()(const sigma::PublicCoin& coin) const noexcept;
+
+private:
+    CGroupElementHash hasher;
 };
 
 struct CMintedCoinInfo {
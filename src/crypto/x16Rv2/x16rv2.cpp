@@ -0,0 +1,201 @@
+// Copyright (c) 2020 The ShroudX developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "x16rv2.h"
+
+#include "sph_blake.h"
+#include "sph_bmw.h"
+#include "sph_groestl.h"
+#include "sph_jh.h"
+#include "sph_keccak.h"
+#include "sph_skein.h"
+#include "sph_luffa.h"
+#include "sph_cubehash.h"
+#include "sph_shavite.h"
+#include "sph_simd.h"
+#include "sph_echo.h"
+#include "sph_hamsi.h"
+#include "sph_fugue.h"
+#include "sph_shabal.h"
+#include "sph_whirlpool.h"
+#include "sph_sha2.h"
+#include "sph_tiger.h"
+
+#include <string.h>
+
+#include <utility>
+#include <vector>
+
+namespace {
+
+/** Contexts of all the algorithms right after their init functions */
+struct InitialContexts {
+    sph_blake512_context     blake;
+    sph_bmw512_context       bmw;
+    sph_groestl512_context   groestl;
+    sph_jh512_context        jh;
+    sph_keccak512_context    keccak;
+    sph_skein512_context     skein;
+    sph_luffa512_context     luffa;
+    sph_cubehash512_context  cubehash;
+    sph_shavite512_context   shavite;
+    sph_simd512_context      simd;
+    sph_echo512_context      echo;
+    sph_hamsi512_context     hamsi;
+    sph_fugue512_context     fugue;
+    sph_shabal512_context    shabal;
+    sph_whirlpool_context    whirlpool;
+    sph_sha512_context       sha512;
+    sph_tiger_context        tiger;
+
+    InitialContexts() {
+        sph_blake512_init(&blake);
+        sph_bmw512_init(&bmw);
+        sph_groestl512_init(&groestl);
+        sph_jh512_init(&jh);
+        sph_keccak512_init(&keccak);
+        sph_skein512_init(&skein);
+        sph_luffa512_init(&luffa);
+        sph_cubehash512_init(&cubehash);
+        sph_shavite512_init(&shavite);
+        sph_simd512_init(&simd);
+        sph_echo512_init(&echo);
+        sph_hamsi512_init(&hamsi);
+        sph_fugue512_init(&fugue);
+        sph_shabal512_init(&shabal);
+        sph_whirlpool_init(&whirlpool);
+        sph_sha512_init(&sha512);
+        sph_tiger_init(&tiger);
+    }
+};
+
+/** Room for any one of the contexts */
+union AnyContext {
+    sph_blake512_context     blake;
+    sph_bmw512_context       bmw;
+    sph_groestl512_context   groestl;
+    sph_jh512_context        jh;
+    sph_keccak512_context    keccak;
+    sph_skein512_context     skein;
+    sph_luffa512_context     luffa;
+    sph_cubehash512_context  cubehash;
+    sph_shavite512_context   shavite;
+    sph_simd512_context      simd;
+    sph_echo512_context      echo;
+    sph_hamsi512_context     hamsi;
+    sph_fugue512_context     fugue;
+    sph_shabal512_context    shabal;
+    sph_whirlpool_context    whirlpool;
+    sph_sha512_context       sha512;
+    sph_tiger_context        tiger;
+};
+
+/** One sph hash function and the context it starts from */
+struct Algorithm {
+    const void *initial;
+    size_t contextSize;
+    void (*update)(void *cc, const void *data, size_t len);
+    void (*close)(void *cc, void *dst);
+
+    // Hashes in into out, out must have room for 64 bytes
+    void Hash(const void *in, size_t len, unsigned char *out) const {
+        AnyContext context;
+        memcpy(&context, initial, contextSize);
+        update(&context, in, len);
+        close(&context, out);
+    }
+};
+
+template<typename Context>
+Algorithm MakeAlgorithm(const Context &initial, void (*update)(void *, const void *, size_t), void (*close)(void *, void *)) {
+    Algorithm algorithm = {&initial, sizeof(Context), update, close};
+    return algorithm;
+}
+
+/**
+ * The algorithms of a round. Rounds 4, 6 and 15 (keccak, luffa and sha512) hash the output of tiger instead of the
+ * input of the round
+ */
+struct Round {
+    bool fTiger;
+    Algorithm algorithm;
+};
+
+struct Rounds {
+    InitialContexts contexts;
+    Algorithm tiger;
+    Round rounds[16];
+
+    Rounds() {
+        tiger = MakeAlgorithm(contexts.tiger, sph_tiger, sph_tiger_close);
+        rounds[0] = {false, MakeAlgorithm(contexts.blake, sph_blake512, sph_blake512_close)};
+        rounds[1] = {false, MakeAlgorithm(contexts.bmw, sph_bmw512, sph_bmw512_close)};
+        rounds[2] = {false, MakeAlgorithm(contexts.groestl, sph_groestl512, sph_groestl512_close)};
+        rounds[3] = {false, MakeAlgorithm(contexts.jh, sph_jh512, sph_jh512_close)};
+        rounds[4] = {true, MakeAlgorithm(contexts.keccak, sph_keccak512, sph_keccak512_close)};
+        rounds[5] = {false, MakeAlgorithm(contexts.skein, sph_skein512, sph_skein512_close)};
+        rounds[6] = {true, MakeAlgorithm(contexts.luffa, sph_luffa512, sph_luffa512_close)};
+        rounds[7] = {false, MakeAlgorithm(contexts.cubehash, sph_cubehash512, sph_cubehash512_close)};
+        rounds[8] = {false, MakeAlgorithm(contexts.shavite, sph_shavite512, sph_shavite512_close)};
+        rounds[9] = {false, MakeAlgorithm(contexts.simd, sph_simd512, sph_simd512_close)};
+        rounds[10] = {false, MakeAlgorithm(contexts.echo, sph_echo512, sph_echo512_close)};
+        rounds[11] = {false, MakeAlgorithm(contexts.hamsi, sph_hamsi512, sph_hamsi512_close)};
+        rounds[12] = {false, MakeAlgorithm(contexts.fugue, sph_fugue512, sph_fugue512_close)};
+        rounds[13] = {false, MakeAlgorithm(contexts.shabal, sph_shabal512, sph_shabal512_close)};
+        rounds[14] = {false, MakeAlgorithm(contexts.whirlpool, sph_whirlpool, sph_whirlpool_close)};
+        rounds[15] = {true, MakeAlgorithm(contexts.sha512, sph_sha512, sph_sha512_close)};
+    }
+
+    // Runs round number selection on in, out must have room for 64 bytes
+    void Hash(unsigned char selection, const void *in, size_t len, unsigned char *out) const {
+        const Round &round = rounds[selection & 0x0f];
+        if (!round.fTiger) {
+            round.algorithm.Hash(in, len, out);
+            return;
+        }
+
+        // The 24 byte output of tiger is padded with zeroes to 64 bytes
+        unsigned char tigerHash[64] = {0};
+        tiger.Hash(in, len, tigerHash);
+        round.algorithm.Hash(tigerHash, 64, out);
+    }
+};
+
+const Rounds &GetRounds() {
+    static const Rounds rounds;
+    return rounds;
+}
+
+const unsigned char blank[1] = {0};
+
+} // namespace
+
+void X16RV2(const unsigned char selection[16], const void *data, size_t len, unsigned char hash[X16RV2_OUTPUT_SIZE]) {
+    const Rounds &rounds = GetRounds();
+
+    unsigned char buffers[2][64];
+    rounds.Hash(selection[0], len == 0 ? blank : data, len, buffers[0]);
+    for (int i = 1; i < 16; i++)
+        rounds.Hash(selection[i], buffers[(i - 1) & 1], 64, buffers[i & 1]);
+
+    memcpy(hash, buffers[1], X16RV2_OUTPUT_SIZE);
+}
+
+void X16RV2Lanes(const unsigned char selection[16], const void *const *data, size_t len, size_t nLanes, unsigned char *hashes) {
+    const Rounds &rounds = GetRounds();
+
+    std::vector<unsigned char> buffers(2 * 64 * nLanes);
+    unsigned char *in = &buffers[0], *out = &buffers[64 * nLanes];
+    for (size_t lane = 0; lane < nLanes; lane++)
+        rounds.Hash(selection[0], len == 0 ? blank : data[lane], len, out + 64 * lane);
+
+    for (int i = 1; i < 16; i++) {
+        std::swap(in, out);
+        for (size_t lane = 0; lane < nLanes; lane++)
+            rounds.Hash(selection[i], in + 64 * lane, 64, out + 64 * lane);
+    }
+
+    for (size_t lane = 0; lane < nLanes; lane++)
+        memcpy(hashes + X16RV2_OUTPUT_SIZE * lane, out + 64 * lane, X16RV2_OUTPUT_SIZE);
+}
@@ -0,0 +1,26 @@
+// Copyright (c) 2020 The ShroudX developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef X16RV2_H
+#define X16RV2_H
+
+#include <stddef.h>
+
+/** Size of an X16Rv2 hash, the first half of the output of the last algorithm */
+static const size_t X16RV2_OUTPUT_SIZE = 32;
+
+/**
+ * X16Rv2 hash of data. selection[i] is the algorithm of round i, a number from 0 to 15. The contexts of the
+ * algorithms are initialized once per process and copied for every hash
+ */
+void X16RV2(const unsigned char selection[16], const void *data, size_t len, unsigned char hash[X16RV2_OUTPUT_SIZE]);
+
+/**
+ * X16Rv2 hashes of nLanes inputs of len bytes each with the same selection of algorithms, the hash of data[i] goes
+ * to hashes + i * X16RV2_OUTPUT_SIZE. The inputs go through each round together, which keeps the tables and the
+ * code of one algorithm in the cache for all of them
+ */
+void X16RV2Lanes(const unsigned char selection[16], const void *const *data, size_t len, size_t nLanes, unsigned char *hashes);
+
+#endif // X16RV2_H
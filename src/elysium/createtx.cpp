@@ -169,11 +169,9 @@ ElysiumTxBuilder& ElysiumTxBuilder::addChange(const std::string& destination, co
 void InputsToView(const std::vector<PrevTxsEntry>& prevTxs, CCoinsViewCache& view)
 {
     for (std::vector<PrevTxsEntry>::const_iterator it = prevTxs.begin(); it != prevTxs.end(); ++it) {
-        CCoinsModifier coins = view.ModifyCoins(it->outPoint.hash);
-        if ((size_t) it->outPoint.n >= coins->vout.size()) {
-            coins->vout.resize(it->outPoint.n+1);
-        }
-        coins->vout[it->outPoint.n].scriptPubKey = it->txOut.scriptPubKey;
-        coins->vout[it->outPoint.n].nValue = it->txOut.nValue;
+        Coin newcoin;
+        newcoin.out.scriptPubKey = it->txOut.scriptPubKey;
+        newcoin.out.nValue = it->txOut.nValue;
+        view.AddCoin(it->outPoint, std::move(newcoin), true);
     }
 }
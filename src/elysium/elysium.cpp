@@ -657,9 +657,8 @@ static bool FillTxInputCache(const CTransaction& tx)
         }
 
         unsigned int nOut = txIn.prevout.n;
-        CCoinsModifier coins = view.ModifyCoins(txIn.prevout.hash);
 
-        if (coins->IsAvailable(nOut)) {
+        if (view.HaveCoin(txIn.prevout)) {
             ++nCacheHits;
             continue;
         } else {
@@ -672,11 +671,14 @@ static bool FillTxInputCache(const CTransaction& tx)
             return false;
         }
 
-        if (nOut >= coins->vout.size()) {
-            coins->vout.resize(nOut+1);
+        if (nOut >= txPrev.vout.size()) {
+            return false;
         }
-        coins->vout[nOut].scriptPubKey = txPrev.vout[nOut].scriptPubKey;
-        coins->vout[nOut].nValue = txPrev.vout[nOut].nValue;
+
+        Coin newcoin;
+        newcoin.out.scriptPubKey = txPrev.vout[nOut].scriptPubKey;
+        newcoin.out.nValue = txPrev.vout[nOut].nValue;
+        view.AddCoin(txIn.prevout, std::move(newcoin), true);
     }
 
     return true;
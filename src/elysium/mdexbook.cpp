@@ -0,0 +1,359 @@
+#include "elysium/mdexbook.h"
+
+#include "elysium/errors.h"
+#include "elysium/elysium.h"
+#include "elysium/uint256_extensions.h"
+
+#include "arith_uint256.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace elysium {
+
+namespace {
+
+uint64_t GreatestCommonDivisor(uint64_t a, uint64_t b)
+{
+    while (b) {
+        uint64_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/** The 128 bit product of a and b from the products of their 32 bit halves. */
+void Multiply(uint64_t a, uint64_t b, uint64_t& high, uint64_t& low)
+{
+    const uint64_t mask = 0xffffffff;
+    uint64_t ll = (a & mask) * (b & mask);
+    uint64_t lh = (a & mask) * (b >> 32);
+    uint64_t hl = (a >> 32) * (b & mask);
+    uint64_t hh = (a >> 32) * (b >> 32);
+    uint64_t middle = (ll >> 32) + (lh & mask) + (hl & mask);
+
+    low = (middle << 32) | (ll & mask);
+    high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+}
+
+/** Orders of the same property by price, block and index, the order of md_PropertiesMap. */
+bool CompareOrders(const CMPMetaDEx& lhs, const CMPMetaDEx& rhs)
+{
+    if (lhs.getProperty() != rhs.getProperty()) return lhs.getProperty() < rhs.getProperty();
+
+    MetaDExPrice lhsPrice(lhs.getAmountDesired(), lhs.getAmountForSale());
+    MetaDExPrice rhsPrice(rhs.getAmountDesired(), rhs.getAmountForSale());
+    if (lhsPrice != rhsPrice) return lhsPrice < rhsPrice;
+
+    return MetaDEx_compare()(lhs, rhs);
+}
+
+} // namespace
+
+MetaDExPrice::MetaDExPrice(int64_t desired, int64_t forSale)
+{
+    assert(desired > 0 && forSale > 0);
+
+    uint64_t divisor = GreatestCommonDivisor(desired, forSale);
+    num = static_cast<uint64_t>(desired) / divisor;
+    den = static_cast<uint64_t>(forSale) / divisor;
+}
+
+bool MetaDExPrice::operator<(const MetaDExPrice& other) const
+{
+    return IsLess(num, den, other.num, other.den);
+}
+
+bool MetaDExPrice::IsLess(uint64_t a, uint64_t b, uint64_t c, uint64_t d)
+{
+    uint64_t adHigh, adLow, cbHigh, cbLow;
+    Multiply(a, d, adHigh, adLow);
+    Multiply(c, b, cbHigh, cbLow);
+
+    return adHigh < cbHigh || (adHigh == cbHigh && adLow < cbLow);
+}
+
+CMPMetaDEx MetaDExBook::Order::ToMetaDEx() const
+{
+    return CMPMetaDEx(addr, block, property, amountForSale, desiredProperty, amountDesired, txid, idx, subaction, amountRemaining);
+}
+
+MetaDExBook::MetaDExBook()
+{
+}
+
+MetaDExBook::~MetaDExBook()
+{
+}
+
+int MetaDExBook::Add(const CMPMetaDEx& offer, std::vector<MetaDExFill>& fills, int64_t& remaining)
+{
+    remaining = offer.getAmountRemaining();
+
+    if (offer.getAmountForSale() <= 0 || offer.getAmountDesired() <= 0) return METADEX_ERROR -66;
+
+    const uint64_t forSale = offer.getAmountForSale();
+    const uint64_t desired = offer.getAmountDesired();
+
+    std::map<std::pair<uint32_t, uint32_t>, Levels>::iterator book = books.find(std::make_pair(offer.getDesProperty(), offer.getProperty()));
+
+    if (book != books.end()) {
+        Levels& levels = book->second;
+
+        Levels::iterator level = levels.begin();
+        while (level != levels.end() && remaining > 0) {
+            // levels go from cheap to expensive, the new order pays at most its inverse price
+            if (MetaDExPrice::IsLess(forSale, desired, level->first.Numerator(), level->first.Denominator())) break;
+
+            // the level is erased when its last order is filled
+            Levels::iterator nextLevel = level;
+            ++nextLevel;
+
+            Order* order = level->second.first;
+            while (order && remaining > 0) {
+                Order* next = order->next;
+
+                // what the new order can buy of the old one at the price of the old one, rounded down
+                arith_uint256 iCouldBuy = (ConvertTo256(remaining) * ConvertTo256(order->amountForSale)) / ConvertTo256(order->amountDesired);
+                int64_t nCouldBuy = order->amountRemaining;
+                if (iCouldBuy < ConvertTo256(order->amountRemaining)) {
+                    nCouldBuy = ConvertTo64(iCouldBuy);
+                }
+
+                if (nCouldBuy == 0) {
+                    order = next;
+                    continue;
+                }
+
+                // and what it pays for it, rounded up, unless that's more than the new order asks for
+                arith_uint256 iWouldPay = DivideAndRoundUp((ConvertTo256(nCouldBuy) * ConvertTo256(order->amountDesired)), ConvertTo256(order->amountForSale));
+                int64_t nWouldPay = ConvertTo64(iWouldPay);
+
+                if (MetaDExPrice::IsLess(forSale, desired, nWouldPay, nCouldBuy)) {
+                    order = next;
+                    continue;
+                }
+
+                remaining -= nWouldPay;
+                order->amountRemaining -= nCouldBuy;
+                assert(remaining >= 0 && order->amountRemaining >= 0);
+
+                MetaDExFill fill;
+                fill.txid = order->txid;
+                fill.addr = order->addr;
+                fill.property = order->property;
+                fill.desiredProperty = order->desiredProperty;
+                fill.amountSold = nCouldBuy;
+                fill.amountReceived = nWouldPay;
+                fill.amountRemaining = order->amountRemaining;
+                fills.push_back(fill);
+
+                if (order->amountRemaining == 0) {
+                    Unlink(order);
+                }
+
+                order = next;
+            }
+
+            level = nextLevel;
+        }
+    }
+
+    if (remaining > 0) {
+        CMPMetaDEx rest(offer.getAddr(), offer.getBlock(), offer.getProperty(), offer.getAmountForSale(),
+            offer.getDesProperty(), offer.getAmountDesired(), offer.getHash(), offer.getIdx(), offer.getAction(), remaining);
+        if (!Link(rest)) return METADEX_ERROR -70;
+    }
+
+    return 0;
+}
+
+bool MetaDExBook::Insert(const CMPMetaDEx& offer)
+{
+    if (offer.getAmountForSale() <= 0 || offer.getAmountDesired() <= 0) return false;
+
+    return Link(offer) != NULL;
+}
+
+bool MetaDExBook::Get(const uint256& txid, CMPMetaDEx& offer) const
+{
+    std::unordered_map<uint256, Order, SaltedTxidHasher>::const_iterator it = orders.find(txid);
+    if (it == orders.end()) return false;
+
+    offer = it->second.ToMetaDEx();
+    return true;
+}
+
+bool MetaDExBook::Remove(const uint256& txid)
+{
+    std::unordered_map<uint256, Order, SaltedTxidHasher>::iterator it = orders.find(txid);
+    if (it == orders.end()) return false;
+
+    Unlink(&it->second);
+    return true;
+}
+
+std::vector<CMPMetaDEx> MetaDExBook::CancelAtPrice(const std::string& addr, uint32_t property, int64_t amountForSale, uint32_t desiredProperty, int64_t amountDesired)
+{
+    std::vector<CMPMetaDEx> cancelled;
+
+    if (amountForSale <= 0 || amountDesired <= 0) return cancelled;
+
+    std::map<std::pair<uint32_t, uint32_t>, Levels>::iterator book = books.find(std::make_pair(property, desiredProperty));
+    if (book == books.end()) return cancelled;
+
+    Levels::iterator level = book->second.find(MetaDExPrice(amountDesired, amountForSale));
+    if (level == book->second.end()) return cancelled;
+
+    for (Order* order = level->second.first; order;) {
+        Order* next = order->next;
+        if (order->addr == addr) {
+            cancelled.push_back(order->ToMetaDEx());
+            Unlink(order);
+        }
+        order = next;
+    }
+
+    return cancelled;
+}
+
+std::vector<CMPMetaDEx> MetaDExBook::CancelAllForPair(const std::string& addr, uint32_t property, uint32_t desiredProperty)
+{
+    std::vector<CMPMetaDEx> cancelled;
+
+    std::map<std::pair<uint32_t, uint32_t>, Levels>::iterator book = books.find(std::make_pair(property, desiredProperty));
+    if (book == books.end()) return cancelled;
+
+    RemoveByAddress(book->second, addr, cancelled);
+
+    return cancelled;
+}
+
+std::vector<CMPMetaDEx> MetaDExBook::CancelEverything(const std::string& addr, unsigned char ecosystem)
+{
+    std::vector<CMPMetaDEx> cancelled;
+
+    std::map<std::pair<uint32_t, uint32_t>, Levels>::iterator book;
+    for (book = books.begin(); book != books.end(); ++book) {
+        uint32_t property = book->first.first;
+
+        if (isMainEcosystemProperty(ecosystem) && !isMainEcosystemProperty(property)) continue;
+        if (isTestEcosystemProperty(ecosystem) && !isTestEcosystemProperty(property)) continue;
+
+        RemoveByAddress(book->second, addr, cancelled);
+    }
+
+    // the pairs of a property share the price levels of md_PropertiesMap
+    std::stable_sort(cancelled.begin(), cancelled.end(), CompareOrders);
+
+    return cancelled;
+}
+
+std::vector<CMPMetaDEx> MetaDExBook::GetOrders() const
+{
+    std::vector<CMPMetaDEx> offers;
+    offers.reserve(orders.size());
+
+    std::map<std::pair<uint32_t, uint32_t>, Levels>::const_iterator book;
+    for (book = books.begin(); book != books.end(); ++book) {
+        for (Levels::const_iterator level = book->second.begin(); level != book->second.end(); ++level) {
+            for (const Order* order = level->second.first; order; order = order->next) {
+                offers.push_back(order->ToMetaDEx());
+            }
+        }
+    }
+
+    std::stable_sort(offers.begin(), offers.end(), CompareOrders);
+
+    return offers;
+}
+
+void MetaDExBook::Clear()
+{
+    orders.clear();
+    books.clear();
+}
+
+MetaDExBook::Order* MetaDExBook::Link(const CMPMetaDEx& offer)
+{
+    std::pair<std::unordered_map<uint256, Order, SaltedTxidHasher>::iterator, bool> inserted = orders.insert(std::make_pair(offer.getHash(), Order()));
+    if (!inserted.second) return NULL;
+
+    Levels& levels = books[std::make_pair(offer.getProperty(), offer.getDesProperty())];
+    Levels::iterator level = levels.insert(std::make_pair(MetaDExPrice(offer.getAmountDesired(), offer.getAmountForSale()), Level())).first;
+
+    // orders mostly come in block order, so the place of a new one is found from the back
+    Order* prev = level->second.last;
+    while (prev && (offer.getBlock() < prev->block || (offer.getBlock() == prev->block && offer.getIdx() < prev->idx))) {
+        prev = prev->prev;
+    }
+
+    if (prev && prev->block == offer.getBlock() && prev->idx == offer.getIdx()) {
+        orders.erase(inserted.first);
+        if (!level->second.first) levels.erase(level);
+        return NULL;
+    }
+
+    Order* order = &inserted.first->second;
+    order->txid = offer.getHash();
+    order->addr = offer.getAddr();
+    order->block = offer.getBlock();
+    order->idx = offer.getIdx();
+    order->property = offer.getProperty();
+    order->desiredProperty = offer.getDesProperty();
+    order->amountForSale = offer.getAmountForSale();
+    order->amountDesired = offer.getAmountDesired();
+    order->amountRemaining = offer.getAmountRemaining();
+    order->subaction = offer.getAction();
+    order->levels = &levels;
+    order->level = level;
+
+    order->prev = prev;
+    order->next = prev ? prev->next : level->second.first;
+    (order->prev ? order->prev->next : level->second.first) = order;
+    (order->next ? order->next->prev : level->second.last) = order;
+
+    return order;
+}
+
+void MetaDExBook::Unlink(Order* order)
+{
+    Level& level = order->level->second;
+    (order->prev ? order->prev->next : level.first) = order->next;
+    (order->next ? order->next->prev : level.last) = order->prev;
+
+    if (!level.first) order->levels->erase(order->level);
+
+    uint256 txid = order->txid;
+    orders.erase(txid);
+}
+
+void MetaDExBook::RemoveByAddress(Levels& levels, const std::string& addr, std::vector<CMPMetaDEx>& removed)
+{
+    Levels::iterator level = levels.begin();
+    while (level != levels.end()) {
+        // the level is erased with its last order
+        Levels::iterator nextLevel = level;
+        ++nextLevel;
+
+        for (Order* order = level->second.first; order;) {
+            Order* next = order->next;
+            if (order->addr == addr) {
+                removed.push_back(order->ToMetaDEx());
+                Unlink(order);
+            }
+            order = next;
+        }
+
+        level = nextLevel;
+    }
+}
+
+} // namespace elysium
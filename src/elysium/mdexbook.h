@@ -0,0 +1,162 @@
+#ifndef ELYSIUM_MDEXBOOK_H
+#define ELYSIUM_MDEXBOOK_H
+
+#include "elysium/mdex.h"
+
+#include "coins.h"
+#include "uint256.h"
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace elysium {
+
+/** Unit price of an order, amount desired / amount for sale, as a reduced fraction of two positive integers.
+ *
+ * Every price has exactly one representation, so equal prices are equal keys, and prices are ordered by cross
+ * multiplication in 128 bits, which is exact for all amounts up to the int64_t range.
+ */
+class MetaDExPrice
+{
+public:
+    MetaDExPrice() : num(0), den(1) {}
+
+    /** The price of desired per forSale, both amounts must be positive. */
+    MetaDExPrice(int64_t desired, int64_t forSale);
+
+    uint64_t Numerator() const { return num; }
+    uint64_t Denominator() const { return den; }
+
+    bool operator==(const MetaDExPrice& other) const { return num == other.num && den == other.den; }
+    bool operator!=(const MetaDExPrice& other) const { return !(*this == other); }
+    bool operator<(const MetaDExPrice& other) const;
+
+    /** Whether a / b is less than c / d, for positive b and d and all values below 2^64. */
+    static bool IsLess(uint64_t a, uint64_t b, uint64_t c, uint64_t d);
+
+private:
+    uint64_t num;
+    uint64_t den;
+};
+
+/** A trade of a new order against one order of the book. */
+struct MetaDExFill
+{
+    uint256 txid;
+    std::string addr;
+    uint32_t property;
+    uint32_t desiredProperty;
+
+    //! Tokens of property the order of the book sold to the new order, before fees
+    int64_t amountSold;
+    //! Tokens of desiredProperty the new order paid to the order of the book
+    int64_t amountReceived;
+    //! What the order of the book has left for sale, it's removed from the book at zero
+    int64_t amountRemaining;
+};
+
+/** Order book of the MetaDEx.
+ *
+ * Orders are kept per pair of property for sale and property desired, with a level for every price. A level is a
+ * queue of orders in block and index order, linked through the orders, and every order can be found by its txid,
+ * so that removing one takes constant time.
+ *
+ * The book only decides what trades and what's left, in the same order and with the same amounts as MetaDEx_ADD.
+ * Balances, fees and the trade and transaction databases are up to the caller.
+ */
+class MetaDExBook
+{
+public:
+    MetaDExBook();
+    ~MetaDExBook();
+
+    /** Trades a new order against the book and adds what's left of it.
+     *
+     * Trades are appended to fills in the order they happen and remaining is set to what's left of the order.
+     * Returns 0, METADEX_ERROR -66 for an order without a positive price, which trades nothing, or METADEX_ERROR -70
+     * for an order that's already in the book, after it traded.
+     */
+    int Add(const CMPMetaDEx& offer, std::vector<MetaDExFill>& fills, int64_t& remaining);
+
+    /** Adds an order to the book without trading, returns false if it's already in it. */
+    bool Insert(const CMPMetaDEx& offer);
+
+    /** The order with txid, or false if it's not in the book. */
+    bool Get(const uint256& txid, CMPMetaDEx& offer) const;
+
+    /** Removes the order with txid, returns false if it's not in the book. */
+    bool Remove(const uint256& txid);
+
+    /** Removes the orders of addr for a pair at the price of amountForSale and amountDesired. */
+    std::vector<CMPMetaDEx> CancelAtPrice(const std::string& addr, uint32_t property, int64_t amountForSale, uint32_t desiredProperty, int64_t amountDesired);
+
+    /** Removes the orders of addr for a pair. */
+    std::vector<CMPMetaDEx> CancelAllForPair(const std::string& addr, uint32_t property, uint32_t desiredProperty);
+
+    /** Removes the orders of addr for all the properties of an ecosystem. */
+    std::vector<CMPMetaDEx> CancelEverything(const std::string& addr, unsigned char ecosystem);
+
+    /** All the orders by property, price, block and index, the order of the maps of mdex.h. */
+    std::vector<CMPMetaDEx> GetOrders() const;
+
+    size_t Size() const { return orders.size(); }
+
+    void Clear();
+
+private:
+    struct Order;
+
+    /** Orders of one price, oldest first */
+    struct Level
+    {
+        Order* first;
+        Order* last;
+
+        Level() : first(NULL), last(NULL) {}
+    };
+
+    typedef std::map<MetaDExPrice, Level> Levels;
+
+    struct Order
+    {
+        uint256 txid;
+        std::string addr;
+        int block;
+        unsigned int idx;
+        uint32_t property;
+        uint32_t desiredProperty;
+        int64_t amountForSale;
+        int64_t amountDesired;
+        int64_t amountRemaining;
+        uint8_t subaction;
+
+        Levels* levels;
+        Levels::iterator level;
+        Order* prev;
+        Order* next;
+
+        CMPMetaDEx ToMetaDEx() const;
+    };
+
+    //! Levels by property for sale and property desired
+    std::map<std::pair<uint32_t, uint32_t>, Levels> books;
+    std::unordered_map<uint256, Order, SaltedTxidHasher> orders;
+
+    MetaDExBook(const MetaDExBook&);
+    MetaDExBook& operator=(const MetaDExBook&);
+
+    Order* Link(const CMPMetaDEx& offer);
+    void Unlink(Order* order);
+
+    /** Removes the orders of addr from levels, in the order of the levels, and appends them to removed */
+    void RemoveByAddress(Levels& levels, const std::string& addr, std::vector<CMPMetaDEx>& removed);
+};
+
+} // namespace elysium
+
+#endif // ELYSIUM_MDEXBOOK_H
@@ -0,0 +1,293 @@
+#include "elysium/mdexbook.h"
+
+#include "elysium/elysium.h"
+#include "elysium/errors.h"
+#include "elysium/mdex.h"
+#include "elysium/rules.h"
+#include "elysium/tally.h"
+#include "elysium/tx.h"
+
+#include "arith_uint256.h"
+#include "random.h"
+#include "uint256.h"
+
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <stdint.h>
+
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace elysium;
+
+namespace {
+
+/** Balances and reserves the way MetaDEx_ADD and the cancels update the tally map, from what the book reports */
+class ShadowTally
+{
+public:
+    int64_t Get(const std::string& addr, uint32_t property, TallyType type) const
+    {
+        std::map<Key, int64_t>::const_iterator it = amounts.find(MakeKey(addr, property, type));
+        return it == amounts.end() ? 0 : it->second;
+    }
+
+    void Update(const std::string& addr, uint32_t property, int64_t amount, TallyType type)
+    {
+        amounts[MakeKey(addr, property, type)] += amount;
+    }
+
+    void ApplyFill(const CMPMetaDEx& offer, const MetaDExFill& fill)
+    {
+        int64_t fee = 0;
+        if (IsFeatureActivated(FEATURE_FEES, offer.getBlock())) {
+            if (fill.property > ELYSIUM_PROPERTY_TELYSIUM && fill.desiredProperty > ELYSIUM_PROPERTY_TELYSIUM) {
+                fee = fill.amountSold / 2000;
+            }
+        }
+
+        Update(offer.getAddr(), offer.getProperty(), -fill.amountReceived, BALANCE);
+        Update(fill.addr, fill.desiredProperty, fill.amountReceived, BALANCE);
+        Update(fill.addr, fill.property, -fill.amountSold, METADEX_RESERVE);
+        Update(offer.getAddr(), offer.getDesProperty(), fill.amountSold - fee, BALANCE);
+    }
+
+    void Reserve(const std::string& addr, uint32_t property, int64_t amount)
+    {
+        Update(addr, property, -amount, BALANCE);
+        Update(addr, property, amount, METADEX_RESERVE);
+    }
+
+private:
+    typedef std::pair<std::pair<std::string, uint32_t>, int> Key;
+
+    static Key MakeKey(const std::string& addr, uint32_t property, TallyType type)
+    {
+        return std::make_pair(std::make_pair(addr, property), static_cast<int>(type));
+    }
+
+    std::map<Key, int64_t> amounts;
+};
+
+std::vector<CMPMetaDEx> LegacyOrders()
+{
+    std::vector<CMPMetaDEx> offers;
+    for (md_PropertiesMap::const_iterator prices = metadex.begin(); prices != metadex.end(); ++prices) {
+        for (md_PricesMap::const_iterator level = prices->second.begin(); level != prices->second.end(); ++level) {
+            offers.insert(offers.end(), level->second.begin(), level->second.end());
+        }
+    }
+    return offers;
+}
+
+struct MetaDExBookTestingSetup : TestingSetup
+{
+    MetaDExBookTestingSetup()
+    {
+        if (!t_tradelistdb) t_tradelistdb = new CMPTradeList(pathTemp / "MP_tradelist_test", true);
+        if (!p_txlistdb) p_txlistdb = new CMPTxList(pathTemp / "MP_txlist_test", true);
+        metadex.clear();
+        mp_tally_map.clear();
+    }
+
+    ~MetaDExBookTestingSetup()
+    {
+        metadex.clear();
+        mp_tally_map.clear();
+    }
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(elysium_mdexbook_tests, MetaDExBookTestingSetup)
+
+BOOST_AUTO_TEST_CASE(price_canonical)
+{
+    BOOST_CHECK(MetaDExPrice(2, 4) == MetaDExPrice(1, 2));
+    BOOST_CHECK(MetaDExPrice(3, 9) == MetaDExPrice(7, 21));
+    BOOST_CHECK_EQUAL(MetaDExPrice(6, 4).Numerator(), 3);
+    BOOST_CHECK_EQUAL(MetaDExPrice(6, 4).Denominator(), 2);
+    BOOST_CHECK(MetaDExPrice(1, 3) != MetaDExPrice(1, 2));
+}
+
+BOOST_AUTO_TEST_CASE(price_order)
+{
+    const int64_t max = std::numeric_limits<int64_t>::max();
+
+    BOOST_CHECK(MetaDExPrice(1, 3) < MetaDExPrice(1, 2));
+    BOOST_CHECK(!(MetaDExPrice(1, 2) < MetaDExPrice(1, 3)));
+    BOOST_CHECK(!(MetaDExPrice(1, 2) < MetaDExPrice(2, 4)));
+
+    // the products of these need all of 127 bits
+    BOOST_CHECK(MetaDExPrice(max - 1, max) < MetaDExPrice(max, max - 1));
+    BOOST_CHECK(MetaDExPrice(max - 2, max - 1) < MetaDExPrice(max - 1, max));
+    BOOST_CHECK(!(MetaDExPrice(max - 1, max) < MetaDExPrice(max - 2, max - 1)));
+    BOOST_CHECK(MetaDExPrice(1, max) < MetaDExPrice(1, max - 1));
+    BOOST_CHECK(MetaDExPrice(max, 1) == MetaDExPrice(max, 1));
+    BOOST_CHECK(!(MetaDExPrice(max, 1) < MetaDExPrice(max, 1)));
+
+    BOOST_CHECK(MetaDExPrice::IsLess(0xffffffffffffffffULL, 0xfffffffffffffffeULL, 0xfffffffffffffffeULL, 0xfffffffffffffffdULL));
+    BOOST_CHECK(!MetaDExPrice::IsLess(0xfffffffffffffffeULL, 0xfffffffffffffffdULL, 0xffffffffffffffffULL, 0xfffffffffffffffeULL));
+}
+
+BOOST_AUTO_TEST_CASE(insert_in_block_order)
+{
+    MetaDExBook book;
+    uint256 txid1 = ArithToUint256(arith_uint256(1));
+    uint256 txid2 = ArithToUint256(arith_uint256(2));
+    uint256 txid3 = ArithToUint256(arith_uint256(3));
+
+    BOOST_CHECK(book.Insert(CMPMetaDEx("a", 10, 3, 100, 4, 50, txid1, 2, CMPTransaction::ADD)));
+    BOOST_CHECK(book.Insert(CMPMetaDEx("b", 10, 3, 200, 4, 100, txid2, 1, CMPTransaction::ADD)));
+    BOOST_CHECK(book.Insert(CMPMetaDEx("c", 9, 3, 2, 4, 1, txid3, 7, CMPTransaction::ADD)));
+
+    // the same transaction, or another one at the same place, is rejected
+    BOOST_CHECK(!book.Insert(CMPMetaDEx("a", 10, 3, 100, 4, 50, txid1, 2, CMPTransaction::ADD)));
+    BOOST_CHECK(!book.Insert(CMPMetaDEx("d", 9, 3, 4, 4, 2, ArithToUint256(arith_uint256(4)), 7, CMPTransaction::ADD)));
+    BOOST_CHECK_EQUAL(book.Size(), 3);
+
+    std::vector<CMPMetaDEx> offers = book.GetOrders();
+    BOOST_CHECK_EQUAL(offers.size(), 3);
+    BOOST_CHECK(offers[0].getHash() == txid3);
+    BOOST_CHECK(offers[1].getHash() == txid2);
+    BOOST_CHECK(offers[2].getHash() == txid1);
+
+    BOOST_CHECK(book.Remove(txid2));
+    BOOST_CHECK(!book.Remove(txid2));
+
+    CMPMetaDEx offer;
+    BOOST_CHECK(!book.Get(txid2, offer));
+    BOOST_CHECK(book.Get(txid1, offer));
+    BOOST_CHECK_EQUAL(offer.getAddr(), "a");
+    BOOST_CHECK_EQUAL(offer.getAmountRemaining(), 100);
+
+    // the first in the level is the one that trades first
+    std::vector<MetaDExFill> fills;
+    int64_t remaining = 0;
+    BOOST_CHECK_EQUAL(book.Add(CMPMetaDEx("e", 11, 4, 1, 3, 2, ArithToUint256(arith_uint256(5)), 1, CMPTransaction::ADD), fills, remaining), 0);
+    BOOST_CHECK_EQUAL(remaining, 0);
+    BOOST_CHECK_EQUAL(fills.size(), 1);
+    BOOST_CHECK(fills[0].txid == txid3);
+    BOOST_CHECK_EQUAL(fills[0].amountSold, 2);
+    BOOST_CHECK_EQUAL(fills[0].amountReceived, 1);
+    BOOST_CHECK_EQUAL(fills[0].amountRemaining, 0);
+    BOOST_CHECK_EQUAL(book.Size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(bad_price)
+{
+    MetaDExBook book;
+    std::vector<MetaDExFill> fills;
+    int64_t remaining = 0;
+
+    BOOST_CHECK_EQUAL(book.Add(CMPMetaDEx("a", 1, 3, 100, 4, 0, uint256(), 1, CMPTransaction::ADD), fills, remaining), METADEX_ERROR -66);
+    BOOST_CHECK_EQUAL(book.Add(CMPMetaDEx("a", 1, 3, 0, 4, 100, uint256(), 1, CMPTransaction::ADD), fills, remaining), METADEX_ERROR -66);
+    BOOST_CHECK_EQUAL(book.Size(), 0);
+}
+
+/**
+ * Random orders, cancels included, go through MetaDEx_ADD and the cancels of mdex.h and through the book, and after
+ * every one the orders and the balances of both have to be the same.
+ */
+BOOST_AUTO_TEST_CASE(differential)
+{
+    const std::string addrs[] = {"alice", "bob", "carol", "dave", "erin"};
+    const uint32_t properties[] = {ELYSIUM_PROPERTY_ELYSIUM, 3, 4, 2147483651U};
+    const int64_t funds = 1000000000000000LL;
+
+    MetaDExBook book;
+    ShadowTally shadow;
+
+    for (const std::string& addr : addrs) {
+        for (uint32_t property : properties) {
+            BOOST_REQUIRE(update_tally_map(addr, property, funds, BALANCE));
+            shadow.Update(addr, property, funds, BALANCE);
+        }
+    }
+
+    seed_insecure_rand(true);
+
+    int block = 100;
+    unsigned int idx = 0;
+    uint64_t nextTxid = 1;
+    size_t nFills = 0;
+
+    for (int i = 0; i < 3000; i++) {
+        if (insecure_rand() % 4 == 0) {
+            block++;
+            idx = 0;
+        }
+
+        const std::string& addr = addrs[insecure_rand() % 5];
+        uint32_t property = properties[insecure_rand() % 4];
+        uint32_t desiredProperty = properties[insecure_rand() % 4];
+        if (property == desiredProperty) continue;
+
+        // small amounts share prices and round a lot, large ones don't
+        int64_t amount = 1 + insecure_rand() % 40;
+        int64_t amountDesired = 1 + insecure_rand() % 40;
+        if (insecure_rand() % 3 == 0) amount *= 1 + insecure_rand() % 100000000;
+        if (insecure_rand() % 3 == 0) amountDesired *= 1 + insecure_rand() % 100000000;
+
+        uint256 txid = ArithToUint256(arith_uint256(nextTxid++));
+        unsigned int action = insecure_rand() % 20;
+
+        if (action < 16) {
+            if (shadow.Get(addr, property, BALANCE) < amount) continue;
+
+            CMPMetaDEx offer(addr, block, property, amount, desiredProperty, amountDesired, txid, idx++, CMPTransaction::ADD);
+
+            int rcLegacy = MetaDEx_ADD(addr, property, amount, block, desiredProperty, amountDesired, txid, offer.getIdx());
+
+            std::vector<MetaDExFill> fills;
+            int64_t remaining = 0;
+            int rc = book.Add(offer, fills, remaining);
+            BOOST_CHECK_EQUAL(rc, rcLegacy);
+            nFills += fills.size();
+
+            for (const MetaDExFill& fill : fills) shadow.ApplyFill(offer, fill);
+            if (rc == 0 && remaining > 0) shadow.Reserve(addr, property, remaining);
+        } else {
+            std::vector<CMPMetaDEx> cancelled;
+            if (action < 18) {
+                MetaDEx_CANCEL_AT_PRICE(txid, block, addr, property, amount, desiredProperty, amountDesired);
+                cancelled = book.CancelAtPrice(addr, property, amount, desiredProperty, amountDesired);
+            } else if (action < 19) {
+                MetaDEx_CANCEL_ALL_FOR_PAIR(txid, block, addr, property, desiredProperty);
+                cancelled = book.CancelAllForPair(addr, property, desiredProperty);
+            } else {
+                unsigned char ecosystem = isTestEcosystemProperty(property) ? ELYSIUM_PROPERTY_TELYSIUM : ELYSIUM_PROPERTY_ELYSIUM;
+                MetaDEx_CANCEL_EVERYTHING(txid, block, addr, ecosystem);
+                cancelled = book.CancelEverything(addr, ecosystem);
+            }
+
+            for (const CMPMetaDEx& offer : cancelled) shadow.Reserve(offer.getAddr(), offer.getProperty(), -offer.getAmountRemaining());
+        }
+
+        std::vector<CMPMetaDEx> expected = LegacyOrders();
+        std::vector<CMPMetaDEx> offers = book.GetOrders();
+        BOOST_REQUIRE_EQUAL(offers.size(), expected.size());
+        for (size_t j = 0; j < offers.size(); j++) {
+            BOOST_REQUIRE(offers[j].getHash() == expected[j].getHash());
+            BOOST_REQUIRE_EQUAL(offers[j].getAmountRemaining(), expected[j].getAmountRemaining());
+        }
+
+        for (const std::string& addr : addrs) {
+            for (uint32_t property : properties) {
+                BOOST_REQUIRE_EQUAL(shadow.Get(addr, property, BALANCE), getMPbalance(addr, property, BALANCE));
+                BOOST_REQUIRE_EQUAL(shadow.Get(addr, property, METADEX_RESERVE), getMPbalance(addr, property, METADEX_RESERVE));
+            }
+        }
+    }
+
+    // the run has to have traded and left orders in the book to mean something
+    BOOST_CHECK(nFills > 0);
+    BOOST_CHECK(book.Size() > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
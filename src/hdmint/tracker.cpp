@@ -32,6 +32,8 @@ CHDMintTracker::CHDMintTracker(std::string strWalletFile)
     this->strWalletFile = strWalletFile;
     mapSerialHashes.clear();
     mapPendingSpends.clear();
+    mapMintEntries.clear();
+    mapUnusedBalance.clear();
     fInitialized = false;
 }
 
@@ -46,6 +48,7 @@ CHDMintTracker::~CHDMintTracker()
 {
     mapSerialHashes.clear();
     mapPendingSpends.clear();
+    mapMintEntries.clear();
 }
 
 /**
@@ -75,8 +78,12 @@ bool CHDMintTracker::Archive(CMintMeta& meta)
 {
     uint256 hashPubcoin = meta.GetPubCoinValueHash();
 
-    if (HasSerialHash(meta.hashSerial))
-        mapSerialHashes.at(meta.hashSerial).isArchived = true;
+    if (HasSerialHash(meta.hashSerial)) {
+        CMintMeta archived = mapSerialHashes.at(meta.hashSerial);
+        archived.isArchived = true;
+        SetMeta(archived);
+    }
+    mapMintEntries.erase(meta.hashSerial);
 
    CWalletDB walletdb(strWalletFile);
     CHDMint dMint;
@@ -266,11 +273,120 @@ bool CHDMintTracker::UpdateState(const CMintMeta& meta)
             CT_UPDATED);
     }
 
-    mapSerialHashes[meta.hashSerial] = meta;
+    auto entry = mapMintEntries.find(meta.hashSerial);
+    if (entry != mapMintEntries.end()) {
+        entry->second.nHeight = meta.nHeight;
+        entry->second.id = meta.nId;
+        entry->second.IsUsed = meta.isUsed;
+        entry->second.set_denomination(meta.denom);
+    }
+
+    SetMeta(meta);
+
+    return true;
+}
+
+/**
+ * Get a decrypted mint from the in-memory cache.
+ *
+ * @param hashSerial mint serial hash
+ * @param entry reference to CSigmaEntry object
+ * @return success
+ */
+bool CHDMintTracker::GetMintEntry(const uint256& hashSerial, CSigmaEntry& entry) const
+{
+    auto it = mapMintEntries.find(hashSerial);
+    if (it == mapMintEntries.end())
+        return false;
 
+    entry = it->second;
     return true;
 }
 
+/**
+ * Keep a decrypted mint in memory so that it does not have to be read from the database again.
+ * The cache is kept in sync by UpdateState and dropped when the wallet is locked.
+ *
+ * @param hashSerial mint serial hash
+ * @param entry the decrypted CSigmaEntry object
+ * @return void
+ */
+void CHDMintTracker::CacheMintEntry(const uint256& hashSerial, const CSigmaEntry& entry)
+{
+    if (HasSerialHash(hashSerial))
+        mapMintEntries[hashSerial] = entry;
+}
+
+/**
+ * Drop all decrypted mints from memory.
+ *
+ * @return void
+ */
+void CHDMintTracker::ClearMintEntries()
+{
+    mapMintEntries.clear();
+}
+
+/**
+ * Get the sigma balance from the incrementally maintained totals.
+ *
+ * Only unused, unarchived mints with a correct seed are counted, the same set ListMints(true, false, false) returns.
+ *
+ * @param nAll amount of all unused mints
+ * @param nConfirmed amount of unused mints with ZC_MINT_CONFIRMATIONS confirmations at nHeight
+ * @param nHeight the chain height
+ * @return void
+ */
+void CHDMintTracker::GetBalance(CAmount& nAll, CAmount& nConfirmed, int nHeight) const
+{
+    nAll = 0;
+    nConfirmed = 0;
+    for (auto const & it : mapUnusedBalance) {
+        nAll += it.second;
+        if (it.first > 0 && it.first + (ZC_MINT_CONFIRMATIONS-1) <= nHeight)
+            nConfirmed += it.second;
+    }
+}
+
+/**
+ * Add or remove the mint from the balance totals.
+ *
+ * @param meta the CMintMeta object
+ * @param fAdd true to add the mint amount, false to remove it
+ * @return void
+ */
+void CHDMintTracker::UpdateBalance(const CMintMeta& meta, bool fAdd)
+{
+    if (meta.isUsed || meta.isArchived || !meta.isSeedCorrect)
+        return;
+
+    int64_t amount;
+    if (!DenominationToInteger(meta.denom, amount))
+        return;
+
+    int height = std::max(meta.nHeight, 0);
+    CAmount& total = mapUnusedBalance[height];
+    total += fAdd ? amount : -amount;
+    if (total == 0)
+        mapUnusedBalance.erase(height);
+}
+
+/**
+ * Replace the in-memory CMintMeta object, keeping the balance totals in sync.
+ *
+ * @param meta the CMintMeta object
+ * @return void
+ */
+void CHDMintTracker::SetMeta(const CMintMeta& meta)
+{
+    auto it = mapSerialHashes.find(meta.hashSerial);
+    if (it != mapSerialHashes.end())
+        UpdateBalance(it->second, false);
+
+    mapSerialHashes[meta.hashSerial] = meta;
+    UpdateBalance(meta, true);
+}
+
 /**
  * Add a mint object to memory.
  * 
@@ -296,7 +412,8 @@ void CHDMintTracker::Add(const CHDMint& dMint, bool isNew, bool isArchived)
     meta.isArchived = isArchived;
     meta.isDeterministic = true;
     meta.isSeedCorrect = true;
-    mapSerialHashes[meta.hashSerial] = meta;
+    SetMeta(meta);
+    mapMintEntries.erase(meta.hashSerial);
 
     pwalletMain->NotifyZerocoinChanged(
         pwalletMain,
@@ -321,7 +438,8 @@ void CHDMintTracker::Add(const CSigmaEntry& sigma, bool isNew, bool isArchived)
     meta.isArchived = isArchived;
     meta.isDeterministic = false;
     meta.isSeedCorrect = true;
-    mapSerialHashes[meta.hashSerial] = meta;
+    SetMeta(meta);
+    mapMintEntries.erase(meta.hashSerial);
 
     if (isNew)
         CWalletDB(strWalletFile).WriteSigmaEntry(sigma);
@@ -799,4 +917,6 @@ std::set<uint256> CHDMintTracker::GetMempoolTxids(){
 void CHDMintTracker::Clear()
 {
     mapSerialHashes.clear();
+    mapMintEntries.clear();
+    mapUnusedBalance.clear();
 }
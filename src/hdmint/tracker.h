@@ -19,6 +19,10 @@ private:
     std::string strWalletFile;
     std::map<uint256, CMintMeta> mapSerialHashes;
     std::map<uint256, uint256> mapPendingSpends; //serialhash, txid of spend
+    std::map<uint256, CSigmaEntry> mapMintEntries; //serialhash, decrypted mint. Only filled while the wallet is unlocked
+    std::map<int, CAmount> mapUnusedBalance; //height, amount of unused mints minted at that height (<= 0 if unknown)
+    void SetMeta(const CMintMeta& meta);
+    void UpdateBalance(const CMintMeta& meta, bool fAdd);
     bool IsMempoolSpendOurs(const std::set<uint256>& setMempool, const uint256& hashSerial);
     bool UpdateMetaStatus(const std::set<uint256>& setMempool, CMintMeta& mint, bool fSpend=false);
     std::set<uint256> GetMempoolTxids();
@@ -46,6 +50,10 @@ public:
     void SetPubcoinNotUsed(const uint256& hashPubcoin);
     bool UnArchive(const uint256& hashPubcoin, bool isDeterministic);
     bool UpdateState(const CMintMeta& meta);
+    bool GetMintEntry(const uint256& hashSerial, CSigmaEntry& entry) const;
+    void CacheMintEntry(const uint256& hashSerial, const CSigmaEntry& entry);
+    void ClearMintEntries();
+    void GetBalance(CAmount& nAll, CAmount& nConfirmed, int nHeight) const;
     void Clear();
 };
 
@@ -14,6 +14,7 @@
 #include "crypto/hmac_sha256.h"
 #include "crypto/hmac_sha512.h"
 #include "keystore.h"
+#include "libzerocoin/ParallelTasks.h"
 #include <boost/optional.hpp>
 #include "shroudnode-sync.h"
 
@@ -96,37 +97,54 @@ bool CHDMintWallet::SetupWallet(const uint160& hashSeedMaster, bool fResetCount)
  */
 std::pair<uint256,uint256> CHDMintWallet::RegenerateMintPoolEntry(const uint160& mintHashSeedMaster, CKeyID& seedId, const int32_t& nCount)
 {
-    // hashPubcoin, hashSerial
-    std::pair<uint256,uint256> nIndexes;
+    std::vector<std::pair<uint256,uint256>> vIndexes = RegenerateMintPoolEntries({MintPoolEntry(mintHashSeedMaster, seedId, nCount)});
+    return vIndexes.front();
+}
+
+/**
+ * Regenerate a batch of MintPoolEntry values.
+ *
+ * Same as RegenerateMintPoolEntry, but derives the mints in parallel and writes them to the
+ * database in one transaction per MINTPOOL_BATCH_SIZE entries.
+ *
+ * @param entries mintpool entries to regenerate
+ * @return pairs of <hashPubcoin,hashSerial>, in the order of entries
+ */
+std::vector<std::pair<uint256,uint256>> CHDMintWallet::RegenerateMintPoolEntries(const std::vector<MintPoolEntry>& entries)
+{
+    std::vector<std::pair<uint256,uint256>> vIndexes;
+    vIndexes.reserve(entries.size());
 
-    CWalletDB walletdb(strWalletFile);
     //Is locked
     if (pwalletMain->IsLocked())
         throw ZerocoinException("Error: Please enter the wallet passphrase with walletpassphrase first.");
 
-    uint512 mintSeed;
-    if(!CreateMintSeed(mintSeed, nCount, seedId))
-        throw ZerocoinException("Unable to create seed for mint regeneration.");
+    for (size_t nBatchStart = 0; nBatchStart < entries.size(); nBatchStart += MINTPOOL_BATCH_SIZE) {
+        size_t nBatchEnd = std::min(entries.size(), nBatchStart + MINTPOOL_BATCH_SIZE);
 
-    GroupElement commitmentValue;
-    sigma::PrivateCoin coin(sigma::Params::get_default(), sigma::CoinDenomination::SIGMA_DENOM_1);
-    if(!SeedToMint(mintSeed, commitmentValue, coin))
-        throw ZerocoinException("Unable to create sigmamint from seed in mint regeneration.");
+        // Entries of different master seeds are written separately to keep their hashSeedMaster
+        for (size_t nGroupStart = nBatchStart; nGroupStart < nBatchEnd; ) {
+            const uint160& mintHashSeedMaster = get<0>(entries[nGroupStart]);
 
-    uint256 hashPubcoin = primitives::GetPubCoinValueHash(commitmentValue);
-    uint256 hashSerial = primitives::GetSerialHash(coin.getSerialNumber());
+            std::vector<CDerivedMint> mints;
+            size_t nGroupEnd = nGroupStart;
+            for (; nGroupEnd < nBatchEnd && get<0>(entries[nGroupEnd]) == mintHashSeedMaster; ++nGroupEnd)
+                mints.emplace_back(get<2>(entries[nGroupEnd]), get<1>(entries[nGroupEnd]));
 
-    MintPoolEntry mintPoolEntry(mintHashSeedMaster, seedId, nCount);
-    mintPool.Add(make_pair(hashPubcoin, mintPoolEntry));
-    CWalletDB(strWalletFile).WritePubcoin(hashSerial, commitmentValue);
-    CWalletDB(strWalletFile).WriteMintPoolPair(hashPubcoin, mintPoolEntry);
-    LogPrintf("%s : hashSeedMaster=%s hashPubcoin=%s seedId=%s\n count=%d\n", __func__, hashSeedMaster.GetHex(), hashPubcoin.GetHex(), seedId.GetHex(), nCount);
+            DeriveMints(mints);
 
-    nIndexes.first = hashPubcoin;
-    nIndexes.second = hashSerial;
+            for (const CDerivedMint& mint : mints) {
+                if (!mint.fValid)
+                    throw ZerocoinException("Unable to create sigmamint from seed in mint regeneration.");
+                vIndexes.push_back(std::make_pair(mint.hashPubcoin, mint.hashSerial));
+            }
 
-    return nIndexes;
+            WriteMintPoolEntries(mintHashSeedMaster, mints);
+            nGroupStart = nGroupEnd;
+        }
+    }
 
+    return vIndexes;
 }
 
 /**
@@ -156,33 +174,86 @@ void CHDMintWallet::GenerateMintPool(int32_t nIndex)
     if(nIndex > 0 && nIndex >= nLastCount)
         nStop = nIndex + 20;
     LogPrintf("%s : nLastCount=%d nStop=%d\n", __func__, nLastCount, nStop - 1);
-    for (; nLastCount <= nStop; ++nLastCount) {
+    while (nLastCount <= nStop) {
         if (ShutdownRequested())
             return;
 
-        CKeyID seedId;
-        uint512 mintSeed;
-        if(!CreateMintSeed(mintSeed, nLastCount, seedId))
-            continue;
+        std::vector<CDerivedMint> mints;
+        for (; nLastCount <= nStop && mints.size() < MINTPOOL_BATCH_SIZE; ++nLastCount)
+            mints.emplace_back(nLastCount, CKeyID());
 
-        GroupElement commitmentValue;
-        sigma::PrivateCoin coin(sigma::Params::get_default(), sigma::CoinDenomination::SIGMA_DENOM_1);
-        if(!SeedToMint(mintSeed, commitmentValue, coin))
-            continue;
+        DeriveMints(mints);
+        WriteMintPoolEntries(hashSeedMaster, mints);
+
+        // Update local + DB entries for count last generated
+        nCountNextGenerate = nLastCount;
+        walletdb.WriteMintSeedCount(nCountNextGenerate);
+    }
+}
+
+/**
+ * Derive the mint seeds and mints for the given counts.
+ *
+ * Seeds are created sequentially, as this may need to generate new keys in the HD chain. Creating
+ * the mints from their seeds is the expensive part and is spread over the zerocoin thread pool.
+ * Entries for which any step fails are left with fValid unset.
+ *
+ * @param mints counts (and seed IDs, if known) of the mints to derive. Set in this function
+ */
+void CHDMintWallet::DeriveMints(std::vector<CDerivedMint>& mints)
+{
+    std::vector<CDerivedMint*> seeded;
+    for (CDerivedMint& mint : mints) {
+        if (CreateMintSeed(mint.mintSeed, mint.nCount, mint.seedId))
+            seeded.push_back(&mint);
+    }
 
-        uint256 hashPubcoin = primitives::GetPubCoinValueHash(commitmentValue);
+    // Params are lazily initialized and that isn't thread safe, get them before starting the tasks
+    const sigma::Params* params = sigma::Params::get_default();
+
+    size_t nTasks = std::min<size_t>(std::max(boost::thread::hardware_concurrency(), 1u), seeded.size());
+    libzerocoin::ParallelTasks tasks(nTasks);
+    for (size_t nTask = 0; nTask < nTasks; ++nTask) {
+        tasks.Add([this, params, &seeded, nTask, nTasks] {
+            for (size_t i = nTask; i < seeded.size(); i += nTasks) {
+                CDerivedMint& mint = *seeded[i];
+                sigma::PrivateCoin coin(params, sigma::CoinDenomination::SIGMA_DENOM_1);
+                if (!SeedToMint(mint.mintSeed, mint.commitmentValue, coin))
+                    continue;
 
-        MintPoolEntry mintPoolEntry(hashSeedMaster, seedId, nLastCount);
-        mintPool.Add(make_pair(hashPubcoin, mintPoolEntry));
-        CWalletDB(strWalletFile).WritePubcoin(primitives::GetSerialHash(coin.getSerialNumber()), commitmentValue);
-        CWalletDB(strWalletFile).WriteMintPoolPair(hashPubcoin, mintPoolEntry);
-        LogPrintf("%s : hashSeedMaster=%s hashPubcoin=%s seedId=%d count=%d\n", __func__, hashSeedMaster.GetHex(), hashPubcoin.GetHex(), seedId.GetHex(), nLastCount);
+                mint.hashPubcoin = primitives::GetPubCoinValueHash(mint.commitmentValue);
+                mint.hashSerial = primitives::GetSerialHash(coin.getSerialNumber());
+                mint.fValid = true;
+            }
+        });
     }
+    tasks.Wait();
+}
+
+/**
+ * Add derived mints to the mintpool and write them to the database in a single transaction.
+ *
+ * @param mintHashSeedMaster hash master seed of the mints
+ * @param mints mints created by DeriveMints. Invalid entries are skipped
+ */
+void CHDMintWallet::WriteMintPoolEntries(const uint160& mintHashSeedMaster, const std::vector<CDerivedMint>& mints)
+{
+    CWalletDB walletdb(strWalletFile);
+    bool fTxn = walletdb.TxnBegin();
 
-    // Update local + DB entries for count last generated
-    nCountNextGenerate = nLastCount;
-    walletdb.WriteMintSeedCount(nCountNextGenerate);
+    for (const CDerivedMint& mint : mints) {
+        if (!mint.fValid)
+            continue;
 
+        MintPoolEntry mintPoolEntry(mintHashSeedMaster, mint.seedId, mint.nCount);
+        mintPool.Add(make_pair(mint.hashPubcoin, mintPoolEntry));
+        walletdb.WritePubcoin(mint.hashSerial, mint.commitmentValue);
+        walletdb.WriteMintPoolPair(mint.hashPubcoin, mintPoolEntry);
+        LogPrintf("%s : hashSeedMaster=%s hashPubcoin=%s seedId=%s count=%d\n", __func__, mintHashSeedMaster.GetHex(), mint.hashPubcoin.GetHex(), mint.seedId.GetHex(), mint.nCount);
+    }
+
+    if (fTxn && !walletdb.TxnCommit())
+        LogPrintf("%s : failed to commit mintpool entries\n", __func__);
 }
 
 /**
@@ -241,6 +312,10 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
     bool found = true;
     CWalletDB walletdb(strWalletFile);
 
+    // Mints on chain by pubcoin hash, looked up once instead of searching the sigma state for every mintpool entry
+    std::map<uint256, int> mapMintHeights;
+    sigma::GetMintHeights(mapMintHeights);
+
     set<uint256> setAddedTx;
     std::set<uint256> setChecked;
     while (found) {
@@ -253,100 +328,123 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
             listMints = list<pair<uint256, MintPoolEntry>>();
             mintPool.List(listMints.get());
         }
+
+        // Group the mints found on chain by height, so that each block is read only once
+        std::map<int, std::map<uint256, std::pair<uint256, MintPoolEntry>>> mapPendingByHeight;
         for (pair<uint256, MintPoolEntry>& pMint : listMints.get()) {
             if (setChecked.count(pMint.first))
                 continue;
             setChecked.insert(pMint.first);
 
+            // halt processing if mint already in tracker
+            if (tracker.HasPubcoinHash(pMint.first))
+                continue;
+
+            auto itHeight = mapMintHeights.find(pMint.first);
+            if (itHeight == mapMintHeights.end())
+                continue;
+
+            mapPendingByHeight[itHeight->second].insert(std::make_pair(pMint.first, pMint));
+        }
+
+        for (auto& pending : mapPendingByHeight) {
             if (ShutdownRequested())
                 return;
 
-            uint160& mintHashSeedMaster = get<0>(pMint.second);
-            int32_t& mintCount = get<2>(pMint.second);
+            CBlockIndex* pindex;
+            {
+                LOCK(cs_main);
+                pindex = chainActive[pending.first];
+            }
 
-            // halt processing if mint already in tracker
-            if (tracker.HasPubcoinHash(pMint.first))
+            CBlock block;
+            if (!pindex || !ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+                LogPrintf("%s : failed to read block at height %d!\n", __func__, pending.first);
                 continue;
+            }
 
-            COutPoint outPoint;
-            if (sigma::GetOutPoint(outPoint, pMint.first)) {
-                const uint256& txHash = outPoint.hash;
-                //this mint has already occurred on the chain, increment counter's state to reflect this
-                LogPrintf("%s : Found wallet coin mint=%s count=%d tx=%s\n", __func__, pMint.first.GetHex(), mintCount, txHash.GetHex());
+            if (SyncMintsInBlock(block, pindex, pending.second, setAddedTx, walletdb))
                 found = true;
 
-                uint256 hashBlock;
-                CTransaction tx;
-                if (!GetTransaction(txHash, tx, Params().GetConsensus(), hashBlock, true)) {
-                    LogPrintf("%s : failed to get transaction for mint %s!\n", __func__, pMint.first.GetHex());
-                    found = false;
-                    continue;
-                }
+            for (const auto& missing : pending.second)
+                LogPrintf("%s : failed to get mint %s from block %s!\n", __func__, missing.first.GetHex(), pindex->GetBlockHash().GetHex());
+        }
 
-                //Find the denomination
-                boost::optional<sigma::CoinDenomination> denomination = boost::none;
-                bool fFoundMint = false;
-                GroupElement bnValue;
-                for (const CTxOut& out : tx.vout) {
-                    if (!out.scriptPubKey.IsSigmaMint())
-                        continue;
-
-                    sigma::PublicCoin pubcoin;
-                    CValidationState state;
-                    if (!TxOutToPublicCoin(out, pubcoin, state)) {
-                        LogPrintf("%s : failed to get mint from txout for %s!\n", __func__, pMint.first.GetHex());
-                        continue;
-                    }
-
-                    // See if this is the mint that we are looking for
-                    uint256 hashPubcoin = primitives::GetPubCoinValueHash(pubcoin.getValue());
-                    if (pMint.first == hashPubcoin) {
-                        denomination = pubcoin.getDenomination();
-                        bnValue = pubcoin.getValue();
-                        fFoundMint = true;
-                        break;
-                    }
-                }
+        // Clear listMints to allow it to be repopulated by the mintPool on the next iteration
+        if(found)
+            listMints = boost::none;
+    }
+}
 
-                if (!fFoundMint || denomination == boost::none) {
-                    LogPrintf("%s : failed to get mint %s from tx %s!\n", __func__, pMint.first.GetHex(), tx.GetHash().GetHex());
-                    found = false;
-                    break;
-                }
+/**
+ * Add the wallet mints of a block found by SyncWithChain to the wallet and the mint tracker.
+ *
+ * @param block block containing the mints
+ * @param pindex index of the block
+ * @param mapPending mintpool entries minted in this block, by pubcoin hash. Found entries are removed
+ * @param setAddedTx transactions already added to the wallet during this sync
+ * @param walletdb wallet database
+ * @return whether any mint was found
+ */
+bool CHDMintWallet::SyncMintsInBlock(const CBlock& block, const CBlockIndex* pindex, std::map<uint256, std::pair<uint256, MintPoolEntry>>& mapPending, std::set<uint256>& setAddedTx, CWalletDB& walletdb)
+{
+    bool found = false;
+    for (const CTransaction& tx : block.vtx) {
+        for (const CTxOut& out : tx.vout) {
+            if (mapPending.empty())
+                return found;
 
-                CBlockIndex* pindex = nullptr;
-                if (mapBlockIndex.count(hashBlock))
-                    pindex = mapBlockIndex.at(hashBlock);
-
-                if (!setAddedTx.count(txHash)) {
-                    CBlock block;
-                    CWalletTx wtx(pwalletMain, tx);
-                    if (pindex && ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
-                        LOCK(cs_main);
-                        wtx.SetMerkleBranch(block);
-                    }
-
-                    //Fill out wtx so that a transaction record can be created
-                    wtx.nTimeReceived = pindex->GetBlockTime();
-                    pwalletMain->AddToWallet(wtx, false, &walletdb);
-                    setAddedTx.insert(txHash);
-                }
+            if (!out.scriptPubKey.IsSigmaMint())
+                continue;
 
-                if(!SetMintSeedSeen(pMint, pindex->nHeight, txHash, denomination.get()))
-                    continue;
+            sigma::PublicCoin pubcoin;
+            CValidationState state;
+            if (!TxOutToPublicCoin(out, pubcoin, state)) {
+                LogPrintf("%s : failed to get mint from txout in tx %s!\n", __func__, tx.GetHash().GetHex());
+                continue;
+            }
+
+            auto it = mapPending.find(pubcoin.getValueHash());
+            if (it == mapPending.end())
+                continue;
+
+            std::pair<uint256, MintPoolEntry> pMint = it->second;
+            mapPending.erase(it);
+
+            const uint160& mintHashSeedMaster = get<0>(pMint.second);
+            int32_t mintCount = get<2>(pMint.second);
+            const uint256& txHash = tx.GetHash();
 
-                // Only update if the current hashSeedMaster matches the mints'
-                if(hashSeedMaster == mintHashSeedMaster && mintCount >= GetCount()){
-                    SetCount(++mintCount);
-                    UpdateCountDB();
-                    LogPrint("zero", "%s: updated count to %d\n", __func__, nCountNextUse);
+            //this mint has already occurred on the chain, increment counter's state to reflect this
+            LogPrintf("%s : Found wallet coin mint=%s count=%d tx=%s\n", __func__, pMint.first.GetHex(), mintCount, txHash.GetHex());
+            found = true;
+
+            if (!setAddedTx.count(txHash)) {
+                CWalletTx wtx(pwalletMain, tx);
+                {
+                    LOCK(cs_main);
+                    wtx.SetMerkleBranch(block);
                 }
+
+                //Fill out wtx so that a transaction record can be created
+                wtx.nTimeReceived = pindex->GetBlockTime();
+                pwalletMain->AddToWallet(wtx, false, &walletdb);
+                setAddedTx.insert(txHash);
+            }
+
+            if(!SetMintSeedSeen(pMint, pindex->nHeight, txHash, pubcoin.getDenomination()))
+                continue;
+
+            // Only update if the current hashSeedMaster matches the mints'
+            if(hashSeedMaster == mintHashSeedMaster && mintCount >= GetCount()){
+                SetCount(++mintCount);
+                UpdateCountDB();
+                LogPrint("zero", "%s: updated count to %d\n", __func__, nCountNextUse);
             }
         }
-        // Clear listMints to allow it to be repopulated by the mintPool on the next iteration
-        if(found)
-            listMints = boost::none;
     }
+
+    return found;
 }
 
 /**
@@ -18,6 +18,21 @@ class CHDMint;
 class CHDMintWallet
 {
 private:
+    /** A mint derived from the HD chain, see DeriveMints. */
+    struct CDerivedMint
+    {
+        int32_t nCount;
+        CKeyID seedId;
+        uint512 mintSeed;
+        bool fValid;
+        GroupElement commitmentValue;
+        uint256 hashPubcoin;
+        uint256 hashSerial;
+
+        CDerivedMint(int32_t nCount, const CKeyID& seedId) : nCount(nCount), seedId(seedId), fValid(false) {}
+    };
+
+
     int32_t nCountNextUse;
     int32_t nCountNextGenerate;
     std::string strWalletFile;
@@ -27,6 +42,8 @@ private:
 
 public:
     int static const COUNT_DEFAULT = 0;
+    // Number of mints derived and written to the wallet database at once
+    size_t static const MINTPOOL_BATCH_SIZE = 500;
 
     CHDMintWallet(const std::string& strWalletFile, bool resetCount=false);
 
@@ -40,6 +57,7 @@ public:
     bool IsSerialInBlockchain(const uint256& hashSerial, int& nHeightTx, uint256& txidSpend, CTransaction& tx);
     bool TxOutToPublicCoin(const CTxOut& txout, sigma::PublicCoin& pubCoin, CValidationState& state);
     std::pair<uint256,uint256> RegenerateMintPoolEntry(const uint160& mintHashSeedMaster, CKeyID& seedId, const int32_t& nCount);
+    std::vector<std::pair<uint256,uint256>> RegenerateMintPoolEntries(const std::vector<MintPoolEntry>& entries);
     void GenerateMintPool(int32_t nIndex = 0);
     bool SetMintSeedSeen(std::pair<uint256,MintPoolEntry> mintPoolEntryPair, const int& nHeight, const uint256& txid, const sigma::CoinDenomination& denom);
     bool SeedToMint(const uint512& mintSeed, GroupElement& bnValue, sigma::PrivateCoin& coin);
@@ -55,6 +73,9 @@ public:
 private:
     CKeyID GetMintSeedID(int32_t nCount);
     bool CreateMintSeed(uint512& mintSeed, const int32_t& n, CKeyID& seedId);
+    void DeriveMints(std::vector<CDerivedMint>& mints);
+    void WriteMintPoolEntries(const uint160& mintHashSeedMaster, const std::vector<CDerivedMint>& mints);
+    bool SyncMintsInBlock(const CBlock& block, const CBlockIndex* pindex, std::map<uint256, std::pair<uint256, MintPoolEntry>>& mapPending, std::set<uint256>& setAddedTx, CWalletDB& walletdb);
 };
 
 #endif //ZCOIN_HDMINTWALLET_H
@@ -186,9 +186,9 @@ class CCoinsViewErrorCatcher : public CCoinsViewBacked {
 public:
     CCoinsViewErrorCatcher(CCoinsView *view) : CCoinsViewBacked(view) {}
 
-    bool GetCoins(const uint256 &txid, CCoins &coins) const {
+    bool GetCoin(const COutPoint &outpoint, Coin &coin) const {
         try {
-            return CCoinsViewBacked::GetCoins(txid, coins);
+            return CCoinsViewBacked::GetCoin(outpoint, coin);
         } catch (const std::runtime_error &e) {
             uiInterface.ThreadSafeMessageBox(_("Error reading from database, shutting down."), "",
                                              CClientUIInterface::MSG_ERROR);
@@ -242,6 +242,13 @@ void PrepareShutdown(){
     StopHTTPServer();
 #ifdef ENABLE_CLIENTAPI
     StopAPI();
+
+    // Joins the publisher thread, whose queued publishes read the chain state and the mint wallet torn down below
+    if (pzmqPublisherInterface) {
+        UnregisterValidationInterface(pzmqPublisherInterface);
+        delete pzmqPublisherInterface;
+        pzmqPublisherInterface = NULL;
+    }
 #endif
 
 #ifdef ENABLE_WALLET
@@ -302,12 +309,6 @@ void PrepareShutdown(){
 #endif
 
 #ifdef ENABLE_CLIENTAPI
-    if (pzmqPublisherInterface) {
-        UnregisterValidationInterface(pzmqPublisherInterface);
-        delete pzmqPublisherInterface;
-        pzmqPublisherInterface = NULL;
-    }
-
     if (pzmqReplierInterface) {
         pzmqReplierInterface->Shutdown();
     }
@@ -456,6 +457,7 @@ std::string HelpMessage(HelpMessageMode mode) {
             _("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)"),
             DEFAULT_TXINDEX));
     strUsage += HelpMessageOpt("-addressindex", strprintf(_("Maintain a full address index, used to query for the balance, txids and unspent outputs for addresses (default: %u)"), DEFAULT_ADDRESSINDEX));
+    strUsage += HelpMessageOpt("-addressbalanceindex", strprintf(_("Maintain running balance totals for every address, used by getaddressbalance. Requires -addressindex (default: %u)"), DEFAULT_ADDRESSBALANCEINDEX));
     strUsage += HelpMessageOpt("-timestampindex", strprintf(_("Maintain a timestamp index for block hashes, used to query blocks hashes by a range of timestamps (default: %u)"), DEFAULT_TIMESTAMPINDEX));
     strUsage += HelpMessageOpt("-spentindex", strprintf(_("Maintain a full spent index, used to query the spending txid and input index for an outpoint (default: %u)"), DEFAULT_SPENTINDEX));
 
@@ -598,7 +600,7 @@ std::string HelpMessage(HelpMessageMode mode) {
         strUsage += HelpMessageOpt("-bip9params=deployment:start:end",
                                    "Use given start/end times for specified bip9 deployment (regtest-only)");
     }
-    string debugCategories = "addrman, alert, bench, cmpctblock, coindb, db, http, libevent, lock, mempool, mempoolrej, net, proxy, prune, rand, reindex, rpc, selectcoins, tor, zmq"; // Don't translate these and qt below
+    string debugCategories = "addrman, alert, api, bench, cmpctblock, coindb, db, http, libevent, lock, mempool, mempoolrej, miner, net, proxy, prune, rand, reindex, rpc, selectcoins, tor, zmq"; // Don't translate these and qt below
     if (mode == HMM_BITCOIN_QT)
         debugCategories += ", qt";
     strUsage += HelpMessageOpt("-debug=<category>", strprintf(
@@ -700,6 +702,9 @@ std::string HelpMessage(HelpMessageMode mode) {
     strUsage += HelpMessageOpt("-rpcthreads=<n>",
                                strprintf(_("Set the number of threads to service RPC calls (default: %d)"),
                                          DEFAULT_HTTP_THREADS));
+#ifdef ENABLE_CLIENTAPI
+    strUsage += HelpMessageOpt("-apiworkers=<n>", strprintf(_("Set the number of threads to service client API calls on each API port (default: %d)"), DEFAULT_API_WORKERS));
+#endif
     strUsage += HelpMessageOpt("-blockspamfilter=<n>", strprintf(_("Use block spam filter (default: %u)"), DEFAULT_BLOCK_SPAM_FILTER));
     strUsage += HelpMessageOpt("-blockspamfiltermaxsize=<n>", strprintf(_("Maximum size of the list of indexes in the block spam filter (default: %u)"), DEFAULT_BLOCK_SPAM_FILTER_MAX_SIZE));
     strUsage += HelpMessageOpt("-blockspamfiltermaxavg=<n>", strprintf(_("Maximum average size of an index occurrence in the block spam filter (default: %u)"), DEFAULT_BLOCK_SPAM_FILTER_MAX_AVG));
@@ -1236,6 +1241,9 @@ bool AppInit2(boost::thread_group &threadGroup, CScheduler &scheduler) {
 #endif
     }
 
+    if (GetBoolArg("-addressbalanceindex", DEFAULT_ADDRESSBALANCEINDEX) && !GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX))
+        return InitError(_("-addressbalanceindex requires -addressindex."));
+
     // Make sure enough file descriptors are available
     int nBind = std::max(
             (mapMultiArgs.count("-bind") ? mapMultiArgs.at("-bind").size() : 0) +
@@ -1778,8 +1786,7 @@ bool AppInit2(boost::thread_group &threadGroup, CScheduler &scheduler) {
                                     (nTotalCache / 4) + (1 << 23)); // use 25%-50% of the remainder for disk cache
     nCoinDBCache = std::min(nCoinDBCache, nMaxCoinsDBCache << 20); // cap total coins db cache
     nTotalCache -= nCoinDBCache;
-//    nCoinCacheUsage = nTotalCache; // the rest goes to in-memory cache
-    nCoinCacheUsage = nTotalCache / 300;
+    nCoinCacheUsage = nTotalCache; // the rest goes to in-memory cache
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1fMiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
@@ -1817,6 +1824,11 @@ bool AppInit2(boost::thread_group &threadGroup, CScheduler &scheduler) {
                 pcoinsdbview = new CCoinsViewDB(nCoinDBCache, false, fReindex || fReindexChainState);
                 pcoinscatcher = new CCoinsViewErrorCatcher(pcoinsdbview);
                 pcoinsTip = new CCoinsViewCache(pcoinscatcher);
+                // Convert the per-transaction records of older versions before anything reads the coins
+                if (!pcoinsdbview->Upgrade()) {
+                    strLoadError = _("Error upgrading chainstate database");
+                    break;
+                }
                 LogPrintf("fReindex = %s\n", fReindex);
                 if (fReindex) {
                     pblocktree->WriteReindexing(true);
@@ -11,6 +11,7 @@
  **/
 
 #include "Zerocoin.h"
+#include "ModExp.h"
 
 namespace libzerocoin {
 
@@ -144,37 +145,44 @@ namespace libzerocoin {
 
         Bignum c = Bignum(hasher.GetHash()); //this hash should be of length k_prime bits
 
-        Bignum st_1_prime = (valueOfCommitmentToCoin.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) *
-                             sg.pow_mod(s_alpha, params->accumulatorPoKCommitmentGroup.modulus) *
-                             sh.pow_mod(s_phi, params->accumulatorPoKCommitmentGroup.modulus)) %
-                            params->accumulatorPoKCommitmentGroup.modulus;
-        Bignum st_2_prime = (sg.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) * ((valueOfCommitmentToCoin *
-                                                                                              sg.inverse(
-                                                                                                      params->accumulatorPoKCommitmentGroup.modulus)).pow_mod(
-                s_gamma, params->accumulatorPoKCommitmentGroup.modulus)) *
-                             sh.pow_mod(s_psi, params->accumulatorPoKCommitmentGroup.modulus)) %
-                            params->accumulatorPoKCommitmentGroup.modulus;
-        Bignum st_3_prime = (sg.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) *
-                             (sg * valueOfCommitmentToCoin).pow_mod(s_sigma,
-                                                                    params->accumulatorPoKCommitmentGroup.modulus) *
-                             sh.pow_mod(s_xi, params->accumulatorPoKCommitmentGroup.modulus)) %
-                            params->accumulatorPoKCommitmentGroup.modulus;
+        // The generators have precomputed powers, h_n^-1 and g_n^-1 are their powers with negative exponents
+        const Bignum& pokModulus = params->accumulatorPoKCommitmentGroup.modulus;
+        auto pokModExp = MontgomeryModulus::Get(pokModulus);
+        auto sgModExp = FixedBaseModExp::Get(sg, pokModulus);
+        auto shModExp = FixedBaseModExp::Get(sh, pokModulus);
+
+        auto accModExp = MontgomeryModulus::Get(params->accumulatorModulus);
+        auto gnModExp = FixedBaseModExp::Get(g_n, params->accumulatorModulus);
+        auto hnModExp = FixedBaseModExp::Get(h_n, params->accumulatorModulus);
+
+        Bignum st_1_prime = (pokModExp->pow(valueOfCommitmentToCoin, c) *
+                             sgModExp->pow(s_alpha) *
+                             shModExp->pow(s_phi)) %
+                            pokModulus;
+        Bignum st_2_prime = (sgModExp->pow(c) *
+                             pokModExp->pow(valueOfCommitmentToCoin * sg.inverse(pokModulus), s_gamma) *
+                             shModExp->pow(s_psi)) %
+                            pokModulus;
+        Bignum st_3_prime = (sgModExp->pow(c) *
+                             pokModExp->pow(sg * valueOfCommitmentToCoin, s_sigma) *
+                             shModExp->pow(s_xi)) %
+                            pokModulus;
 
         Bignum t_1_prime =
-                (C_r.pow_mod(c, params->accumulatorModulus) * h_n.pow_mod(s_zeta, params->accumulatorModulus) *
-                 g_n.pow_mod(s_epsilon, params->accumulatorModulus)) % params->accumulatorModulus;
+                (accModExp->pow(C_r, c) * hnModExp->pow(s_zeta) *
+                 gnModExp->pow(s_epsilon)) % params->accumulatorModulus;
         Bignum t_2_prime =
-                (C_e.pow_mod(c, params->accumulatorModulus) * h_n.pow_mod(s_eta, params->accumulatorModulus) *
-                 g_n.pow_mod(s_alpha, params->accumulatorModulus)) % params->accumulatorModulus;
+                (accModExp->pow(C_e, c) * hnModExp->pow(s_eta) *
+                 gnModExp->pow(s_alpha)) % params->accumulatorModulus;
 
-        Bignum t_3_prime = ((a.getValue()).pow_mod(c, params->accumulatorModulus) *
-                            C_u.pow_mod(s_alpha, params->accumulatorModulus) *
-                            ((h_n.inverse(params->accumulatorModulus)).pow_mod(s_beta, params->accumulatorModulus))) %
+        // a and C_u are both variable bases, they share the squarings
+        Bignum t_3_prime = (accModExp->pow({a.getValue(), C_u}, {c, s_alpha}) *
+                            hnModExp->pow(s_beta * -1)) %
                            params->accumulatorModulus;
 
-        Bignum t_4_prime = (C_r.pow_mod(s_alpha, params->accumulatorModulus) *
-                            ((h_n.inverse(params->accumulatorModulus)).pow_mod(s_delta, params->accumulatorModulus)) *
-                            ((g_n.inverse(params->accumulatorModulus)).pow_mod(s_beta, params->accumulatorModulus))) %
+        Bignum t_4_prime = (accModExp->pow(C_r, s_alpha) *
+                            hnModExp->pow(s_delta * -1) *
+                            gnModExp->pow(s_beta * -1)) %
                            params->accumulatorModulus;
 
         bool result = false;
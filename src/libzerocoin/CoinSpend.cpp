@@ -97,14 +97,21 @@ CoinDenomination CoinSpend::getDenomination() const {
 }
 
 bool CoinSpend::Verify(const Accumulator& a, const SpendMetaData &m) const {
+    return VerifyWithoutAccumulator(m) && VerifyAccumulator(a);
+}
+
+bool CoinSpend::VerifyAccumulator(const Accumulator& a) const {
+    return (a.getDenomination() == this->denomination)
+                && accumulatorPoK.Verify(a, accCommitmentToCoinValue);
+}
+
+bool CoinSpend::VerifyWithoutAccumulator(const SpendMetaData &m) const {
     if (!HasValidSerial())
         return false;
 
 	uint256 metahash = signatureHash(m);
-	// Verify both of the sub-proofs using the given meta-data
-    int ret = (a.getDenomination() == this->denomination)
-                && commitmentPoK.Verify(serialCommitmentToCoinValue, accCommitmentToCoinValue)
-                && accumulatorPoK.Verify(a, accCommitmentToCoinValue)
+	// Verify the sub-proofs that don't involve the accumulator using the given meta-data
+    int ret = commitmentPoK.Verify(serialCommitmentToCoinValue, accCommitmentToCoinValue)
                 && serialNumberSoK.Verify(coinSerialNumber, serialCommitmentToCoinValue, this->version == ZEROCOIN_TX_VERSION_1_5 ? metahash : uint256());
     if (!ret) {
             return false;
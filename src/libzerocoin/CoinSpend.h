@@ -110,6 +110,14 @@ public:
 	bool HasValidSerial() const;
 	bool Verify(const Accumulator& a, const SpendMetaData &metaData) const;
 
+	/** The two halves of Verify. The proofs that don't depend on the accumulator only need to be
+	 * verified once when the spend is checked against several candidate accumulator values.
+	 *
+	 * @return Verify(a, metaData) is VerifyWithoutAccumulator(metaData) && VerifyAccumulator(a)
+	 */
+	bool VerifyWithoutAccumulator(const SpendMetaData &metaData) const;
+	bool VerifyAccumulator(const Accumulator& a) const;
+
 	ADD_SERIALIZE_METHODS;
 	template <typename Stream, typename Operation>
 	inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
@@ -0,0 +1,236 @@
+/**
+* @file       ModExp.cpp
+*
+* @brief      Modular exponentiation with fixed moduli and bases for the Zerocoin library.
+*
+* @copyright  Copyright 2020 The ShroudX developers
+* @license    This project is released under the MIT license.
+**/
+
+#include "Zerocoin.h"
+#include "ModExp.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace libzerocoin {
+
+MontgomeryModulus::MontgomeryModulus(const CBigNum& modulus) : modulus(modulus), mont(NULL) {
+    if (!BN_is_odd(&modulus))
+        return;
+
+    CAutoBN_CTX pctx;
+    mont = BN_MONT_CTX_new();
+    if (mont == NULL || !BN_MONT_CTX_set(mont, &modulus, pctx)) {
+        BN_MONT_CTX_free(mont);
+        throw bignum_error("MontgomeryModulus : BN_MONT_CTX_set failed");
+    }
+}
+
+MontgomeryModulus::~MontgomeryModulus() {
+    BN_MONT_CTX_free(mont);
+}
+
+CBigNum MontgomeryModulus::pow(const CBigNum& base, const CBigNum& exponent) const {
+    if (mont == NULL)
+        return base.pow_mod(exponent, modulus);
+
+    CAutoBN_CTX pctx;
+    CBigNum ret;
+    if (exponent < 0) {
+        // g^-x = (g^-1)^x
+        CBigNum inv = base.inverse(modulus);
+        CBigNum posE = exponent * -1;
+        if (!BN_mod_exp_mont(&ret, &inv, &posE, &modulus, pctx, mont))
+            throw bignum_error("MontgomeryModulus::pow : BN_mod_exp_mont failed on negative exponent");
+    } else if (!BN_mod_exp_mont(&ret, &base, &exponent, &modulus, pctx, mont)) {
+        throw bignum_error("MontgomeryModulus::pow : BN_mod_exp_mont failed");
+    }
+
+    return ret;
+}
+
+CBigNum MontgomeryModulus::pow(const std::vector<CBigNum>& bases, const std::vector<CBigNum>& exponents) const {
+    if (bases.size() != exponents.size())
+        throw std::invalid_argument("MontgomeryModulus::pow : bases and exponents differ in size");
+
+    if (mont == NULL) {
+        CBigNum ret = 1;
+        for (size_t i = 0; i < bases.size(); i++)
+            ret = ret * bases[i].pow_mod(exponents[i], modulus) % modulus;
+        return ret;
+    }
+
+    CAutoBN_CTX pctx;
+    const int tableSize = 1 << MULTI_WINDOW_BITS;
+
+    // tables[i][d] is the Montgomery form of bases[i]^d, or of (bases[i]^-1)^d for a negative exponent
+    std::vector<std::vector<CBigNum>> tables(bases.size());
+    std::vector<CBigNum> absExponents(bases.size());
+    int nBits = 0;
+    for (size_t i = 0; i < bases.size(); i++) {
+        absExponents[i] = exponents[i] < 0 ? exponents[i] * -1 : exponents[i];
+        if (absExponents[i] == 0)
+            continue;
+        nBits = std::max(nBits, absExponents[i].bitSize());
+
+        CBigNum power = bases[i] % modulus;
+        if (power < 0)
+            power += modulus;
+        if (exponents[i] < 0 && !BN_mod_inverse(&power, &power, &modulus, pctx))
+            throw bignum_error("MontgomeryModulus::pow : BN_mod_inverse failed");
+        if (!BN_to_montgomery(&power, &power, mont, pctx))
+            throw bignum_error("MontgomeryModulus::pow : BN_to_montgomery failed");
+
+        std::vector<CBigNum>& table = tables[i];
+        table.resize(tableSize);
+        table[1] = power;
+        for (int d = 2; d < tableSize; d++) {
+            if (!BN_mod_mul_montgomery(&table[d], &table[d - 1], &power, mont, pctx))
+                throw bignum_error("MontgomeryModulus::pow : BN_mod_mul_montgomery failed");
+        }
+    }
+
+    // Walk the exponents a window at a time from the top, squaring the accumulated product once per bit for all
+    // the bases together
+    CBigNum ret;
+    bool fOne = true;
+    for (int window = (nBits + MULTI_WINDOW_BITS - 1) / MULTI_WINDOW_BITS - 1; window >= 0; window--) {
+        if (!fOne) {
+            for (int j = 0; j < MULTI_WINDOW_BITS; j++) {
+                if (!BN_mod_mul_montgomery(&ret, &ret, &ret, mont, pctx))
+                    throw bignum_error("MontgomeryModulus::pow : BN_mod_mul_montgomery failed");
+            }
+        }
+
+        for (size_t i = 0; i < bases.size(); i++) {
+            if (tables[i].empty())
+                continue;
+            int digit = 0;
+            for (int j = MULTI_WINDOW_BITS - 1; j >= 0; j--)
+                digit = (digit << 1) | BN_is_bit_set(&absExponents[i], window * MULTI_WINDOW_BITS + j);
+            if (digit == 0)
+                continue;
+            if (fOne)
+                ret = tables[i][digit];
+            else if (!BN_mod_mul_montgomery(&ret, &ret, &tables[i][digit], mont, pctx))
+                throw bignum_error("MontgomeryModulus::pow : BN_mod_mul_montgomery failed");
+            fOne = false;
+        }
+    }
+
+    if (fOne)
+        return CBigNum(1) % modulus;
+    if (!BN_from_montgomery(&ret, &ret, mont, pctx))
+        throw bignum_error("MontgomeryModulus::pow : BN_from_montgomery failed");
+    return ret;
+}
+
+std::shared_ptr<const MontgomeryModulus> MontgomeryModulus::Get(const CBigNum& modulus) {
+    static std::mutex cs;
+    static std::map<CBigNum, std::shared_ptr<const MontgomeryModulus>> moduli;
+
+    std::lock_guard<std::mutex> lock(cs);
+    std::shared_ptr<const MontgomeryModulus>& ret = moduli[modulus];
+    if (!ret)
+        ret = std::make_shared<const MontgomeryModulus>(modulus);
+    return ret;
+}
+
+FixedBaseModExp::FixedBaseModExp(const CBigNum& base, std::shared_ptr<const MontgomeryModulus> modulus, int maxExponentBits,
+                                 bool fNegativeExponents)
+    : base(base), modulus(modulus) {
+    if (modulus->mont == NULL)
+        return;
+
+    CAutoBN_CTX pctx;
+    const CBigNum& m = modulus->getModulus();
+    if (!BN_to_montgomery(&one, BN_value_one(), modulus->mont, pctx))
+        throw bignum_error("FixedBaseModExp : BN_to_montgomery failed");
+
+    // base^(2^(w*i)) and (base^-1)^(2^(w*i)), each one is the previous one squared w times. The second table is
+    // left empty if base has no inverse or it isn't needed
+    size_t nWindows = (maxExponentBits + WINDOW_BITS - 1) / WINDOW_BITS;
+    for (std::vector<CBigNum>* table : {&powers, &inversePowers}) {
+        CBigNum power = base % m;
+        if (power < 0)
+            power += m;
+        if (table == &inversePowers && (!fNegativeExponents || !BN_mod_inverse(&power, &power, &m, pctx)))
+            break;
+        if (!BN_to_montgomery(&power, &power, modulus->mont, pctx))
+            throw bignum_error("FixedBaseModExp : BN_to_montgomery failed");
+
+        table->reserve(nWindows);
+        for (size_t i = 0; i < nWindows; i++) {
+            table->push_back(power);
+            for (int j = 0; j < WINDOW_BITS; j++) {
+                if (!BN_mod_mul_montgomery(&power, &power, &power, modulus->mont, pctx))
+                    throw bignum_error("FixedBaseModExp : BN_mod_mul_montgomery failed");
+            }
+        }
+    }
+}
+
+CBigNum FixedBaseModExp::PowWithTable(const std::vector<CBigNum>& table, const CBigNum& exponent) const {
+    // Split the exponent into w bit digits
+    int nBits = exponent.bitSize();
+    std::vector<int> digits((nBits + WINDOW_BITS - 1) / WINDOW_BITS, 0);
+    for (int bit = 0; bit < nBits; bit++) {
+        if (BN_is_bit_set(&exponent, bit))
+            digits[bit / WINDOW_BITS] |= 1 << (bit % WINDOW_BITS);
+    }
+
+    // product over d of (product of the table entries with digit d)^d, computed as a running product of the
+    // running products, highest digit first
+    CAutoBN_CTX pctx;
+    CBigNum a = one, b = one;
+    bool fOneA = true, fOneB = true;
+    for (int d = (1 << WINDOW_BITS) - 1; d > 0; d--) {
+        for (size_t i = 0; i < digits.size(); i++) {
+            if (digits[i] != d)
+                continue;
+            if (fOneB)
+                b = table[i];
+            else if (!BN_mod_mul_montgomery(&b, &b, &table[i], modulus->mont, pctx))
+                throw bignum_error("FixedBaseModExp::pow : BN_mod_mul_montgomery failed");
+            fOneB = false;
+        }
+
+        if (fOneB)
+            continue;
+        if (fOneA)
+            a = b;
+        else if (!BN_mod_mul_montgomery(&a, &a, &b, modulus->mont, pctx))
+            throw bignum_error("FixedBaseModExp::pow : BN_mod_mul_montgomery failed");
+        fOneA = false;
+    }
+
+    CBigNum ret;
+    if (!BN_from_montgomery(&ret, &a, modulus->mont, pctx))
+        throw bignum_error("FixedBaseModExp::pow : BN_from_montgomery failed");
+    return ret;
+}
+
+CBigNum FixedBaseModExp::pow(const CBigNum& exponent) const {
+    const std::vector<CBigNum>& table = exponent < 0 ? inversePowers : powers;
+    if (table.empty() || exponent.bitSize() > (int)table.size() * WINDOW_BITS)
+        return modulus->pow(base, exponent);
+
+    return PowWithTable(table, exponent < 0 ? exponent * -1 : exponent);
+}
+
+std::shared_ptr<const FixedBaseModExp> FixedBaseModExp::Get(const CBigNum& base, const CBigNum& modulus) {
+    static std::mutex cs;
+    static std::map<std::pair<CBigNum, CBigNum>, std::shared_ptr<const FixedBaseModExp>> bases;
+
+    std::lock_guard<std::mutex> lock(cs);
+    std::shared_ptr<const FixedBaseModExp>& ret = bases[std::make_pair(base, modulus)];
+    if (!ret)
+        ret = std::make_shared<const FixedBaseModExp>(base, MontgomeryModulus::Get(modulus), modulus.bitSize() + 1024);
+    return ret;
+}
+
+} // namespace libzerocoin
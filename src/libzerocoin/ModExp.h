@@ -0,0 +1,91 @@
+/**
+* @file       ModExp.h
+*
+* @brief      Modular exponentiation with fixed moduli and bases for the Zerocoin library.
+*
+* @copyright  Copyright 2020 The ShroudX developers
+* @license    This project is released under the MIT license.
+**/
+
+#ifndef MODEXP_H
+#define MODEXP_H
+
+#include "Zerocoin.h"
+
+#include <memory>
+#include <vector>
+
+namespace libzerocoin {
+
+/**
+ * Modulus of one of the parameter groups. The Montgomery context of the modulus is computed once instead of
+ * on every exponentiation. Instances are immutable and can be used from several threads at once
+ */
+class MontgomeryModulus {
+public:
+    explicit MontgomeryModulus(const CBigNum& modulus);
+    ~MontgomeryModulus();
+
+    const CBigNum& getModulus() const { return modulus; }
+
+    // base^exponent mod modulus, the same result as base.pow_mod(exponent, modulus)
+    CBigNum pow(const CBigNum& base, const CBigNum& exponent) const;
+
+    // product of bases[i]^exponents[i] mod modulus. All the exponentiations share one chain of squarings
+    // (Straus/Shamir), a product of k powers costs about as many squarings as the longest exponent instead of k
+    // times as many
+    CBigNum pow(const std::vector<CBigNum>& bases, const std::vector<CBigNum>& exponents) const;
+
+    // shared instance for the modulus, created on first use
+    static std::shared_ptr<const MontgomeryModulus> Get(const CBigNum& modulus);
+
+private:
+    friend class FixedBaseModExp;
+
+    // window of the simultaneous exponentiation, each base gets a table of its first 2^w - 1 powers
+    static const int MULTI_WINDOW_BITS = 4;
+
+    CBigNum modulus;
+    // NULL for even moduli, which Montgomery multiplication doesn't support
+    BN_MONT_CTX* mont;
+
+    MontgomeryModulus(const MontgomeryModulus&) = delete;
+    MontgomeryModulus& operator=(const MontgomeryModulus&) = delete;
+};
+
+/**
+ * Exponentiation of a fixed base, used for the group generators. base^(2^(w*i)) and the same powers of the
+ * inverse of base are precomputed, an exponentiation then takes about one multiplication per w bits of the
+ * exponent instead of a squaring per bit (Brickell, Gordon, McCurley and Wilson). Exponents longer than the
+ * tables fall back to MontgomeryModulus::pow
+ */
+class FixedBaseModExp {
+public:
+    // fNegativeExponents = false leaves out the table of the inverse, negative exponents then fall back to
+    // MontgomeryModulus::pow
+    FixedBaseModExp(const CBigNum& base, std::shared_ptr<const MontgomeryModulus> modulus, int maxExponentBits,
+                    bool fNegativeExponents = true);
+
+    // base^exponent mod modulus, the same result as base.pow_mod(exponent, modulus)
+    CBigNum pow(const CBigNum& exponent) const;
+
+    // shared instance for the base and modulus, created on first use with tables for exponents up to 1024 bits
+    // longer than the modulus, enough for the responses of all the proofs
+    static std::shared_ptr<const FixedBaseModExp> Get(const CBigNum& base, const CBigNum& modulus);
+
+private:
+    static const int WINDOW_BITS = 5;
+
+    CBigNum base;
+    std::shared_ptr<const MontgomeryModulus> modulus;
+    // Montgomery form of 1 and the tables, empty if the modulus is even
+    CBigNum one;
+    std::vector<CBigNum> powers;
+    std::vector<CBigNum> inversePowers;
+
+    CBigNum PowWithTable(const std::vector<CBigNum>& table, const CBigNum& exponent) const;
+};
+
+} // namespace libzerocoin
+
+#endif // MODEXP_H
@@ -25,7 +25,9 @@
 #include <vector>
 #include <list>
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <memory>
 
 namespace libzerocoin {
 
@@ -137,17 +139,39 @@ public:
 
 // High level API to create number of parallel tasks and wait for completion
 
+// Task of one ParallelTasks object, run either by the pool or by Wait(), whichever gets to it first
+struct ParallelTasks::Task {
+    boost::packaged_task<void> job;
+    boost::future<void> result;
+    std::atomic<bool> fStarted;
+
+    explicit Task(function<void()> task) : job(std::move(task)), result(job.get_future()), fStarted(false) {}
+
+    void Run() {
+        if (!fStarted.exchange(true))
+            job();
+    }
+};
+
 ParallelTasks::ParallelTasks(int n) {
     tasks.reserve(n);
 }
 
 void ParallelTasks::Add(function<void()> task) {
-    tasks.push_back(s_parallelOpThreadPool.PostTask(std::move(task)));
+    std::shared_ptr<Task> t = std::make_shared<Task>(std::move(task));
+    tasks.push_back(t);
+    s_parallelOpThreadPool.PostTask([t]() { t->Run(); });
 }
 
 void ParallelTasks::Wait() {
-    for (boost::future<void> &f: tasks)
-        f.get();
+    // Run the tasks the pool hasn't started yet on the calling thread. Tasks running on the pool may create and
+    // wait for tasks of their own, without this they could block all the pool threads. Only the tasks added here
+    // are run, the pool is shared with unrelated work that shouldn't end up on this thread
+    for (std::shared_ptr<Task> &t: tasks)
+        t->Run();
+
+    for (std::shared_ptr<Task> &t: tasks)
+        t->result.get();
 }
 
 void ParallelTasks::Reset() {
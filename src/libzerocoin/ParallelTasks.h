@@ -19,6 +19,7 @@
 
 #include <vector>
 #include <functional>
+#include <memory>
 
 #define BOOST_THREAD_PROVIDES_FUTURE
 
@@ -30,7 +31,8 @@ namespace libzerocoin {
 
 class ParallelTasks {
 private:
-    vector<boost::future<void>> tasks;
+    struct Task;
+    std::vector<std::shared_ptr<Task>> tasks;
 
 public:
     ParallelTasks(int n=0);
@@ -38,7 +40,7 @@ public:
     // add new task
     void Add(std::function<void()> task);
 
-    // wait for everything added so far
+    // wait for everything added so far, running the ones not started yet on the calling thread
     void Wait();
 
     // clear all the tasks from the waiting list
@@ -11,6 +11,7 @@
 **/
 
 #include "Zerocoin.h"
+#include "ModExp.h"
 #include "ParallelTasks.h"
 
 namespace libzerocoin {
@@ -98,15 +99,14 @@ SerialNumberSignatureOfKnowledge::SerialNumberSignatureOfKnowledge(const Params*
 inline Bignum SerialNumberSignatureOfKnowledge::challengeCalculation(const Bignum& a_exp,const Bignum& b_exp,
         const Bignum& h_exp) const {
 
-	Bignum a = params->coinCommitmentGroup.g;
-	Bignum b = params->coinCommitmentGroup.h;
-	Bignum g = params->serialNumberSoKCommitmentGroup.g;
-	Bignum h = params->serialNumberSoKCommitmentGroup.h;
+	const IntegerGroupParams& sokGroup = params->serialNumberSoKCommitmentGroup;
 
-	Bignum exponent = (a.pow_mod(a_exp, params->serialNumberSoKCommitmentGroup.groupOrder)
-	                   * b.pow_mod(b_exp, params->serialNumberSoKCommitmentGroup.groupOrder)) % params->serialNumberSoKCommitmentGroup.groupOrder;
+	// All the bases are generators, their powers are precomputed
+	Bignum exponent = (FixedBaseModExp::Get(params->coinCommitmentGroup.g, sokGroup.groupOrder)->pow(a_exp)
+	                   * FixedBaseModExp::Get(params->coinCommitmentGroup.h, sokGroup.groupOrder)->pow(b_exp)) % sokGroup.groupOrder;
 
-	return (g.pow_mod(exponent, params->serialNumberSoKCommitmentGroup.modulus) * h.pow_mod(h_exp, params->serialNumberSoKCommitmentGroup.modulus)) % params->serialNumberSoKCommitmentGroup.modulus;
+	return (FixedBaseModExp::Get(sokGroup.g, sokGroup.modulus)->pow(exponent)
+	        * FixedBaseModExp::Get(sokGroup.h, sokGroup.modulus)->pow(h_exp)) % sokGroup.modulus;
 }
 
 bool SerialNumberSignatureOfKnowledge::Verify(const Bignum& coinSerialNumber, const Bignum& valueOfCommitmentToCoin,
@@ -114,10 +114,9 @@ bool SerialNumberSignatureOfKnowledge::Verify(const Bignum& coinSerialNumber, co
 
     ParallelTasks::DoNotDisturb dnd;
 
-	Bignum a = params->coinCommitmentGroup.g;
-	Bignum b = params->coinCommitmentGroup.h;
-	Bignum g = params->serialNumberSoKCommitmentGroup.g;
-	Bignum h = params->serialNumberSoKCommitmentGroup.h;
+	auto b = FixedBaseModExp::Get(params->coinCommitmentGroup.h, params->serialNumberSoKCommitmentGroup.groupOrder);
+	auto h = FixedBaseModExp::Get(params->serialNumberSoKCommitmentGroup.h, params->serialNumberSoKCommitmentGroup.modulus);
+	auto sokModulus = MontgomeryModulus::Get(params->serialNumberSoKCommitmentGroup.modulus);
 
 	// Make sure that the serial number has a unique representation
 	if (coinSerialNumber < 0 || coinSerialNumber >= params->coinCommitmentGroup.groupOrder){
@@ -130,22 +129,26 @@ bool SerialNumberSignatureOfKnowledge::Verify(const Bignum& coinSerialNumber, co
     if (!msghash.IsNull())
         hasher << msghash;
 
+	// valueOfCommitmentToCoin is raised to a different power in every challenge with a zero bit, its squarings
+	// are computed once for all of them. The exponents are reduced modulo the group order
+	FixedBaseModExp value(valueOfCommitmentToCoin, sokModulus,
+	                      params->serialNumberSoKCommitmentGroup.groupOrder.bitSize(), false);
+
 	vector<CBigNum> tprime(params->zkp_iterations);
 	unsigned char *hashbytes = (unsigned char*) &this->hash;
 
     ParallelTasks challenges(params->zkp_iterations);
 
 	for(uint32_t i = 0; i < params->zkp_iterations; i++) {
-        challenges.Add([this, i, hashbytes, &b, &h, &tprime, &coinSerialNumber, &valueOfCommitmentToCoin] {
+        challenges.Add([this, i, hashbytes, &b, &h, &value, &tprime, &coinSerialNumber] {
             int bit = i % 8;
             int byte = i / 8;
             bool challenge_bit = ((hashbytes[byte] >> bit) & 0x01);
             if(challenge_bit) {
                 tprime[i] = challengeCalculation(coinSerialNumber, s_notprime[i], sprime[i]);
             } else {
-                Bignum exp = b.pow_mod(s_notprime[i], params->serialNumberSoKCommitmentGroup.groupOrder);
-                tprime[i] = ((valueOfCommitmentToCoin.pow_mod(exp, params->serialNumberSoKCommitmentGroup.modulus) % params->serialNumberSoKCommitmentGroup.modulus) *
-                             (h.pow_mod(sprime[i], params->serialNumberSoKCommitmentGroup.modulus) % params->serialNumberSoKCommitmentGroup.modulus)) %
+                Bignum exp = b->pow(s_notprime[i]);
+                tprime[i] = (value.pow(exp) * h->pow(sprime[i])) %
                             params->serialNumberSoKCommitmentGroup.modulus;
             }
         });
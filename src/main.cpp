@@ -102,6 +102,7 @@ bool fTxIndex = false;
 bool fHavePruned = false;
 bool fPruneMode = false;
 bool fAddressIndex = false;
+bool fAddressBalanceIndex = false;
 bool fSpentIndex = false;
 bool fTimestampIndex = false;
 bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
@@ -1030,15 +1031,15 @@ bool CheckSequenceLocks(
         prevheights.resize(tx.vin.size());
         for (size_t txinIndex = 0; txinIndex < tx.vin.size(); txinIndex++) {
             const CTxIn &txin = tx.vin[txinIndex];
-            CCoins coins;
-            if (!viewMemPool.GetCoins(txin.prevout.hash, coins)) {
+            Coin coin;
+            if (!viewMemPool.GetCoin(txin.prevout, coin)) {
                 return error("%s: Missing input", __func__);
             }
-            if (coins.nHeight == MEMPOOL_HEIGHT) {
+            if (coin.nHeight == MEMPOOL_HEIGHT) {
                 // Assume all mempool transaction confirm in the next block
                 prevheights[txinIndex] = tip->nHeight + 1;
             } else {
-                prevheights[txinIndex] = coins.nHeight;
+                prevheights[txinIndex] = coin.nHeight;
             }
         }
         lockPair = CalculateSequenceLocks(tx, flags, &prevheights, index);
@@ -1225,10 +1226,10 @@ void LimitMempoolSize(CTxMemPool &pool, size_t limit, unsigned long age) {
     if (expired != 0)
         LogPrint("mempool", "Expired %i transactions from the memory pool\n", expired);
 
-    std::vector <uint256> vNoSpendsRemaining;
+    std::vector <COutPoint> vNoSpendsRemaining;
     pool.TrimToSize(limit, &vNoSpendsRemaining);
     BOOST_FOREACH(
-    const uint256 &removed, vNoSpendsRemaining)
+    const COutPoint &removed, vNoSpendsRemaining)
     pcoinsTip->Uncache(removed);
 }
 
@@ -1249,7 +1250,7 @@ bool AcceptToMemoryPoolWorker(
         bool *pfMissingInputs,
         bool fOverrideMempoolLimit,
         const CAmount &nAbsurdFee,
-        std::vector <uint256> &vHashTxnToUncache,
+        std::vector <COutPoint> &vCoinsToUncache,
         bool isCheckWalletTransaction,
         bool markZcoinSpendTransactionSerial) {
     bool fTestNet = (Params().NetworkIDString() == CBaseChainParams::TESTNET);
@@ -1444,11 +1445,14 @@ bool AcceptToMemoryPoolWorker(
             view.SetBackend(viewMemPool);
 
             // do we already have it?
-            bool fHadTxInCache = pcoinsTip->HaveCoinsInCache(hash);
-            if (view.HaveCoins(hash)) {
-                if (!fHadTxInCache) vHashTxnToUncache.push_back(hash);
-                LogPrintf("cause by -> txn-already-known!\n");
-                return state.Invalid(false, REJECT_ALREADY_KNOWN, "txn-already-known");
+            for (size_t out = 0; out < tx.vout.size(); out++) {
+                COutPoint outpoint(hash, out);
+                bool fHadCoinInCache = pcoinsTip->HaveCoinInCache(outpoint);
+                if (view.HaveCoin(outpoint)) {
+                    if (!fHadCoinInCache) vCoinsToUncache.push_back(outpoint);
+                    LogPrintf("cause by -> txn-already-known!\n");
+                    return state.Invalid(false, REJECT_ALREADY_KNOWN, "txn-already-known");
+                }
             }
 
             if (!tx.IsZerocoinSpend() && !tx.IsSigmaSpend() && !tx.IsZerocoinRemint() && fCheckInputs) {
@@ -1457,11 +1461,18 @@ bool AcceptToMemoryPoolWorker(
                 // and only helps with filling in pfMissingInputs (to determine missing vs spent).
 
                 BOOST_FOREACH(const CTxIn txin, tx.vin) {
-                    if (!pcoinsTip->HaveCoinsInCache(txin.prevout.hash))
-                        vHashTxnToUncache.push_back(txin.prevout.hash);
-                    if (!view.HaveCoins(txin.prevout.hash)) {
+                    if (!pcoinsTip->HaveCoinInCache(txin.prevout))
+                        vCoinsToUncache.push_back(txin.prevout);
+                    if (!view.HaveCoin(txin.prevout)) {
+                        // Are inputs missing because we already have the tx? Only check the cache for its outputs
+                        for (size_t out = 0; out < tx.vout.size(); out++) {
+                            if (pcoinsTip->HaveCoinInCache(COutPoint(hash, out))) {
+                                LogPrintf("cause by -> txn-already-known!\n");
+                                return state.Invalid(false, REJECT_DUPLICATE, "txn-already-known");
+                            }
+                        }
                         if (pfMissingInputs) *pfMissingInputs = true;
-                        LogPrintf("cause by ->view.HaveCoins!\n");
+                        LogPrintf("cause by ->view.HaveCoin!\n");
                         return false; // fMissingInputs and !state.IsInvalid() is used to detect this condition, don't set state.Invalid()
                     }
                 }
@@ -1525,8 +1536,8 @@ bool AcceptToMemoryPoolWorker(
                 // during reorgs to ensure COINBASE_MATURITY is still met.
                 BOOST_FOREACH(
                 const CTxIn& txin, tx.vin) {
-                    const CCoins* coins = view.AccessCoins(txin.prevout.hash);
-                    if (coins->IsCoinBase()) {
+                    const Coin &coin = view.AccessCoin(txin.prevout);
+                    if (coin.IsCoinBase()) {
                         fSpendsCoinbase = true;
                         break;
                     }
@@ -1886,11 +1897,11 @@ bool AcceptToMemoryPool(
     LogPrintf("AcceptToMemoryPool(), transaction: %s, fCheckInputs=%s\n",
               tx.GetHash().ToString(),
               fCheckInputs);
-    std::vector <uint256> vHashTxToUncache;
+    std::vector <COutPoint> vCoinsToUncache;
     bool res = AcceptToMemoryPoolWorker(
         pool, state, tx, fCheckInputs, fLimitFree, pfMissingInputs,
         fOverrideMempoolLimit, nAbsurdFee,
-        vHashTxToUncache, isCheckWalletTransaction,
+        vCoinsToUncache, isCheckWalletTransaction,
         markZcoinSpendTransactionSerial);
     if (res) {
         LogPrintf("AcceptToMemoryPool: Successfully added txn %s to %s.\n",
@@ -1901,8 +1912,8 @@ bool AcceptToMemoryPool(
         LogPrintf("AcceptToMemoryPool: FAILED to add txn %s to %s.\n",
                   tx.ToString(),
                   (&pool == &mempool) ? "mempool" : "stempool");
-        BOOST_FOREACH(const uint256 &hashTx, vHashTxToUncache)
-            pcoinsTip->Uncache(hashTx);
+        BOOST_FOREACH(const COutPoint &outpoint, vCoinsToUncache)
+            pcoinsTip->Uncache(outpoint);
     }
     return res;
 }
@@ -1943,15 +1954,9 @@ GetTransaction(const uint256 &hash, CTransaction &txOut, const Consensus::Params
     }
 
     if (fAllowSlow) { // use coin database to locate block that contains transaction, and scan it
-        int nHeight = -1;
-        {
-            const CCoinsViewCache &view = *pcoinsTip;
-            const CCoins *coins = view.AccessCoins(hash);
-            if (coins)
-                nHeight = coins->nHeight;
-        }
-        if (nHeight > 0)
-            pindexSlow = chainActive[nHeight];
+        const Coin &coin = AccessByTxid(*pcoinsTip, hash);
+        if (!coin.IsSpent())
+            pindexSlow = chainActive[coin.nHeight];
     }
 
     if (pindexSlow) {
@@ -1998,17 +2003,28 @@ bool GetSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value)
 }
 
 bool GetAddressIndex(uint160 addressHash, AddressType type,
-                     std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex, int start, int end)
+                     std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex, int start, int end, size_t limit)
 {
     if (!fAddressIndex)
         return error("address index not enabled");
 
-    if (!pblocktree->ReadAddressIndex(addressHash, type, addressIndex, start, end))
+    if (!pblocktree->ReadAddressIndex(addressHash, type, addressIndex, start, end, limit))
         return error("unable to get txids for address");
 
     return true;
 }
 
+bool GetAddressBalance(uint160 addressHash, AddressType type, CAddressBalanceValue &balance)
+{
+    if (!fAddressBalanceIndex)
+        return false;
+
+    if (!pblocktree->ReadAddressBalanceIndex(addressHash, type, balance))
+        return error("unable to get balance for address");
+
+    return true;
+}
+
 bool GetAddressUnspent(uint160 addressHash, AddressType type,
                        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs)
 {
@@ -2021,6 +2037,29 @@ bool GetAddressUnspent(uint160 addressHash, AddressType type,
     return true;
 }
 
+bool GetPrivacySupply(CPrivacySupply &supply)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    // The record is absent until the first privacy transaction is connected
+    if (!pblocktree->ReadPrivacySupply(supply))
+        supply.SetNull();
+
+    return true;
+}
+
+bool GetPrivacySupplyHistory(int start, int end, std::vector<CPrivacySupply> &history)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    if (!pblocktree->ReadPrivacySupplyHistory(start, end, history))
+        return error("unable to get privacy supply history");
+
+    return true;
+}
+
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -2326,29 +2365,20 @@ void static InvalidBlockFound(CBlockIndex *pindex, const CValidationState &state
 }
 
 void UpdateCoins(const CTransaction &tx, CCoinsViewCache &inputs, CTxUndo &txundo, int nHeight) {
+    bool fSpendsPrevouts = !tx.IsCoinBase() && !tx.IsZerocoinSpend() && !tx.IsSigmaSpend() && !tx.IsZerocoinRemint();
     // mark inputs spent
-    if (!tx.IsCoinBase() && !tx.IsZerocoinSpend() && !tx.IsSigmaSpend() && !tx.IsZerocoinRemint()) {
+    if (fSpendsPrevouts) {
         txundo.vprevout.reserve(tx.vin.size());
         BOOST_FOREACH(
         const CTxIn &txin, tx.vin) {
-            CCoinsModifier coins = inputs.ModifyCoins(txin.prevout.hash);
-            unsigned nPos = txin.prevout.n;
-
-            if (nPos >= coins->vout.size() || coins->vout[nPos].IsNull())
-                assert(false);
             // mark an outpoint spent, and construct undo information
-            txundo.vprevout.push_back(CTxInUndo(coins->vout[nPos]));
-            coins->Spend(nPos);
-            if (coins->vout.size() == 0) {
-                CTxInUndo &undo = txundo.vprevout.back();
-                undo.nHeight = coins->nHeight;
-                undo.fCoinBase = coins->fCoinBase;
-                undo.nVersion = coins->nVersion;
-            }
+            txundo.vprevout.emplace_back();
+            bool is_spent = inputs.SpendCoin(txin.prevout, &txundo.vprevout.back());
+            assert(is_spent);
         }
     }
-    // add outputs
-    inputs.ModifyNewCoins(tx.GetHash(), tx.IsCoinBase())->FromTx(tx, nHeight);
+    // add outputs. Transactions without regular inputs aren't made unique by them, let them overwrite a copy
+    AddCoins(inputs, tx, nHeight, !tx.IsCoinBase() && !fSpendsPrevouts);
 }
 
 void UpdateCoins(const CTransaction &tx, CCoinsViewCache &inputs, int nHeight) {
@@ -2379,51 +2409,41 @@ namespace Consensus {
         // for an attacker to attempt to split the network.
         if (!inputs.HaveInputs(tx))
             return state.Invalid(false, 0, "", "Inputs unavailable");
-        const Consensus::Params& consensus = Params();
 
         CAmount nValueIn = 0;
         CAmount nFees = 0;
         for (unsigned int i = 0; i < tx.vin.size(); i++) {
             const COutPoint &prevout = tx.vin[i].prevout;
-            const CCoins *coins = inputs.AccessCoins(prevout.hash);
-            assert(coins);
-            bool fGenerated = coins->IsCoinBase() || coins->IsCoinStake() ;
+            const Coin &coin = inputs.AccessCoin(prevout);
+            assert(!coin.IsSpent());
+            bool fGenerated = coin.IsCoinBase() || coin.IsCoinStake() ;
             // If prev is coinbase or coinstake, check that it's matured
             if (fGenerated) {
-                if (nSpendHeight - coins->nHeight < COINBASE_MATURITY)
+                if (nSpendHeight - coin.nHeight < COINBASE_MATURITY)
                     return state.Invalid(false,
-                                         REJECT_INVALID, coins->IsCoinStake() ? "bad-txns-premature-spend-of-coinstake":"bad-txns-premature-spend-of-coinbase",
-                                         strprintf(coins->IsCoinStake() ? "tried to spend coinstake at depth %d":"tried to spend coinbase at depth %d",
-                                                   nSpendHeight - coins->nHeight));
+                                         REJECT_INVALID, coin.IsCoinStake() ? "bad-txns-premature-spend-of-coinstake":"bad-txns-premature-spend-of-coinbase",
+                                         strprintf(coin.IsCoinStake() ? "tried to spend coinstake at depth %d":"tried to spend coinbase at depth %d",
+                                                   nSpendHeight - coin.nHeight));
             }
             bool fBlacklistCheck = nSpendHeight > 1 && sporkManager.IsSporkActive(SPORK_15_BLACKLIST_ENABLED);
             if(fBlacklistCheck){
-                CTransaction txPrev;
-                uint256 hash;
-
-                // get previous transaction
-                GetTransaction(tx.vin[i].prevout.hash, txPrev, consensus, hash, true);
+                // extract the destination of the spent output, the coin carries it so the previous transaction isn't read
                 CTxDestination source;
+                ExtractDestination(coin.out.scriptPubKey, source);
 
-                //make sure the previous input exists
-                if (txPrev.vout.size()>tx.vin[i].prevout.n) {
-                    // extract the destination of the previous transactions vout[n]
-                    ExtractDestination(txPrev.vout[tx.vin[i].prevout.n].scriptPubKey, source);
+                // convert to an address
+                CBitcoinAddress addressSource(source);
+                std::string addr = addressSource.ToString();
 
-                    // convert to an address
-                    CBitcoinAddress addressSource(source);
-                    std::string addr = addressSource.ToString();
-
-                    if (ContainsBlacklistedAddr(addr)) {
-                            LogPrintf("Bad SpendHeight is %d\n",nSpendHeight);
-                            return state.DoS(100, false, REJECT_INVALID, "bad-txns-inputs-blacklisted", false);
-                    } 
+                if (ContainsBlacklistedAddr(addr)) {
+                        LogPrintf("Bad SpendHeight is %d\n",nSpendHeight);
+                        return state.DoS(100, false, REJECT_INVALID, "bad-txns-inputs-blacklisted", false);
                 }
             }
 
             // Check for negative or overflow input values
-            nValueIn += coins->vout[prevout.n].nValue;
-            if (!MoneyRange(coins->vout[prevout.n].nValue) || !MoneyRange(nValueIn))
+            nValueIn += coin.out.nValue;
+            if (!MoneyRange(coin.out.nValue) || !MoneyRange(nValueIn))
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-inputvalues-outofrange");
 
         }
@@ -2475,11 +2495,11 @@ bool CheckInputs(const CTransaction &tx, CValidationState &state, const CCoinsVi
         if (fScriptChecks) {
             for (unsigned int i = 0; i < tx.vin.size(); i++) {
                 const COutPoint &prevout = tx.vin[i].prevout;
-                const CCoins *coins = inputs.AccessCoins(prevout.hash);
-                assert(coins);
+                const Coin &coin = inputs.AccessCoin(prevout);
+                assert(!coin.IsSpent());
 
                 // Verify signature
-                CScriptCheck check(*coins, tx, i, flags, cacheStore, &txdata);
+                CScriptCheck check(coin.out, tx, i, flags, cacheStore, &txdata);
                 if (pvChecks) {
                     pvChecks->push_back(CScriptCheck());
                     check.swap(pvChecks->back());
@@ -2491,7 +2511,7 @@ bool CheckInputs(const CTransaction &tx, CValidationState &state, const CCoinsVi
                         // arguments; if so, don't trigger DoS protection to
                         // avoid splitting the network between upgraded and
                         // non-upgraded nodes.
-                        CScriptCheck check2(*coins, tx, i, flags & (~SCRIPT_VERIFY_STRICTENC), cacheStore, &txdata);
+                        CScriptCheck check2(coin.out, tx, i, flags & (~SCRIPT_VERIFY_STRICTENC), cacheStore, &txdata);
                         if (check2()) {
                             LogPrintf("non-mandatory-script-verify-flag\n");
                             return state.Invalid(false, REJECT_NONSTANDARD,
@@ -2625,36 +2645,42 @@ namespace {
 
 } // anon namespace
 
+enum DisconnectResult
+{
+    DISCONNECT_OK,      // All good.
+    DISCONNECT_UNCLEAN, // Rolled back, but UTXO set was inconsistent with block.
+    DISCONNECT_FAILED   // Something else went wrong.
+};
+
 /**
- * Apply the undo operation of a CTxInUndo to the given chain state.
- * @param undo The undo object.
+ * Restore the UTXO in a Coin at a given COutPoint.
+ * @param undo The Coin to be restored.
  * @param view The coins view to which to apply the changes.
  * @param out The out point that corresponds to the tx input.
- * @return True on success.
+ * @return A DisconnectResult as an int
  */
-static bool ApplyTxInUndo(const CTxInUndo &undo, CCoinsViewCache &view, const COutPoint &out) {
+static int ApplyTxInUndo(Coin&& undo, CCoinsViewCache &view, const COutPoint &out) {
     bool fClean = true;
 
-    CCoinsModifier coins = view.ModifyCoins(out.hash);
-    if (undo.nHeight != 0) {
-        // undo data contains height: this is the last output of the prevout tx being spent
-        if (!coins->IsPruned())
-            fClean = fClean && error("%s: undo data overwriting existing transaction", __func__);
-        coins->Clear();
-        coins->fCoinBase = undo.fCoinBase;
-        coins->nHeight = undo.nHeight;
-        coins->nVersion = undo.nVersion;
-    } else {
-        if (coins->IsPruned())
-            fClean = fClean && error("%s: undo data adding output to missing transaction", __func__);
+    if (view.HaveCoin(out))
+        fClean = error("%s: undo data overwriting existing output", __func__);
+
+    if (undo.nHeight == 0) {
+        // Missing undo metadata (height, coinbase and coinstake). Older versions included this
+        // information only in undo records for the last spend of a transactions'
+        // outputs. This implies that it must be present for some other output of the same tx.
+        const Coin &alternate = AccessByTxid(view, out.hash);
+        if (alternate.IsSpent()) {
+            error("%s: undo data adding output to missing transaction", __func__);
+            return DISCONNECT_FAILED;
+        }
+        undo.nHeight = alternate.nHeight;
+        undo.fCoinBase = alternate.fCoinBase;
+        undo.fCoinStake = alternate.fCoinStake;
     }
-    if (coins->IsAvailable(out.n))
-        fClean = fClean && error("%s: undo data overwriting existing output", __func__);
-    if (coins->vout.size() < out.n + 1)
-        coins->vout.resize(out.n + 1);
-    coins->vout[out.n] = undo.txout;
+    view.AddCoin(out, std::move(undo), !fClean);
 
-    return fClean;
+    return fClean ? DISCONNECT_OK : DISCONNECT_UNCLEAN;
 }
 
 bool DisconnectBlock(const CBlock &block, CValidationState &state, const CBlockIndex *pindex, CCoinsViewCache &view,
@@ -2691,33 +2717,30 @@ bool DisconnectBlock(const CBlock &block, CValidationState &state, const CBlockI
 
         // Check that all outputs are available and match the outputs in the block itself
         // exactly.
-        {
-            CCoinsModifier outs = view.ModifyCoins(hash);
-            outs->ClearUnspendable();
-
-            CCoins outsBlock(tx, pindex->nHeight);
-            // The CCoins serialization does not serialize negative numbers.
-            // No network rules currently depend on the version here, so an inconsistency is harmless
-            // but it must be corrected before txout nversion ever influences a network rule.
-            if (outsBlock.nVersion < 0)
-                outs->nVersion = outsBlock.nVersion;
-            if (*outs != outsBlock)
-                fClean = fClean && error("DisconnectBlock(): added transaction mismatch? database corrupted");
-
-            // remove outputs
-            outs->Clear();
+        bool fCoinBase = tx.IsCoinBase();
+        bool fCoinStake = tx.IsCoinStake();
+        for (size_t o = 0; o < tx.vout.size(); o++) {
+            if (!tx.vout[o].scriptPubKey.IsUnspendable()) {
+                COutPoint out(hash, o);
+                Coin coin;
+                bool fSpent = view.SpendCoin(out, &coin);
+                if (!fSpent || tx.vout[o] != coin.out || (uint32_t)pindex->nHeight != coin.nHeight ||
+                        fCoinBase != coin.IsCoinBase() || fCoinStake != coin.IsCoinStake())
+                    fClean = fClean && error("DisconnectBlock(): added transaction mismatch? database corrupted");
+            }
         }
 
         // restore inputs
         if (!tx.IsCoinBase() && !tx.IsZerocoinSpend() && !tx.IsSigmaSpend() && !tx.IsZerocoinRemint()) { // not coinbases
-            const CTxUndo &txundo = blockUndo.vtxundo[i - 1];
+            CTxUndo &txundo = blockUndo.vtxundo[i - 1];
             if (txundo.vprevout.size() != tx.vin.size())
                 return error("DisconnectBlock(): transaction and undo data inconsistent");
             for (unsigned int j = tx.vin.size(); j-- > 0;) {
                 const COutPoint &out = tx.vin[j].prevout;
-                const CTxInUndo &undo = txundo.vprevout[j];
-                if (!ApplyTxInUndo(undo, view, out))
-                    fClean = false;
+                int res = ApplyTxInUndo(std::move(txundo.vprevout[j]), view, out);
+                if (res == DISCONNECT_FAILED)
+                    return false;
+                fClean = fClean && res != DISCONNECT_UNCLEAN;
             }
             nFees += view.GetValueIn(tx) - tx.GetValueOut();
         }
@@ -2747,6 +2770,14 @@ bool DisconnectBlock(const CBlock &block, CValidationState &state, const CBlockI
                 AbortNode(state, "Failed to write total supply");
                 return error("Failed to write total supply");
             }
+            if (!pblocktree->DisconnectPrivacySupply(pindex->nHeight)) {
+                AbortNode(state, "Failed to write privacy supply");
+                return error("Failed to write privacy supply");
+            }
+            if (fAddressBalanceIndex && !pblocktree->DisconnectAddressBalanceIndex(pindex->nHeight)) {
+                AbortNode(state, "Failed to write address balance index");
+                return error("Failed to write address balance index");
+            }
         }
     }
 
@@ -2872,15 +2903,15 @@ bool ConnectBlock(const CBlock &block, CValidationState &state, CBlockIndex *pin
     // Check proof-of-stake
     if (block.IsProofOfStake()) {
          const COutPoint &prevout = block.vtx[1].vin[0].prevout;
-         const CCoins *coins = view.AccessCoins(prevout.hash);
-          if (!coins)
+         const Coin &coin = view.AccessCoin(prevout);
+          if (coin.IsSpent())
               return state.DoS(100, error("ConnectBlock(): kernel input unavailable"),
                                 REJECT_INVALID, "bad-cs-kernel");
 
          // Check proof-of-stake min confirmations
-         if (pindex->nHeight - coins->nHeight < COINBASE_MATURITY)
+         if (pindex->nHeight - (int)coin.nHeight < COINBASE_MATURITY)
               return state.DoS(100,
-                  error("ConnectBlock(): tried to stake at depth %d", pindex->nHeight - coins->nHeight),
+                  error("ConnectBlock(): tried to stake at depth %d", pindex->nHeight - (int)coin.nHeight),
                     REJECT_INVALID, "bad-cs-premature");
          if(!CheckStakeBlockTimestamp(block.nTime))
               return state.DoS(100, error("ConnectBlock(): proof-of-stake time check failed"),
@@ -2932,10 +2963,11 @@ bool ConnectBlock(const CBlock &block, CValidationState &state, CBlockIndex *pin
     if (fEnforceBIP30) {
         BOOST_FOREACH(
         const CTransaction &tx, block.vtx) {
-            const CCoins *coins = view.AccessCoins(tx.GetHash());
-            if (coins && !coins->IsPruned())
-                return state.DoS(100, error("ConnectBlock(): tried to overwrite transaction"), REJECT_INVALID,
-                                 "bad-txns-BIP30");
+            for (size_t o = 0; o < tx.vout.size(); o++) {
+                if (view.HaveCoin(COutPoint(tx.GetHash(), o)))
+                    return state.DoS(100, error("ConnectBlock(): tried to overwrite transaction"), REJECT_INVALID,
+                                     "bad-txns-BIP30");
+            }
         }
     }
 
@@ -3026,7 +3058,7 @@ bool ConnectBlock(const CBlock &block, CValidationState &state, CBlockIndex *pin
             // be in ConnectBlock because they require the UTXO set
             prevheights.resize(tx.vin.size());
             for (size_t j = 0; j < tx.vin.size(); j++) {
-                prevheights[j] = view.AccessCoins(tx.vin[j].prevout.hash)->nHeight;
+                prevheights[j] = view.AccessCoin(tx.vin[j].prevout).nHeight;
             }
 
             // Which orphan pool entries must we evict?
@@ -3154,6 +3186,10 @@ bool ConnectBlock(const CBlock &block, CValidationState &state, CBlockIndex *pin
     if (fJustCheck)
         return true;
 
+    // Zerocoin/sigma payload of the index entry was rebuilt, it can't be released before it's written
+    if (pindex->privacyData)
+        setDirtyBlockIndex.insert(pindex);
+
     // Write undo information to disk
     if (pindex->GetUndoPos().IsNull() || !pindex->IsValid(BLOCK_VALID_SCRIPTS)) {
         if (pindex->GetUndoPos().IsNull()) {
@@ -3184,6 +3220,12 @@ bool ConnectBlock(const CBlock &block, CValidationState &state, CBlockIndex *pin
 
         if (!pblocktree->AddTotalSupply(block.vtx[0].GetValueOut() - nFees))
             return AbortNode(state, "Failed to write total supply");
+
+        if (!pblocktree->ConnectPrivacySupply(block, pindex->nHeight))
+            return AbortNode(state, "Failed to write privacy supply");
+
+        if (fAddressBalanceIndex && !pblocktree->ConnectAddressBalanceIndex(dbIndexHelper.getAddressIndex(), pindex->nHeight))
+            return AbortNode(state, "Failed to write address balance index");
     }
 
     if (fSpentIndex)
@@ -3326,10 +3368,13 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode) {
             nLastSetChain = nNow;
         }
         size_t cacheSize = pcoinsTip->DynamicMemoryUsage();
+        // The coins cache may also use the part of the -maxmempool allowance which the mempool doesn't.
+        int64_t nMempoolSizeMax = GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
+        int64_t nTotalSpace = nCoinCacheUsage + std::max<int64_t>(nMempoolSizeMax - (int64_t)mempool.DynamicMemoryUsage(), 0);
         // The cache is large and close to the limit, but we have time now (not in the middle of a block processing).
-        bool fCacheLarge = mode == FLUSH_STATE_PERIODIC && cacheSize * (10.0 / 9) > nCoinCacheUsage;
+        bool fCacheLarge = mode == FLUSH_STATE_PERIODIC && cacheSize * (10.0 / 9) > nTotalSpace;
         // The cache is over the limit, we have to write now.
-        bool fCacheCritical = mode == FLUSH_STATE_IF_NEEDED && cacheSize > nCoinCacheUsage;
+        bool fCacheCritical = mode == FLUSH_STATE_IF_NEEDED && (int64_t)cacheSize > nTotalSpace;
         // It's been a while since we wrote the block index to disk. Do this frequently, so we don't need to redownload after a crash.
         bool fPeriodicWrite =
                 mode == FLUSH_STATE_PERIODIC && nNow > nLastWrite + (int64_t) DATABASE_WRITE_INTERVAL * 1000000;
@@ -3357,6 +3402,7 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode) {
                 std::vector<const CBlockIndex *> vBlocks;
                 vBlocks.reserve(setDirtyBlockIndex.size());
                 for (set<CBlockIndex *>::iterator it = setDirtyBlockIndex.begin(); it != setDirtyBlockIndex.end();) {
+                    (*it)->UpdatePrivacyDataStatus();
                     vBlocks.push_back(*it);
                     setDirtyBlockIndex.erase(it++);
                 }
@@ -3369,19 +3415,25 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode) {
                 UnlinkPrunedFiles(setFilesToPrune);
             nLastWrite = nNow;
         }
+        // Release zerocoin/sigma payloads of the block index entries which weren't used recently. Those not written yet stay
+        pblocktree->TrimPrivacyData(nMaxBlockPrivacyDataCache, setDirtyBlockIndex);
         // Flush best chain related state. This can only be done if the blocks / block index write was also done.
         if (fDoFullFlush) {
-            // Typical CCoins structures on disk are around 128 bytes in size.
+            // Typical Coin structures on disk are around 48 bytes in size.
             // Pushing a new one to the database can cause it to be written
             // twice (once in the log, and once in the tables). This is already
             // an overestimation, as most will delete an existing entry or
             // overwrite one. Still, use a conservative safety factor of 2.
-            if (!CheckDiskSpace(128 * 2 * 2 * pcoinsTip->GetCacheSize()))
+            if (!CheckDiskSpace(48 * 2 * 2 * pcoinsTip->GetCacheSize()))
                 return state.Error("out of disk space");
             // Flush the chainstate (which may refer to block index entries).
             if (!pcoinsTip->Flush())
                 return AbortNode(state, "Failed to write to coin database");
             nLastFlush = nNow;
+            // The sigma state snapshot is only usable at startup if it matches the flushed chainstate tip.
+            // Skip the periodic snapshots during the initial download, the state changes too fast there.
+            if (mode == FLUSH_STATE_ALWAYS || !IsInitialBlockDownload())
+                sigma::WriteSigmaStateSnapshot(&chainActive);
         }
         if (fDoFullFlush || ((mode == FLUSH_STATE_ALWAYS || mode == FLUSH_STATE_PERIODIC) &&
                              nNow > nLastSetChain + (int64_t) DATABASE_WRITE_INTERVAL * 1000000)) {
@@ -3737,13 +3789,10 @@ ConnectTip(CValidationState &state, const CChainParams &chainparams, CBlockIndex
 
 int GetUTXOHeight(const COutPoint &outpoint) {
     LOCK(cs_main);
-    CCoins coins;
-    if (!pcoinsTip->GetCoins(outpoint.hash, coins) ||
-        (unsigned int) outpoint.n >= coins.vout.size() ||
-        coins.vout[outpoint.n].IsNull()) {
+    Coin coin;
+    if (!pcoinsTip->GetCoin(outpoint, coin))
         return -1;
-    }
-    return coins.nHeight;
+    return coin.nHeight;
 }
 
 int GetInputAge(const CTxIn &txin) {
@@ -3754,11 +3803,11 @@ int GetInputAge(const CTxIn &txin) {
         CCoinsViewMemPool viewMempool(pcoinsTip, mempool);
         view.SetBackend(viewMempool); // temporarily switch cache backend to db+mempool view
 
-        const CCoins *coins = view.AccessCoins(txin.prevout.hash);
+        const Coin &coin = view.AccessCoin(txin.prevout);
 
-        if (coins) {
-            if (coins->nHeight < 0) return 0;
-            return chainActive.Height() - coins->nHeight + 1;
+        if (!coin.IsSpent()) {
+            if (coin.nHeight == MEMPOOL_HEIGHT) return 0;
+            return chainActive.Height() - (int)coin.nHeight + 1;
         } else {
             return -1;
         }
@@ -4930,6 +4979,23 @@ bool CheckStake(CBlock* pblock, CWallet& wallet, const CChainParams& chainparams
 
 // novacoin: attempt to generate suitable proof-of-stake
 bool SignBlock(CBlock& block, CWallet& wallet, int64_t& nFees, CBlockTemplate *pblocktemplate)
+{
+    // if we are trying to sign
+    // a complete proof-of-stake block
+    if (block.vtx[0].vout[0].IsEmpty() && block.IsProofOfStake() && !block.vchBlockSig.empty()){
+        LogPrintf("trying to sign a complete proof-of-stake block\n");
+        return true;
+    }
+
+    CMutableTransaction txCoinStake;
+    CKey key;
+    if (!CreateBlockCoinStake(block, wallet, nFees, pblocktemplate, txCoinStake, key))
+        return false;
+
+    return SignStakeBlock(block, txCoinStake, key);
+}
+
+bool CreateBlockCoinStake(CBlock& block, CWallet& wallet, int64_t& nFees, CBlockTemplate *pblocktemplate, CMutableTransaction& txCoinStake, CKey& key)
 {
     // if we are trying to sign
     // something except proof-of-stake block template
@@ -4938,19 +5004,8 @@ bool SignBlock(CBlock& block, CWallet& wallet, int64_t& nFees, CBlockTemplate *p
         return false;
     }
 
-    // if we are trying to sign
-    // a complete proof-of-stake block
-    if (block.IsProofOfStake() && !block.vchBlockSig.empty()){
-        LogPrintf("trying to sign a complete proof-of-stake block\n");
-        return true;
-    }
-
     static int64_t nLastCoinStakeSearchTime = GetAdjustedTime(); // startup timestamp
 
-    CKey key;
-    CMutableTransaction txCoinBase(block.vtx[0]);
-    CMutableTransaction txCoinStake;
-
     int64_t nStakeTime = GetAdjustedTime();
     nStakeTime &= ~Params().GetConsensus().nStakeTimestampMask;
     int64_t nSearchTime = nStakeTime; // search to current time
@@ -4963,21 +5018,7 @@ bool SignBlock(CBlock& block, CWallet& wallet, int64_t& nFees, CBlockTemplate *p
                 // make sure coinstake would meet timestamp protocol
                 // as it would be the same as the block timestamp
                 block.nTime = nSearchTime;
-                block.vtx[0] = txCoinBase;
-
-                block.vtx.insert(block.vtx.begin() + 1, txCoinStake);
-
-                block.hashMerkleRoot = BlockMerkleRoot(block);
-                // append a signature to our block
-                key.SignCompact(block.GetHash(), block.vchBlockSig);
-                if(!block.vchBlockSig.empty()){
-    
-                    LogPrintf("PoS Block signed\n");
-                    return true;
-                }
-                else
-                    LogPrintf("Didnt sign");
-            return false;
+                return true;
             }
         }
         nLastCoinStakeSearchInterval = nSearchTime - nLastCoinStakeSearchTime;
@@ -4987,6 +5028,22 @@ bool SignBlock(CBlock& block, CWallet& wallet, int64_t& nFees, CBlockTemplate *p
     return false;
 }
 
+bool SignStakeBlock(CBlock& block, const CTransaction& txCoinStake, const CKey& key)
+{
+    block.vtx.insert(block.vtx.begin() + 1, txCoinStake);
+
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    // append a signature to our block
+    key.SignCompact(block.GetHash(), block.vchBlockSig);
+    if (block.vchBlockSig.empty()) {
+        LogPrintf("Didnt sign");
+        return false;
+    }
+
+    LogPrintf("PoS Block signed\n");
+    return true;
+}
+
 static bool AcceptBlockHeader(const CBlockHeader &block, CValidationState &state, const CChainParams &chainparams,
                               CBlockIndex **ppindex = NULL, bool fProofOfStake=true) {
 //    LogPrintf("---AcceptBlockHeader hash=%s--\n", block.GetHash().ToString());
@@ -5466,6 +5523,10 @@ bool static LoadBlockIndexDB() {
     pblocktree->ReadFlag("addressindex", fAddressIndex);
     LogPrintf("%s: address index %s\n", __func__, fAddressIndex ? "enabled" : "disabled");
 
+    // Check whether we have an address balance index
+    pblocktree->ReadFlag("addressbalanceindex", fAddressBalanceIndex);
+    LogPrintf("%s: address balance index %s\n", __func__, fAddressBalanceIndex ? "enabled" : "disabled");
+
     // Check whether we have a timestamp index
     pblocktree->ReadFlag("timestampindex", fTimestampIndex);
     LogPrintf("%s: timestamp index %s\n", __func__, fTimestampIndex ? "enabled" : "disabled");
@@ -5488,11 +5549,14 @@ bool static LoadBlockIndexDB() {
     // some blocks in index can change as a result of ZerocoinBuildStateFromIndex() call
     set<CBlockIndex *> changes;
     ZerocoinBuildStateFromIndex(&chainActive, changes);
-    sigma::BuildSigmaStateFromIndex(&chainActive);
+    if (!sigma::LoadSigmaStateSnapshot(&chainActive))
+        sigma::BuildSigmaStateFromIndex(&chainActive);
     if (!changes.empty()) {
         setDirtyBlockIndex.insert(changes.begin(), changes.end());
         FlushStateToDisk();
     }
+    // Building the states loaded the payloads of all the blocks with zerocoin/sigma transactions
+    pblocktree->TrimPrivacyData(nMaxBlockPrivacyDataCache, setDirtyBlockIndex);
 
     LogPrintf("%s: hashBestChain=%s height=%d date=%s progress=%f\n", __func__,
               chainActive.Tip()->GetBlockHash().ToString(), chainActive.Height(),
@@ -5768,6 +5832,10 @@ bool InitBlockIndex(const CChainParams &chainparams) {
     fAddressIndex = GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
     pblocktree->WriteFlag("addressindex", fAddressIndex);
 
+    // Use the provided setting for -addressbalanceindex in the new database
+    fAddressBalanceIndex = fAddressIndex && GetBoolArg("-addressbalanceindex", DEFAULT_ADDRESSBALANCEINDEX);
+    pblocktree->WriteFlag("addressbalanceindex", fAddressBalanceIndex);
+
     fSpentIndex = GetBoolArg("-spentindex", DEFAULT_SPENTINDEX);
     pblocktree->WriteFlag("spentindex", fSpentIndex);
 
@@ -6207,12 +6275,13 @@ bool static AlreadyHave(const CInv &inv) EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
                 recentRejects->reset();
             }
 
-            // Use pcoinsTip->HaveCoinsInCache as a quick approximation to exclude
+            // Use pcoinsTip->HaveCoinInCache as a quick approximation to exclude
             // requesting or processing some txs which have already been included in a block
             return recentRejects->contains(inv.hash) ||
                    mempool.exists(inv.hash) ||
                    mapOrphanTransactions.count(inv.hash) ||
-                   pcoinsTip->HaveCoinsInCache(inv.hash);
+                   pcoinsTip->HaveCoinInCache(COutPoint(inv.hash, 0)) || // Best effort: only try output 0 and 1
+                   pcoinsTip->HaveCoinInCache(COutPoint(inv.hash, 1));
         }
         case MSG_BLOCK:
         case MSG_WITNESS_BLOCK:
@@ -38,10 +38,13 @@
 class CBlockIndex;
 class CBlockTreeDB;
 class CBloomFilter;
+class CPrivacySupply;
 class CChainParams;
 class CInv;
 class CScriptCheck;
+class CKey;
 class CTxMemPool;
+class CTxUndo;
 class CValidationInterface;
 class CValidationState;
 class CWallet;
@@ -162,6 +165,7 @@ static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
 static const bool DEFAULT_TXINDEX = true;
 static const bool DEFAULT_TIMESTAMPINDEX = false;
 static const bool DEFAULT_ADDRESSINDEX = false;
+static const bool DEFAULT_ADDRESSBALANCEINDEX = false;
 static const bool DEFAULT_SPENTINDEX = false;
 static const bool DEFAULT_TOR_SETUP = false;
 static const bool DEFAULT_ZAP_WALLET = false;
@@ -427,6 +431,8 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
 
 /** Apply the effects of this transaction on the UTXO set represented by view */
 void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, int nHeight);
+/** Same as above, spent coins are moved into txundo */
+void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, CTxUndo &txundo, int nHeight);
 
 /** Context-independent validity checks */
 //BTZC: ADD params for ShroudX works
@@ -499,8 +505,8 @@ private:
 
 public:
     CScriptCheck(): amount(0), ptxTo(0), nIn(0), nFlags(0), cacheStore(false), error(SCRIPT_ERR_UNKNOWN_ERROR) {}
-    CScriptCheck(const CCoins& txFromIn, const CTransaction& txToIn, unsigned int nInIn, unsigned int nFlagsIn, bool cacheIn, PrecomputedTransactionData* txdataIn) :
-        scriptPubKey(txFromIn.vout[txToIn.vin[nInIn].prevout.n].scriptPubKey), amount(txFromIn.vout[txToIn.vin[nInIn].prevout.n].nValue),
+    CScriptCheck(const CTxOut& outIn, const CTransaction& txToIn, unsigned int nInIn, unsigned int nFlagsIn, bool cacheIn, PrecomputedTransactionData* txdataIn) :
+        scriptPubKey(outIn.scriptPubKey), amount(outIn.nValue),
         ptxTo(&txToIn), nIn(nInIn), nFlags(nFlagsIn), cacheStore(cacheIn), error(SCRIPT_ERR_UNKNOWN_ERROR), txdata(txdataIn) { }
 
     bool operator()();
@@ -523,9 +529,12 @@ bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, std::v
 bool GetSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value);
 bool GetAddressIndex(uint160 addressHash, AddressType type,
                      std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
-                     int start = 0, int end = 0);
+                     int start = 0, int end = 0, size_t limit = 0);
+bool GetAddressBalance(uint160 addressHash, AddressType type, CAddressBalanceValue &balance);
 bool GetAddressUnspent(uint160 addressHash, AddressType type,
                        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs);
+bool GetPrivacySupply(CPrivacySupply &supply);
+bool GetPrivacySupplyHistory(int start, int end, std::vector<CPrivacySupply> &history);
 
 /** Functions for disk access for blocks */
 bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart);
@@ -566,6 +575,10 @@ void ReprocessBlocks(int nBlocks);
 /** Proof-of-stake checks */
 bool CheckStake(CBlock* pblock, CWallet& wallet, const CChainParams& chainparams);
 bool SignBlock(CBlock& block, CWallet& wallet, int64_t& nFees, CBlockTemplate *pblocktemplate);
+/** Search for a kernel and create the coinstake for a proof-of-stake template, sets the block time on success */
+bool CreateBlockCoinStake(CBlock& block, CWallet& wallet, int64_t& nFees, CBlockTemplate *pblocktemplate, CMutableTransaction& txCoinStake, CKey& key);
+/** Add the coinstake found by CreateBlockCoinStake to the block and sign it */
+bool SignStakeBlock(CBlock& block, const CTransaction& txCoinStake, const CKey& key);
 /** End PoS checks **/
 int GetUTXOHeight(const COutPoint& outpoint);
 int GetInputAge(const CTxIn &txin);
@@ -134,10 +134,10 @@ void BlockAssembler::resetBlock()
 
 CBlockTemplate* BlockAssembler::CreateNewBlock(
     const CScript& scriptPubKeyIn,
-    const vector<uint256>& tx_ids,bool fProofOfStake)
+    const vector<uint256>& tx_ids,bool fProofOfStake, bool fAddMempoolTxs)
 {
     // Create new block
-    LogPrintf("BlockAssembler::CreateNewBlock()\n");
+    LogPrint("miner", "BlockAssembler::CreateNewBlock()\n");
 
     const Consensus::Params &params = Params().GetConsensus();
     uint32_t nBlockTime;
@@ -227,7 +227,7 @@ CBlockTemplate* BlockAssembler::CreateNewBlock(
                                   ? nMedianTimePast
                                   : pblock->GetBlockTime();
 
-        bool fPriorityBlock = nBlockPrioritySize > 0;
+        bool fPriorityBlock = fAddMempoolTxs && nBlockPrioritySize > 0;
         if (fPriorityBlock) {
             vecPriority.reserve(mempool.mapTx.size());
             for (CTxMemPool::indexed_transaction_set::iterator mi = mempool.mapTx.begin();
@@ -241,7 +241,7 @@ CBlockTemplate* BlockAssembler::CreateNewBlock(
             std::make_heap(vecPriority.begin(), vecPriority.end(), pricomparer);
         }
 
-        CTxMemPool::indexed_transaction_set::nth_index<3>::type::iterator mi = mempool.mapTx.get<3>().begin();
+        CTxMemPool::indexed_transaction_set::nth_index<3>::type::iterator mi = fAddMempoolTxs ? mempool.mapTx.get<3>().begin() : mempool.mapTx.get<3>().end();
         CTxMemPool::txiter iter;
         std::size_t nSigmaSpend = 0;
         CAmount nValueSigmaSpend(0);
@@ -266,12 +266,12 @@ CBlockTemplate* BlockAssembler::CreateNewBlock(
             }
 
             if (inBlock.count(iter)) {
-                LogPrintf("skip, due to exist!\n");
+                LogPrint("miner", "skip, due to exist!\n");
                 continue; // could have been added to the priorityBlock
             }
 
             const CTransaction& tx = iter->GetTx();
-            LogPrintf("Trying to add tx=%s\n", tx.GetHash().ToString());
+            LogPrint("miner", "Trying to add tx=%s\n", tx.GetHash().ToString());
 
             if (!tx_ids.empty() && std::find(tx_ids.begin(), tx_ids.end(), tx.GetHash()) == tx_ids.end()) {
                 continue; // Skip because we were asked to include only transactions in tx_ids.
@@ -289,7 +289,7 @@ CBlockTemplate* BlockAssembler::CreateNewBlock(
                 if (priorityTx)
                     waitPriMap.insert(std::make_pair(iter,actualPriority));
                 else waitSet.insert(iter);
-                LogPrintf("skip tx=%s, due to fOrphan=%s\n", tx.GetHash().ToString(), fOrphan);
+                LogPrint("miner", "skip tx=%s, due to fOrphan=%s\n", tx.GetHash().ToString(), fOrphan);
                 continue;
             }
 
@@ -310,9 +310,9 @@ CBlockTemplate* BlockAssembler::CreateNewBlock(
 //            }
             if (nBlockSize + nTxSize >= nBlockMaxSize) {
                 if (nBlockSize >  nBlockMaxSize - 100 || lastFewTxs > 50) {
-                    LogPrintf("stop due to size overweight", tx.GetHash().ToString());
-                    LogPrintf("nBlockSize=%s\n", nBlockSize);
-                    LogPrintf("nBlockMaxSize=%s\n", nBlockMaxSize);
+                    LogPrint("miner", "stop due to size overweight", tx.GetHash().ToString());
+                    LogPrint("miner", "nBlockSize=%s\n", nBlockSize);
+                    LogPrint("miner", "nBlockMaxSize=%s\n", nBlockMaxSize);
                     break;
                 }
                 // Once we're within 1000 bytes of a full block, only look at 50 more txs
@@ -320,18 +320,18 @@ CBlockTemplate* BlockAssembler::CreateNewBlock(
                 if (nBlockSize > nBlockMaxSize - 1000) {
                     lastFewTxs++;
                 }
-                LogPrintf("skip tx=%s\n", tx.GetHash().ToString());
-                LogPrintf("nBlockSize=%s\n", nBlockSize);
-                LogPrintf("nBlockMaxSize=%s\n", nBlockMaxSize);
+                LogPrint("miner", "skip tx=%s\n", tx.GetHash().ToString());
+                LogPrint("miner", "nBlockSize=%s\n", nBlockSize);
+                LogPrint("miner", "nBlockMaxSize=%s\n", nBlockMaxSize);
                 continue;
             }
             if (tx.IsCoinBase()) {
-                LogPrintf("skip tx=%s, coinbase tx\n", tx.GetHash().ToString());
+                LogPrint("miner", "skip tx=%s, coinbase tx\n", tx.GetHash().ToString());
                 continue;
             }
 
             if (!IsFinalTx(tx, nHeight, nLockTimeCutoff)) {
-                LogPrintf("skip tx=%s, not IsFinalTx\n", tx.GetHash().ToString());
+                LogPrint("miner", "skip tx=%s, not IsFinalTx\n", tx.GetHash().ToString());
                 continue;
             }
 
@@ -368,24 +368,24 @@ CBlockTemplate* BlockAssembler::CreateNewBlock(
                 // Size limits
                 unsigned int nTxSize = ::GetSerializeSize(tx, SER_NETWORK, PROTOCOL_VERSION);
 
-                LogPrintf("\n\n######################################\n");
-                LogPrintf("nBlockMaxSize = %d\n", nBlockMaxSize);
-                LogPrintf("nBlockSize = %d\n", nBlockSize);
-                LogPrintf("nTxSize = %d\n", nTxSize);
-                LogPrintf("nBlockSize + nTxSize  = %d\n", nBlockSize + nTxSize);
-                LogPrintf("nBlockSigOpsCost  = %d\n", nBlockSigOpsCost);
-                LogPrintf("GetLegacySigOpCount  = %d\n", GetLegacySigOpCount(tx));
-                LogPrintf("######################################\n\n\n");
+                LogPrint("miner", "\n\n######################################\n");
+                LogPrint("miner", "nBlockMaxSize = %d\n", nBlockMaxSize);
+                LogPrint("miner", "nBlockSize = %d\n", nBlockSize);
+                LogPrint("miner", "nTxSize = %d\n", nTxSize);
+                LogPrint("miner", "nBlockSize + nTxSize  = %d\n", nBlockSize + nTxSize);
+                LogPrint("miner", "nBlockSigOpsCost  = %d\n", nBlockSigOpsCost);
+                LogPrint("miner", "GetLegacySigOpCount  = %d\n", GetLegacySigOpCount(tx));
+                LogPrint("miner", "######################################\n\n\n");
 
                 if (nBlockSize + nTxSize >= nBlockMaxSize) {
-                    LogPrintf("failed by sized\n");
+                    LogPrint("miner", "failed by sized\n");
                     continue;
                 }
 
                 // Legacy limits on sigOps:
                 unsigned int nTxSigOps = GetLegacySigOpCount(tx);
                 if (nBlockSigOpsCost + nTxSigOps >= MAX_BLOCK_SIGOPS_COST) {
-                    LogPrintf("failed by sized\n");
+                    LogPrint("miner", "failed by sized\n");
                     continue;
                 }
 
@@ -406,15 +406,15 @@ CBlockTemplate* BlockAssembler::CreateNewBlock(
 
 
             unsigned int nTxSigOps = iter->GetSigOpCost();
-            LogPrintf("nTxSigOps=%s\n", nTxSigOps);
-            LogPrintf("nBlockSigOps=%s\n", nBlockSigOps);
-            LogPrintf("MAX_BLOCK_SIGOPS_COST=%s\n", MAX_BLOCK_SIGOPS_COST);
+            LogPrint("miner", "nTxSigOps=%s\n", nTxSigOps);
+            LogPrint("miner", "nBlockSigOps=%s\n", nBlockSigOps);
+            LogPrint("miner", "MAX_BLOCK_SIGOPS_COST=%s\n", MAX_BLOCK_SIGOPS_COST);
             if (nBlockSigOps + nTxSigOps >= MAX_BLOCK_SIGOPS_COST) {
                 if (nBlockSigOps > MAX_BLOCK_SIGOPS_COST - 2) {
-                    LogPrintf("stop due to cross fee\n", tx.GetHash().ToString());
+                    LogPrint("miner", "stop due to cross fee\n", tx.GetHash().ToString());
                     break;
                 }
-                LogPrintf("skip tx=%s, nBlockSigOps + nTxSigOps >= MAX_BLOCK_SIGOPS_COST\n", tx.GetHash().ToString());
+                LogPrint("miner", "skip tx=%s, nBlockSigOps + nTxSigOps >= MAX_BLOCK_SIGOPS_COST\n", tx.GetHash().ToString());
                 continue;
             }
             CAmount nTxFees = iter->GetFee();
@@ -426,7 +426,7 @@ CBlockTemplate* BlockAssembler::CreateNewBlock(
             ++nBlockTx;
             nBlockSigOps += nTxSigOps;
             nFees += nTxFees;
-            LogPrintf("added to block=%s\n", tx.GetHash().ToString());
+            LogPrint("miner", "added to block=%s\n", tx.GetHash().ToString());
             if (fPrintPriority)
             {
                 double dPriority = iter->GetPriority(nHeight);
@@ -576,18 +576,18 @@ bool BlockAssembler::TestPackageTransactions(const CTxMemPool::setEntries& packa
 
 bool BlockAssembler::TestForBlock(CTxMemPool::txiter iter)
 {
-    LogPrintf("\nTestForBlock ######################################\n");
-    LogPrintf("nBlockMaxSize = %d\n", nBlockMaxSize);
-    LogPrintf("nBlockSize = %d\n", nBlockSize);
+    LogPrint("miner", "\nTestForBlock ######################################\n");
+    LogPrint("miner", "nBlockMaxSize = %d\n", nBlockMaxSize);
+    LogPrint("miner", "nBlockSize = %d\n", nBlockSize);
     int nTxSize = ::GetSerializeSize(iter->GetTx(), SER_NETWORK, PROTOCOL_VERSION);
-    LogPrintf("nTxSize = %d\n", nTxSize);
-    LogPrintf("nBlockSize + nTxSize  = %d\n", nBlockSize + nTxSize);
-    LogPrintf("######################################\n\n\n");
-    LogPrintf("nBlockWeight = %d\n", nBlockWeight);
-    LogPrintf("iter->GetTxWeight() = %d\n", iter->GetTxWeight());
-    LogPrintf("nBlockWeight = %d\n", nBlockWeight);
-    LogPrintf("lastFewTxs = %d\n", lastFewTxs);
-    LogPrintf("######################################\n\n\n");
+    LogPrint("miner", "nTxSize = %d\n", nTxSize);
+    LogPrint("miner", "nBlockSize + nTxSize  = %d\n", nBlockSize + nTxSize);
+    LogPrint("miner", "######################################\n\n\n");
+    LogPrint("miner", "nBlockWeight = %d\n", nBlockWeight);
+    LogPrint("miner", "iter->GetTxWeight() = %d\n", iter->GetTxWeight());
+    LogPrint("miner", "nBlockWeight = %d\n", nBlockWeight);
+    LogPrint("miner", "lastFewTxs = %d\n", lastFewTxs);
+    LogPrint("miner", "######################################\n\n\n");
 
     if (nBlockWeight + iter->GetTxWeight() >= nBlockMaxWeight) {
         // If the block is so close to full that no more txs will fit
@@ -595,7 +595,7 @@ bool BlockAssembler::TestForBlock(CTxMemPool::txiter iter)
         // then flag that the block is finished
         if (nBlockWeight >  nBlockMaxWeight - 400 || lastFewTxs > 50) {
              blockFinished = true;
-             LogPrintf("\nTestForBlock -> FAIL: blockFinished = true\n");
+             LogPrint("miner", "\nTestForBlock -> FAIL: blockFinished = true\n");
              return false;
         }
         // Once we're within 4000 weight of a full block, only look at 50 more txs
@@ -603,7 +603,7 @@ bool BlockAssembler::TestForBlock(CTxMemPool::txiter iter)
         if (nBlockWeight > nBlockMaxWeight - 4000) {
             lastFewTxs++;
         }
-        LogPrintf("\nTestForBlock -> FAIL: nBlockWeight + iter->GetTxWeight() >= nBlockMaxWeight\n");
+        LogPrint("miner", "\nTestForBlock -> FAIL: nBlockWeight + iter->GetTxWeight() >= nBlockMaxWeight\n");
         return false;
     }
 
@@ -611,13 +611,13 @@ bool BlockAssembler::TestForBlock(CTxMemPool::txiter iter)
         if (nBlockSize + ::GetSerializeSize(iter->GetTx(), SER_NETWORK, PROTOCOL_VERSION) >= nBlockMaxSize) {
             if (nBlockSize >  nBlockMaxSize - 100 || lastFewTxs > 50) {
                  blockFinished = true;
-                 LogPrintf("\nTestForBlock -> FAIL: fNeedSizeAccounting: blockFinished = true\n");
+                 LogPrint("miner", "\nTestForBlock -> FAIL: fNeedSizeAccounting: blockFinished = true\n");
                  return false;
             }
             if (nBlockSize > nBlockMaxSize - 1000) {
                 lastFewTxs++;
             }
-            LogPrintf("\nTestForBlock -> FAIL: fNeedSizeAccounting\n");
+            LogPrint("miner", "\nTestForBlock -> FAIL: fNeedSizeAccounting\n");
             return false;
         }
     }
@@ -627,12 +627,12 @@ bool BlockAssembler::TestForBlock(CTxMemPool::txiter iter)
         // flag that the block is finished
         if (nBlockSigOpsCost > MAX_BLOCK_SIGOPS_COST - 8) {
             blockFinished = true;
-            LogPrintf("\nTestForBlock -> FAIL: nBlockSigOpsCost: blockFinished = true\n");
+            LogPrint("miner", "\nTestForBlock -> FAIL: nBlockSigOpsCost: blockFinished = true\n");
             return false;
         }
         // Otherwise attempt to find another tx with fewer sigops
         // to put in the block.
-        LogPrintf("\nTestForBlock -> FAIL: nBlockSigOpsCost\n");
+        LogPrint("miner", "\nTestForBlock -> FAIL: nBlockSigOpsCost\n");
         return false;
     }
 
@@ -640,11 +640,11 @@ bool BlockAssembler::TestForBlock(CTxMemPool::txiter iter)
     // This can be removed once MTP is always enforced
     // as long as reorgs keep the mempool consistent.
     if (!IsFinalTx(iter->GetTx(), nHeight, nLockTimeCutoff)) {
-        LogPrintf("\nTestForBlock -> FAIL: !IsFinalTx()\n");
+        LogPrint("miner", "\nTestForBlock -> FAIL: !IsFinalTx()\n");
         return false;
     }
 
-    LogPrintf("\nTestForBlock -> OK\n");
+    LogPrint("miner", "\nTestForBlock -> OK\n");
     return true;
 }
 
@@ -888,12 +888,12 @@ void BlockAssembler::addPriorityTxs()
             // Size limits
             unsigned int nTxSize = ::GetSerializeSize(tx, SER_NETWORK, PROTOCOL_VERSION);
 
-            LogPrintf("\n\n######################################\n");
-            LogPrintf("nBlockMaxSize = %d\n", nBlockMaxSize);
-            LogPrintf("nBlockSize = %d\n", nBlockSize);
-            LogPrintf("nTxSize = %d\n", nTxSize);
-            LogPrintf("nBlockSize + nTxSize  = %d\n", nBlockSize + nTxSize);
-            LogPrintf("######################################\n\n\n");
+            LogPrint("miner", "\n\n######################################\n");
+            LogPrint("miner", "nBlockMaxSize = %d\n", nBlockMaxSize);
+            LogPrint("miner", "nBlockSize = %d\n", nBlockSize);
+            LogPrint("miner", "nTxSize = %d\n", nTxSize);
+            LogPrint("miner", "nBlockSize + nTxSize  = %d\n", nBlockSize + nTxSize);
+            LogPrint("miner", "######################################\n\n\n");
 
             if (nBlockSize + nTxSize >= nBlockMaxSize)
                 continue;
@@ -1207,6 +1207,9 @@ void ThreadStakeMiner(CWallet *pwallet, const CChainParams& chainparams)
 
     CReserveKey reservekey(pwallet);
 
+    // Coinbase-only template used for the kernel search
+    std::unique_ptr<CBlockTemplate> pkerneltemplate;
+
     bool fTestNet = (Params().NetworkIDString() == CBaseChainParams::TESTNET);
     bool fTryToSync = true;
     while (true)
@@ -1237,28 +1240,50 @@ void ThreadStakeMiner(CWallet *pwallet, const CChainParams& chainparams)
             }
 
             //
-            // Create new block
+            // Search for a kernel, mempool transactions are only selected once we know we can create a block
             //
             if (pwallet->HaveAvailableCoinsForStaking()) {
                 int64_t nFees = 0;
-                // First just create an empty block. No need to process transactions until we know we can create a block
-                std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(reservekey.reserveScript, {},true));
-                if (!pblocktemplate.get()) {
-                    LogPrintf("ThreadStakeMiner(): Could not get Blocktemplate\n");
-                    return;
+                // The empty template only depends on the tip, so it is reused until the tip changes
+                if (!pkerneltemplate || pkerneltemplate->block.hashPrevBlock != pindexPrev->GetBlockHash()) {
+                    pkerneltemplate.reset(BlockAssembler(Params()).CreateNewBlock(reservekey.reserveScript, {}, true, false));
+                    if (!pkerneltemplate.get()) {
+                        LogPrintf("ThreadStakeMiner(): Could not get Blocktemplate\n");
+                        return;
+                    }
                 }
 
-                CBlock *pblock = &pblocktemplate->block;
-                // Trying to sign a block
-                if (SignBlock(*pblock, *pwallet, nFees, pblocktemplate.get()))
+                CMutableTransaction txCoinStake;
+                CKey key;
+                if (CreateBlockCoinStake(pkerneltemplate->block, *pwallet, nFees, pkerneltemplate.get(), txCoinStake, key))
                 {
-                    // increase priority
-                    SetThreadPriority(THREAD_PRIORITY_ABOVE_NORMAL);
-                     // Check if stake check passes and process the new block
-                    CheckStake(pblock, *pwallet, chainparams);
-                    // return back to low priority
-                    SetThreadPriority(THREAD_PRIORITY_LOWEST);
-                    MilliSleep(5000);
+                    const CBlock& kernelBlock = pkerneltemplate->block;
+                    std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(reservekey.reserveScript, {}, true));
+                    if (!pblocktemplate.get()) {
+                        LogPrintf("ThreadStakeMiner(): Could not get Blocktemplate\n");
+                        return;
+                    }
+
+                    CBlock *pblock = &pblocktemplate->block;
+                    // Trying to sign a block, unless the tip moved while assembling it
+                    if (pblock->hashPrevBlock == kernelBlock.hashPrevBlock) {
+                        // The kernel was found for the time, target and payments of the empty template
+                        pblock->nTime = kernelBlock.nTime;
+                        pblock->nBits = kernelBlock.nBits;
+                        pblock->txoutShroudnode = kernelBlock.txoutShroudnode;
+                        pblock->voutSuperblock = kernelBlock.voutSuperblock;
+
+                        if (SignStakeBlock(*pblock, txCoinStake, key)) {
+                            // increase priority
+                            SetThreadPriority(THREAD_PRIORITY_ABOVE_NORMAL);
+                            // Check if stake check passes and process the new block
+                            CheckStake(pblock, *pwallet, chainparams);
+                            // return back to low priority
+                            SetThreadPriority(THREAD_PRIORITY_LOWEST);
+                            MilliSleep(5000);
+                        }
+                    }
+                    pkerneltemplate.reset();
                 }
             }
             MilliSleep(nMinerSleep);
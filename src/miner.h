@@ -166,8 +166,8 @@ private:
 
 public:
     BlockAssembler(const CChainParams& chainparams);
-    /** Construct a new block template with coinbase to scriptPubKeyIn */
-    CBlockTemplate* CreateNewBlock(const CScript& scriptPubKeyIn, const vector<uint256>& tx_ids,bool fProofOfStake = false);
+    /** Construct a new block template with coinbase to scriptPubKeyIn, without any mempool transactions if fAddMempoolTxs is false */
+    CBlockTemplate* CreateNewBlock(const CScript& scriptPubKeyIn, const vector<uint256>& tx_ids,bool fProofOfStake = false, bool fAddMempoolTxs = true);
     CBlockTemplate* CreateNewBlockWithKey(CReserveKey& reservekey);
 
 private:
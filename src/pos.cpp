@@ -68,9 +68,9 @@ bool CheckStakeBlockTimestamp(int64_t nTimeBlock)
 //   quantities so as to generate blocks faster, degrading the system back into
 //   a proof-of-work situation.
 //
-bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, unsigned int nBits, unsigned int nBlockTime, const CCoins* txPrev, const COutPoint& prevout, unsigned int nTimeTx, bool fPrintProofOfStake)
+bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, unsigned int nBits, unsigned int nBlockTime, const Coin& coinPrev, const COutPoint& prevout, unsigned int nTimeTx, bool fPrintProofOfStake)
 {
-      if ((nTimeTx < nBlockTime) && !(txPrev->nHeight <= Params().GetConsensus().nFirstPOSBlock))  // Transaction timestamp violation
+      if ((nTimeTx < nBlockTime) && !((int)coinPrev.nHeight <= Params().GetConsensus().nFirstPOSBlock))  // Transaction timestamp violation
         return false;
         // return error("CheckStakeKernelHash() : nTime violation");
 
@@ -79,7 +79,7 @@ bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, unsigned int nBits, uns
     bnTarget.SetCompact(nBits);
 
     // Weighted target
-    int64_t nValueIn = txPrev->vout[prevout.n].nValue;
+    int64_t nValueIn = coinPrev.out.nValue;
     if (nValueIn == 0)
         return error("CheckStakeKernelHash() : nValueIn = 0");
     arith_uint256 bnWeight = arith_uint256(nValueIn);
@@ -150,7 +150,7 @@ bool CheckProofOfStake(CBlockIndex* pindexPrev, const CTransaction& tx, unsigned
 
     unsigned int nTime = pindexPrev->GetBlockTime();
 
-    if (!CheckStakeKernelHash(pindexPrev, nBits, nTime, new CCoins(txPrev, pindexPrev->nHeight), txin.prevout, nBlockTime, fDebug))
+    if (!CheckStakeKernelHash(pindexPrev, nBits, nTime, Coin(txPrev.vout[txin.prevout.n], pindexPrev->nHeight, txPrev.IsCoinBase(), txPrev.IsCoinStake()), txin.prevout, nBlockTime, fDebug))
        return state.Invalid(false, REJECT_INVALID,"CheckProofOfStake() : INFO: check kernel failed on coinstake %s", tx.GetHash().ToString()); // may occur during initial download or if behind on block chain sync
     return true;
 }
@@ -203,16 +203,16 @@ bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t nTime, co
             return false;
         }
 
-        return CheckStakeKernelHash(pindexPrev, nBits, *pBlockTime, new CCoins(txPrev, pindexPrev->nHeight), prevout, nTime);
+        return CheckStakeKernelHash(pindexPrev, nBits, *pBlockTime, Coin(txPrev.vout[prevout.n], pindexPrev->nHeight, txPrev.IsCoinBase(), txPrev.IsCoinStake()), prevout, nTime);
     } else {
         //found in cache
         const CStakeCache& stake = it->second;
-        if (CheckStakeKernelHash(pindexPrev, nBits,nTime, new CCoins(stake.txPrev, pindexPrev->nHeight), prevout, *pBlockTime)) {
+        if (CheckStakeKernelHash(pindexPrev, nBits,nTime, Coin(stake.txPrev.vout[prevout.n], pindexPrev->nHeight, stake.txPrev.IsCoinBase(), stake.txPrev.IsCoinStake()), prevout, *pBlockTime)) {
             // Cache could potentially cause false positive stakes in the event of deep reorgs, so check without cache also
             return CheckKernel(pindexPrev, nBits, nTime, prevout);
         }
         // LogPrintf("CheckKernel()::CheckStakeKernelHash(): pBlockTime=%u, nTime=%u\n", *pBlockTime, nTime);
-        return CheckStakeKernelHash(pindexPrev, nBits, *pBlockTime, new CCoins(stake.txPrev, pindexPrev->nHeight), prevout, nTime);
+        return CheckStakeKernelHash(pindexPrev, nBits, *pBlockTime, Coin(stake.txPrev.vout[prevout.n], pindexPrev->nHeight, stake.txPrev.IsCoinBase(), stake.txPrev.IsCoinStake()), prevout, nTime);
     }
 }
 
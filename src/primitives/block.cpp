@@ -32,6 +32,24 @@ uint256 CBlockHeader::GetPoWHash() const {
     return HashX16RV2(BEGIN(nVersion), END(nNonce), hashPrevBlock);
 }
 
+void CBlockHeader::GetPoWHashes(uint32_t count, uint256 *hashes) const {
+    // The headers share hashPrevBlock and so the algorithms, hash them side by side
+    std::vector<CBlockHeader> headers(count, *this);
+    std::vector<const void*> data(count);
+    for (uint32_t i = 0; i < count; i++) {
+        headers[i].nNonce = nNonce + i;
+        data[i] = BEGIN(headers[i].nVersion);
+    }
+
+    unsigned char selection[16];
+    GetHashSelections(hashPrevBlock, selection);
+
+    std::vector<unsigned char> output(count * X16RV2_OUTPUT_SIZE);
+    X16RV2Lanes(selection, data.data(), END(nNonce) - BEGIN(nVersion), count, output.data());
+    for (uint32_t i = 0; i < count; i++)
+        memcpy(hashes[i].begin(), &output[i * X16RV2_OUTPUT_SIZE], X16RV2_OUTPUT_SIZE);
+}
+
 std::string CBlock::ToString() const {
     std::stringstream s;
     s << strprintf(
@@ -121,6 +121,9 @@ public:
 
     uint256 GetPoWHash() const;
 
+    // GetPoWHash of this header with each of the nonces nNonce, nNonce + 1, ..., nNonce + count - 1
+    void GetPoWHashes(uint32_t count, uint256 *hashes) const;
+
     uint256 GetHash() const;
 
     int64_t GetBlockTime() const
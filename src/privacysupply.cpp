@@ -0,0 +1,69 @@
+// Copyright (c) 2020 The ShroudX developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "privacysupply.h"
+
+#include "primitives/block.h"
+#include "sigma.h"
+#include "zerocoin.h"
+#include "sigma/remint.h"
+
+bool CPrivacySupply::ApplyBlock(const CBlock& block)
+{
+    bool fChanged = false;
+
+    if (block.zerocoinTxInfo) {
+        const CZerocoinTxInfo& info = *block.zerocoinTxInfo;
+
+        for (const auto& mint : info.mints) {
+            zerocoin[mint.first * COIN].nMinted++;
+            fChanged = true;
+        }
+
+        // Remint serials are reported together with the regular zerocoin spends, tell them apart
+        std::set<CBigNum> remintSerials;
+        for (const CTransaction& tx : block.vtx) {
+            if (tx.IsZerocoinRemint())
+                remintSerials.insert(sigma::CoinRemintToV3::GetSerialNumber(tx));
+        }
+
+        for (const auto& spend : info.spentSerials) {
+            CPrivacySupplyCounters& counters = zerocoin[spend.second * COIN];
+            if (remintSerials.count(spend.first) > 0)
+                counters.nReminted++;
+            else
+                counters.nSpent++;
+            fChanged = true;
+        }
+    }
+
+    if (block.sigmaTxInfo) {
+        const sigma::CSigmaTxInfo& info = *block.sigmaTxInfo;
+        int64_t denomination;
+
+        for (const sigma::PublicCoin& mint : info.mints) {
+            if (!sigma::DenominationToInteger(mint.getDenomination(), denomination))
+                continue;
+            sigma[denomination].nMinted++;
+            fChanged = true;
+        }
+
+        for (const auto& spend : info.spentSerials) {
+            if (!sigma::DenominationToInteger(spend.second.denomination, denomination))
+                continue;
+            sigma[denomination].nSpent++;
+            fChanged = true;
+        }
+    }
+
+    return fChanged;
+}
+
+CAmount CPrivacySupply::GetUnspentAmount(const Counters& counters)
+{
+    CAmount total = 0;
+    for (const auto& entry : counters)
+        total += entry.second.GetUnspentAmount(entry.first);
+    return total;
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2020 The ShroudX developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_PRIVACYSUPPLY_H
+#define BITCOIN_PRIVACYSUPPLY_H
+
+#include "amount.h"
+#include "serialize.h"
+
+#include <map>
+
+class CBlock;
+
+/** Number of coins of one denomination that were minted, spent and reminted to sigma. */
+struct CPrivacySupplyCounters
+{
+    uint64_t nMinted;
+    uint64_t nSpent;
+    uint64_t nReminted;
+
+    CPrivacySupplyCounters() : nMinted(0), nSpent(0), nReminted(0) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
+        READWRITE(VARINT(nMinted));
+        READWRITE(VARINT(nSpent));
+        READWRITE(VARINT(nReminted));
+    }
+
+    bool IsNull() const {
+        return nMinted == 0 && nSpent == 0 && nReminted == 0;
+    }
+
+    /** Amount of this denomination which is still held in unspent private coins. */
+    CAmount GetUnspentAmount(CAmount denomination) const {
+        return denomination * (CAmount(nMinted) - CAmount(nSpent) - CAmount(nReminted));
+    }
+};
+
+/**
+ * Running totals of zerocoin and sigma mints/spends, maintained in ConnectBlock/DisconnectBlock.
+ *
+ * Counters are keyed by the denomination value in satoshis. A record is written to the block tree
+ * database for every block which changes the counters; nPrevHeight links it to the previous record
+ * so that disconnecting a block is a single read.
+ */
+class CPrivacySupply
+{
+public:
+    typedef std::map<CAmount, CPrivacySupplyCounters> Counters;
+
+    int nHeight;
+    int nPrevHeight;
+    Counters zerocoin;
+    Counters sigma;
+
+    CPrivacySupply() {
+        SetNull();
+    }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
+        READWRITE(nHeight);
+        READWRITE(nPrevHeight);
+        READWRITE(zerocoin);
+        READWRITE(sigma);
+    }
+
+    void SetNull() {
+        nHeight = -1;
+        nPrevHeight = -1;
+        zerocoin.clear();
+        sigma.clear();
+    }
+
+    bool IsNull() const {
+        return nHeight < 0;
+    }
+
+    /**
+     * Adds mints and spends of the block to the counters. Relies on block.zerocoinTxInfo and
+     * block.sigmaTxInfo being completed by ConnectBlock. Returns false if the block doesn't touch
+     * the privacy supply.
+     */
+    bool ApplyBlock(const CBlock& block);
+
+    static CAmount GetUnspentAmount(const Counters& counters);
+};
+
+/** Block tree database key of a CPrivacySupply record, height is big endian to allow range reads. */
+struct CPrivacySupplyHeightKey
+{
+    int nHeight;
+
+    CPrivacySupplyHeightKey() : nHeight(0) {}
+    explicit CPrivacySupplyHeightKey(int height) : nHeight(height) {}
+
+    size_t GetSerializeSize(int nType, int nVersion) const {
+        return 4;
+    }
+    template<typename Stream>
+    void Serialize(Stream& s, int nType, int nVersion) const {
+        ser_writedata32be(s, nHeight);
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s, int nType, int nVersion) {
+        nHeight = ser_readdata32be(s);
+    }
+};
+
+#endif // BITCOIN_PRIVACYSUPPLY_H
@@ -862,9 +862,12 @@ bool WalletModel::rebroadcastTransaction(uint256 hash)
         return false;
 
     CCoinsViewCache &view = *pcoinsTip;
-    const CCoins* existingCoins = view.AccessCoins(hash);
+    bool fHaveChain = false;
+    for (size_t o = 0; !fHaveChain && o < wtx->vout.size(); o++) {
+        const Coin& existingCoin = view.AccessCoin(COutPoint(hash, o));
+        fHaveChain = !existingCoin.IsSpent();
+    }
     bool fHaveMempool = mempool.exists(hash);
-    bool fHaveChain = existingCoins && existingCoins->nHeight < 1000000000;
     if (!fHaveMempool && !fHaveChain) {
         // push to local node and sync with wallets
         CValidationState state;
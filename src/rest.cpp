@@ -10,6 +10,7 @@
 #include "main.h"
 #include "httpserver.h"
 #include "rpc/server.h"
+#include "sigma.h"
 #include "streams.h"
 #include "sync.h"
 #include "txmempool.h"
@@ -43,16 +44,20 @@ static const struct {
 };
 
 struct CCoin {
-    uint32_t nTxVer; // Don't call this nVersion, that name has a special meaning inside IMPLEMENT_SERIALIZE
     uint32_t nHeight;
     CTxOut out;
 
+    CCoin() : nHeight(0) {}
+    CCoin(Coin&& in) : nHeight(in.nHeight), out(std::move(in.out)) {}
+
     ADD_SERIALIZE_METHODS;
 
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion)
     {
-        READWRITE(nTxVer);
+        // Transaction versions are not stored with the coins anymore, zero keeps the reply format
+        uint32_t nTxVerDummy = 0;
+        READWRITE(nTxVerDummy);
         READWRITE(nHeight);
         READWRITE(out);
     }
@@ -64,6 +69,8 @@ extern UniValue mempoolInfoToJSON();
 extern UniValue mempoolToJSON(bool fVerbose = false);
 extern void ScriptPubKeyToJSON(const CScript& scriptPubKey, UniValue& out, bool fIncludeHex);
 extern UniValue blockheaderToJSON(const CBlockIndex* blockindex);
+extern void anonymitySetToStream(CDataStream& stream, const CBlockIndex* blockindex, const std::vector<sigma::PublicCoin>& coins);
+extern UniValue anonymitySetToJSON(const CBlockIndex* blockindex, const std::vector<sigma::PublicCoin>& coins);
 
 static bool RESTERR(HTTPRequest* req, enum HTTPStatusCode status, string message)
 {
@@ -517,21 +524,10 @@ static bool rest_getutxos(HTTPRequest* req, const std::string& strURIPart)
             view.SetBackend(viewMempool); // switch cache backend to db+mempool in case user likes to query mempool
 
         for (size_t i = 0; i < vOutPoints.size(); i++) {
-            CCoins coins;
-            uint256 hash = vOutPoints[i].hash;
-            if (view.GetCoins(hash, coins)) {
-                mempool.pruneSpent(hash, coins);
-                if (coins.IsAvailable(vOutPoints[i].n)) {
-                    hits[i] = true;
-                    // Safe to index into vout here because IsAvailable checked if it's off the end of the array, or if
-                    // n is valid but points to an already spent output (IsNull).
-                    CCoin coin;
-                    coin.nTxVer = coins.nVersion;
-                    coin.nHeight = coins.nHeight;
-                    coin.out = coins.vout.at(vOutPoints[i].n);
-                    assert(!coin.out.IsNull());
-                    outs.push_back(coin);
-                }
+            Coin coin;
+            if (view.GetCoin(vOutPoints[i], coin) && !mempool.isSpent(vOutPoints[i])) {
+                hits[i] = true;
+                outs.push_back(CCoin(std::move(coin)));
             }
 
             bitmapStringRepresentation.append(hits[i] ? "1" : "0"); // form a binary string representation (human-readable for json output)
@@ -574,7 +570,6 @@ static bool rest_getutxos(HTTPRequest* req, const std::string& strURIPart)
         UniValue utxos(UniValue::VARR);
         BOOST_FOREACH (const CCoin& coin, outs) {
             UniValue utxo(UniValue::VOBJ);
-            utxo.push_back(Pair("txvers", (int32_t)coin.nTxVer));
             utxo.push_back(Pair("height", (int32_t)coin.nHeight));
             utxo.push_back(Pair("value", ValueFromAmount(coin.out.nValue)));
 
@@ -601,6 +596,94 @@ static bool rest_getutxos(HTTPRequest* req, const std::string& strURIPart)
     return true; // continue to process further HTTP reqs on this cxn
 }
 
+static bool rest_anonymityset(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    vector<string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+
+    if (path.size() < 2 || path.size() > 4)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Use /rest/anonymityset/<denomination>/<groupid>[/<maxheight>][/<sinceblock>].<ext>");
+
+    sigma::CoinDenomination denomination;
+    if (!sigma::StringToDenomination(path[0], denomination))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid denomination: " + path[0]);
+
+    int groupId;
+    if (!ParseInt32(path[1], &groupId))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid group id: " + path[1]);
+
+    // the block hash of an earlier reply, which is also its ETag, asks for the coins minted since then
+    uint256 sinceBlock;
+    if (path.size() == 4 || (path.size() == 3 && path[2].size() == 64)) {
+        if (!ParseHashStr(path.back(), sinceBlock))
+            return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + path.back());
+        path.pop_back();
+    }
+
+    int maxHeight = -1;
+    if (path.size() == 3 && (!ParseInt32(path[2], &maxHeight) || maxHeight < 0))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid height: " + path[2]);
+
+    uint256 blockHash;
+    std::vector<sigma::PublicCoin> coins;
+    const CBlockIndex* blockindex = NULL;
+    {
+        LOCK(cs_main);
+        if (maxHeight < 0)
+            maxHeight = chainActive.Height();
+        if (!sigma::CSigmaState::GetState()->GetAnonymitySet(denomination, groupId, maxHeight, sinceBlock, blockHash, coins))
+            return RESTERR(req, HTTP_NOT_FOUND, "Coin group or block not found");
+        if (!blockHash.IsNull())
+            blockindex = mapBlockIndex[blockHash];
+    }
+
+    // The set is fully determined by its latest block, clients holding it already get an empty reply
+    std::string etag = "\"" + blockHash.GetHex() + "\"";
+    req->WriteHeader("ETag", etag);
+    std::pair<bool, std::string> ifNoneMatch = req->GetHeader("If-None-Match");
+    if (ifNoneMatch.first && ifNoneMatch.second == etag) {
+        req->WriteReply(HTTP_NOT_MODIFIED);
+        return true;
+    }
+
+    switch (rf) {
+    case RF_BINARY: {
+        CDataStream ssAnonymitySet(SER_NETWORK, PROTOCOL_VERSION);
+        anonymitySetToStream(ssAnonymitySet, blockindex, coins);
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, ssAnonymitySet.str());
+        return true;
+    }
+
+    case RF_HEX: {
+        CDataStream ssAnonymitySet(SER_NETWORK, PROTOCOL_VERSION);
+        anonymitySetToStream(ssAnonymitySet, blockindex, coins);
+        string strHex = HexStr(ssAnonymitySet.begin(), ssAnonymitySet.end()) + "\n";
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, strHex);
+        return true;
+    }
+
+    case RF_JSON: {
+        string strJSON = anonymitySetToJSON(blockindex, coins).write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+
+    // not reached
+    return true; // continue to process further HTTP reqs on this cxn
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(HTTPRequest* req, const std::string& strReq);
@@ -613,6 +696,7 @@ static const struct {
       {"/rest/mempool/contents", rest_mempool_contents},
       {"/rest/headers/", rest_headers},
       {"/rest/getutxos", rest_getutxos},
+      {"/rest/anonymityset/", rest_anonymityset},
 };
 
 bool StartREST()
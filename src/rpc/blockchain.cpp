@@ -20,6 +20,7 @@
 #include "utilstrencodings.h"
 #include "hash.h"
 #include "base58.h"
+#include "sigma.h"
 #include <stdint.h>
 
 #include <univalue.h>
@@ -776,6 +777,20 @@ struct CCoinsStats
     CCoinsStats() : nHeight(0), nTransactions(0), nTransactionOutputs(0), nSerializedSize(0), nTotalAmount(0) {}
 };
 
+static void ApplyStats(CCoinsStats &stats, CHashWriter& ss, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
+{
+    assert(!outputs.empty());
+    ss << hash;
+    stats.nTransactions++;
+    for (std::map<uint32_t, Coin>::const_iterator it = outputs.begin(); it != outputs.end(); ++it) {
+        ss << VARINT(it->first + 1);
+        ss << it->second.out;
+        stats.nTransactionOutputs++;
+        stats.nTotalAmount += it->second.out.nValue;
+    }
+    ss << VARINT(0);
+}
+
 //! Calculate statistics about the unspent transaction output set
 static bool GetUTXOStats(CCoinsView *view, CCoinsStats &stats)
 {
@@ -788,32 +803,31 @@ static bool GetUTXOStats(CCoinsView *view, CCoinsStats &stats)
         stats.nHeight = mapBlockIndex.find(stats.hashBlock)->second->nHeight;
     }
     ss << stats.hashBlock;
-    CAmount nTotalAmount = 0;
+    // Outputs come sorted by outpoint, group them per transaction so the hash matches the one
+    // computed from per-transaction records
+    uint256 prevkey;
+    std::map<uint32_t, Coin> outputs;
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
-        uint256 key;
-        CCoins coins;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coins)) {
-            stats.nTransactions++;
-            ss << key;
-            for (unsigned int i=0; i<coins.vout.size(); i++) {
-                const CTxOut &out = coins.vout[i];
-                if (!out.IsNull()) {
-                    stats.nTransactionOutputs++;
-                    ss << VARINT(i+1);
-                    ss << out;
-                    nTotalAmount += out.nValue;
-                }
+        COutPoint key;
+        Coin coin;
+        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
+            if (!outputs.empty() && key.hash != prevkey) {
+                ApplyStats(stats, ss, prevkey, outputs);
+                outputs.clear();
             }
+            prevkey = key.hash;
+            outputs[key.n] = std::move(coin);
             stats.nSerializedSize += 32 + pcursor->GetValueSize();
-            ss << VARINT(0);
         } else {
             return error("%s: unable to read value", __func__);
         }
         pcursor->Next();
     }
+    if (!outputs.empty()) {
+        ApplyStats(stats, ss, prevkey, outputs);
+    }
     stats.hashSerialized = ss.GetHash();
-    stats.nTotalAmount = nTotalAmount;
     return true;
 }
 
@@ -882,8 +896,8 @@ UniValue gettxout(const UniValue& params, bool fHelp)
             "        ,...\n"
             "     ]\n"
             "  },\n"
-            "  \"version\" : n,            (numeric) The version\n"
             "  \"coinbase\" : true|false   (boolean) Coinbase or not\n"
+            "  \"coinstake\" : true|false  (boolean) Coinstake or not\n"
             "}\n"
 
             "\nExamples:\n"
@@ -906,37 +920,131 @@ UniValue gettxout(const UniValue& params, bool fHelp)
     if (params.size() > 2)
         fMempool = params[2].get_bool();
 
-    CCoins coins;
+    if (n < 0)
+        return NullUniValue;
+    COutPoint out(hash, n);
+
+    Coin coin;
     if (fMempool) {
         LOCK(mempool.cs);
         CCoinsViewMemPool view(pcoinsTip, mempool);
-        if (!view.GetCoins(hash, coins))
+        if (!view.GetCoin(out, coin) || mempool.isSpent(out)) // TODO: filtering spent coins should be done by the CCoinsViewMemPool
             return NullUniValue;
-        mempool.pruneSpent(hash, coins); // TODO: this should be done by the CCoinsViewMemPool
     } else {
-        if (!pcoinsTip->GetCoins(hash, coins))
+        if (!pcoinsTip->GetCoin(out, coin))
             return NullUniValue;
     }
-    if (n<0 || (unsigned int)n>=coins.vout.size() || coins.vout[n].IsNull())
-        return NullUniValue;
 
     BlockMap::iterator it = mapBlockIndex.find(pcoinsTip->GetBestBlock());
     CBlockIndex *pindex = it->second;
     ret.push_back(Pair("bestblock", pindex->GetBlockHash().GetHex()));
-    if ((unsigned int)coins.nHeight == MEMPOOL_HEIGHT)
+    if (coin.nHeight == MEMPOOL_HEIGHT)
         ret.push_back(Pair("confirmations", 0));
     else
-        ret.push_back(Pair("confirmations", pindex->nHeight - coins.nHeight + 1));
-    ret.push_back(Pair("value", ValueFromAmount(coins.vout[n].nValue)));
+        ret.push_back(Pair("confirmations", (int64_t)(pindex->nHeight - (int)coin.nHeight + 1)));
+    ret.push_back(Pair("value", ValueFromAmount(coin.out.nValue)));
     UniValue o(UniValue::VOBJ);
-    ScriptPubKeyToJSON(coins.vout[n].scriptPubKey, o, true);
+    ScriptPubKeyToJSON(coin.out.scriptPubKey, o, true);
     ret.push_back(Pair("scriptPubKey", o));
-    ret.push_back(Pair("version", coins.nVersion));
-    ret.push_back(Pair("coinbase", coins.fCoinBase));
+    ret.push_back(Pair("coinbase", (bool)coin.fCoinBase));
+    ret.push_back(Pair("coinstake", (bool)coin.fCoinStake));
 
     return ret;
 }
 
+void anonymitySetToStream(CDataStream& stream, const CBlockIndex* blockindex, const std::vector<sigma::PublicCoin>& coins)
+{
+    stream << (blockindex ? blockindex->GetBlockHash() : uint256()) << (blockindex ? blockindex->nHeight : -1) << coins;
+}
+
+UniValue anonymitySetToJSON(const CBlockIndex* blockindex, const std::vector<sigma::PublicCoin>& coins)
+{
+    UniValue result(UniValue::VOBJ);
+    if (blockindex) {
+        result.push_back(Pair("blockhash", blockindex->GetBlockHash().GetHex()));
+        result.push_back(Pair("height", blockindex->nHeight));
+    }
+    result.push_back(Pair("count", (int64_t)coins.size()));
+    UniValue values(UniValue::VARR);
+    BOOST_FOREACH(const sigma::PublicCoin& coin, coins)
+        values.push_back(coin.getValue().GetHex());
+    result.push_back(Pair("coins", values));
+    return result;
+}
+
+UniValue getanonymityset(const UniValue& params, bool fHelp)
+{
+    if (fHelp || params.size() < 2 || params.size() > 5)
+        throw runtime_error(
+            "getanonymityset \"denomination\" groupid ( maxheight \"format\" \"sinceblock\" )\n"
+            "\nReturns the sigma coins minted with the given denomination and group id, which spends of the group\n"
+            "are proven against. Coins of later blocks come first.\n"
+            "\nArguments:\n"
+            "1. \"denomination\"  (string, required) 0.05, 0.1, 0.5, 1, 10, 25 or 100\n"
+            "2. groupid          (numeric, required) The coin group id\n"
+            "3. maxheight        (numeric, optional, default=tip) Leave out coins minted after this height\n"
+            "4. \"format\"        (string, optional, default=\"json\") \"json\" or \"binary\" for the serialized set, hex-encoded\n"
+            "5. \"sinceblock\"    (string, optional) Only return coins minted after this block, the blockhash of an earlier reply\n"
+            "\nResult (for format = \"json\"):\n"
+            "{\n"
+            "  \"blockhash\" : \"hash\",    (string) The latest block minting coins of the set\n"
+            "  \"height\" : n,            (numeric) The height of that block\n"
+            "  \"count\" : n,             (numeric) The number of coins returned\n"
+            "  \"coins\" : [              (array of string) The public coin values\n"
+            "    \"hex\", ...\n"
+            "  ]\n"
+            "}\n"
+            "\nResult (for format = \"binary\"):\n"
+            "\"data\"                    (string) Serialized blockhash, height and coins, hex-encoded\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getanonymityset", "\"0.1\" 1")
+            + HelpExampleCli("getanonymityset", "\"0.1\" 1 200000 \"binary\"")
+            + HelpExampleRpc("getanonymityset", "\"0.1\", 1")
+        );
+
+    sigma::CoinDenomination denomination;
+    if (!sigma::StringToDenomination(params[0].get_str(), denomination))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid denomination");
+
+    int groupId = params[1].get_int();
+
+    LOCK(cs_main);
+
+    int maxHeight = chainActive.Height();
+    if (params.size() > 2 && !params[2].isNull()) {
+        maxHeight = params[2].get_int();
+        if (maxHeight < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Block height out of range");
+    }
+
+    bool fBinary = false;
+    if (params.size() > 3 && !params[3].isNull()) {
+        std::string format = params[3].get_str();
+        if (format == "binary")
+            fBinary = true;
+        else if (format != "json")
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid format, use \"json\" or \"binary\"");
+    }
+
+    uint256 sinceBlock;
+    if (params.size() > 4 && !params[4].isNull())
+        sinceBlock = ParseHashV(params[4], "sinceblock");
+
+    uint256 blockHash;
+    std::vector<sigma::PublicCoin> coins;
+    if (!sigma::CSigmaState::GetState()->GetAnonymitySet(denomination, groupId, maxHeight, sinceBlock, blockHash, coins))
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, sinceBlock.IsNull() ? "Coin group not found" : "Coin group or block not found");
+
+    const CBlockIndex* blockindex = blockHash.IsNull() ? NULL : mapBlockIndex[blockHash];
+
+    if (fBinary) {
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        anonymitySetToStream(stream, blockindex, coins);
+        return HexStr(stream.begin(), stream.end());
+    }
+    return anonymitySetToJSON(blockindex, coins);
+}
+
 UniValue verifychain(const UniValue& params, bool fHelp)
 {
     int nCheckLevel = GetArg("-checklevel", DEFAULT_CHECKLEVEL);
@@ -1353,6 +1461,7 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getblockheader",         &getblockheader,         true  },
     { "blockchain",         "getchaintips",           &getchaintips,           true  },
     { "blockchain",         "getdifficulty",          &getdifficulty,          true  },
+    { "blockchain",         "getanonymityset",        &getanonymityset,        true  },
     { "blockchain",         "getmempoolancestors",    &getmempoolancestors,    true  },
     { "blockchain",         "getmempooldescendants",  &getmempooldescendants,  true  },
     { "blockchain",         "getmempoolentry",        &getmempoolentry,        true  },
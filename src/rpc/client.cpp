@@ -119,6 +119,10 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getaddressdeltas", 0},
     { "getaddressutxos", 0},
     { "getaddressmempool", 0},
+    { "getprivacysupply", 0},
+    { "getprivacysupply", 1},
+    { "getanonymityset", 1 },
+    { "getanonymityset", 2 },
         //[index]
     { "setmininput", 0 },
     {"spork", 1},
@@ -76,6 +76,7 @@ UniValue getnetworkhashps(const UniValue& params, bool fHelp)
 UniValue generateBlocks(boost::shared_ptr<CReserveScript> coinbaseScript, int nGenerate, uint64_t nMaxTries, bool keepScript)
 {
     static const int nInnerLoopCount = 0x10000;
+    static const uint32_t nNonceBatch = 8;
     int nHeightStart = 0;
     int nHeightEnd = 0;
     int nHeight = 0;
@@ -99,9 +100,19 @@ UniValue generateBlocks(boost::shared_ptr<CReserveScript> coinbaseScript, int nG
             LOCK(cs_main);
             IncrementExtraNonce(pblock, chainActive.Tip(), nExtraNonce);
         }
-        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount && !CheckProofOfWork(pblock->GetPoWHash(), pblock->nBits, Params().GetConsensus())) {
-            ++pblock->nNonce;
-            --nMaxTries;
+        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount) {
+            // Try a few nonces at once, hashing them together is faster
+            uint256 hashes[nNonceBatch];
+            uint32_t count = std::min<uint64_t>(std::min<uint64_t>(nNonceBatch, nMaxTries), nInnerLoopCount - pblock->nNonce);
+            pblock->GetPoWHashes(count, hashes);
+
+            uint32_t tried = 0;
+            while (tried < count && !CheckProofOfWork(hashes[tried], pblock->nBits, Params().GetConsensus()))
+                tried++;
+            pblock->nNonce += tried;
+            nMaxTries -= tried;
+            if (tried < count)
+                break;
         }
         if (nMaxTries == 0) {
             break;
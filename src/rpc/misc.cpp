@@ -866,6 +866,8 @@ UniValue getaddressdeltas(const UniValue& params, bool fHelp)
                         "    ]\n"
                         "  \"start\" (number) The start block height\n"
                         "  \"end\" (number) The end block height\n"
+                        "  \"limit\" (number, optional) Return about this many deltas per address, the last block is always returned\n"
+                        "            completely so the next page can be requested with start set to the last height + 1\n"
                         "}\n"
                         "\nResult:\n"
                         "[\n"
@@ -886,9 +888,11 @@ UniValue getaddressdeltas(const UniValue& params, bool fHelp)
 
     UniValue startValue = find_value(params[0].get_obj(), "start");
     UniValue endValue = find_value(params[0].get_obj(), "end");
+    UniValue limitValue = find_value(params[0].get_obj(), "limit");
 
     int start = 0;
     int end = 0;
+    int limit = 0;
 
     if (startValue.isNum() && endValue.isNum()) {
         start = startValue.get_int();
@@ -898,6 +902,13 @@ UniValue getaddressdeltas(const UniValue& params, bool fHelp)
         }
     }
 
+    if (limitValue.isNum()) {
+        limit = limitValue.get_int();
+        if (limit < 0) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Limit is expected to be positive");
+        }
+    }
+
     std::vector<std::pair<uint160, AddressType> > addresses;
 
     if (!getAddressesFromParams(params, addresses)) {
@@ -908,11 +919,11 @@ UniValue getaddressdeltas(const UniValue& params, bool fHelp)
 
     for (std::vector<std::pair<uint160, AddressType> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
         if (start > 0 && end > 0) {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
+            if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end, limit)) {
                 throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
             }
         } else {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+            if (!GetAddressIndex((*it).first, (*it).second, addressIndex, 0, 0, limit)) {
                 throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
             }
         }
@@ -957,6 +968,9 @@ UniValue getaddressbalance(const UniValue& params, bool fHelp)
                         "{\n"
                         "  \"balance\"  (string) The current balance in duffs\n"
                         "  \"received\"  (string) The total number of duffs received (including change)\n"
+                        "  \"utxos\"  (number) The number of unspent outputs\n"
+                        "  \"firstheight\"  (number) The height of the first block touching the address(es), -1 if none\n"
+                        "  \"lastheight\"  (number) The height of the last block touching the address(es), -1 if none\n"
                         "}\n"
                         "\nExamples:\n"
                 + HelpExampleCli("getaddressbalance", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
@@ -969,27 +983,38 @@ UniValue getaddressbalance(const UniValue& params, bool fHelp)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    CAddressBalanceValue total;
 
     for (std::vector<std::pair<uint160, AddressType> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address. If this is not an address in your wallet, set addressindex=1 in the conf file.");
+        CAddressBalanceValue value;
+        if (!GetAddressBalance((*it).first, (*it).second, value)) {
+            // No aggregate index, sum up the deltas
+            std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address. If this is not an address in your wallet, set addressindex=1 in the conf file.");
+            }
+            for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator delta=addressIndex.begin(); delta!=addressIndex.end(); delta++) {
+                value.ApplyDelta(delta->first, delta->second);
+            }
         }
-    }
 
-    CAmount balance = 0;
-    CAmount received = 0;
+        if (value.IsNull())
+            continue;
 
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        if (it->second > 0) {
-            received += it->second;
-        }
-        balance += it->second;
+        total.balance += value.balance;
+        total.received += value.received;
+        total.utxoCount += value.utxoCount;
+        if (total.firstHeight == -1 || value.firstHeight < total.firstHeight)
+            total.firstHeight = value.firstHeight;
+        total.lastHeight = std::max(total.lastHeight, value.lastHeight);
     }
 
     UniValue result(UniValue::VOBJ);
-    result.push_back(Pair("balance", balance));
-    result.push_back(Pair("received", received));
+    result.push_back(Pair("balance", total.balance));
+    result.push_back(Pair("received", total.received));
+    result.push_back(Pair("utxos", total.utxoCount));
+    result.push_back(Pair("firstheight", total.firstHeight));
+    result.push_back(Pair("lastheight", total.lastHeight));
 
     return result;
 
@@ -1153,6 +1178,92 @@ UniValue gettotalsupply(const UniValue& params, bool fHelp)
     return result;
 }
 
+namespace {
+UniValue privacySupplyCountersToJSON(CPrivacySupply::Counters const & counters)
+{
+    UniValue denominations(UniValue::VARR);
+    for (auto const & entry : counters) {
+        UniValue denomination(UniValue::VOBJ);
+        denomination.push_back(Pair("denomination", entry.first));
+        denomination.push_back(Pair("minted", entry.second.nMinted));
+        denomination.push_back(Pair("spent", entry.second.nSpent));
+        denomination.push_back(Pair("reminted", entry.second.nReminted));
+        denomination.push_back(Pair("total", entry.second.GetUnspentAmount(entry.first)));
+        denominations.push_back(denomination);
+    }
+
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair("total", CPrivacySupply::GetUnspentAmount(counters)));
+    result.push_back(Pair("denominations", denominations));
+    return result;
+}
+
+UniValue privacySupplyToJSON(CPrivacySupply const & supply)
+{
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair("height", supply.nHeight));
+    result.push_back(Pair("zerocoin", privacySupplyCountersToJSON(supply.zerocoin)));
+    result.push_back(Pair("sigma", privacySupplyCountersToJSON(supply.sigma)));
+    return result;
+}
+}
+
+UniValue getprivacysupply(const UniValue& params, bool fHelp)
+{
+    if (fHelp || params.size() == 1 || params.size() > 2)
+        throw runtime_error(
+                "getprivacysupply ( start end )\n"
+                        "\nReturns the zerocoin and sigma supply per denomination.\n"
+                        "If start and end are given, returns the supply after every block in the range which changed it.\n"
+                        "\nArguments:\n"
+                        "1. start  (numeric, optional) The start block height\n"
+                        "2. end    (numeric, optional) The end block height\n"
+                        "\nResult:\n"
+                        "{\n"
+                        "  \"height\"  (number) The height of the last block which changed the supply\n"
+                        "  \"zerocoin\": {\n"
+                        "    \"total\"  (number) The amount held in unspent zerocoin mints in duffs\n"
+                        "    \"denominations\": [\n"
+                        "      {\n"
+                        "        \"denomination\"  (number) The denomination in duffs\n"
+                        "        \"minted\"  (number) The number of coins minted\n"
+                        "        \"spent\"  (number) The number of coins spent\n"
+                        "        \"reminted\"  (number) The number of coins reminted to sigma\n"
+                        "        \"total\"  (number) The unspent amount of the denomination in duffs\n"
+                        "      }, ...\n"
+                        "    ]\n"
+                        "  }\n"
+                        "  \"sigma\": { ... }  (object) Same as zerocoin\n"
+                        "}\n"
+                        "\nExamples:\n"
+                + HelpExampleCli("getprivacysupply", "")
+                + HelpExampleCli("getprivacysupply", "1000 2000")
+                + HelpExampleRpc("getprivacysupply", "1000, 2000")
+        );
+
+    if (params.size() == 2) {
+        int start = params[0].get_int();
+        int end = params[1].get_int();
+        if (start < 0 || end < start)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid block height range");
+
+        std::vector<CPrivacySupply> history;
+        if (!GetPrivacySupplyHistory(start, end, history))
+            throw JSONRPCError(RPC_DATABASE_ERROR, "Cannot read the privacy supply from the database. This functionality requires -addressindex to be enabled. Enabling -addressindex requires reindexing.");
+
+        UniValue result(UniValue::VARR);
+        for (CPrivacySupply const & supply : history)
+            result.push_back(privacySupplyToJSON(supply));
+        return result;
+    }
+
+    CPrivacySupply supply;
+    if (!GetPrivacySupply(supply))
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Cannot read the privacy supply from the database. This functionality requires -addressindex to be enabled. Enabling -addressindex requires reindexing.");
+
+    return privacySupplyToJSON(supply);
+}
+
 namespace {
 bool getZerocoinSupply(CAmount & amount) {
     using idx_rec = std::pair<CAddressIndexKey, CAmount>;
@@ -1308,6 +1419,7 @@ static const CRPCCommand commands[] =
     { "addressindex",       "getaddresstxids",        &getaddresstxids,        false },
     { "addressindex",       "getaddressbalance",      &getaddressbalance,      false },
     { "addressindex",       "gettotalsupply",         &gettotalsupply,         false },
+    { "addressindex",       "getprivacysupply",       &getprivacysupply,       false },
 
     /* Not shown in help */
     { "hidden",             "setmocktime",            &setmocktime,            true  },
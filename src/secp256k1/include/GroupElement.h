@@ -15,6 +15,7 @@ namespace secp_primitives {
 class GroupElement final {
 public:
     static constexpr std::size_t serialize_size = 34;
+    static constexpr std::size_t affine_size = 64;
 
 public:
 
@@ -103,6 +104,13 @@ public:
 
   std::size_t hash() const;
 
+  // Writes the affine coordinates x and y, 64 bytes in total, or zeros for the point at infinity.
+  void get_affine_coordinates(unsigned char* buffer) const;
+
+  // Converts the point to affine form (z == 1), later comparisons, hashing and serialization of it
+  // then skip the field inversion.
+  GroupElement& normalize();
+
   GroupElement& set_base_g();
 
   friend class MultiExponent;
@@ -14,7 +14,9 @@
 
 #include <openssl/rand.h>
 
+#include <algorithm>
 #include <array>
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -24,9 +26,22 @@
 static secp256k1_ecmult_context ctx;
 
 // Converts the value from secp256k1_gej to secp256k1_ge and returns.
+static bool gej_is_affine(const secp256k1_gej &gej)
+{
+    static const secp256k1_fe one = SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 1);
+    secp256k1_fe z(gej.z);
+    secp256k1_fe_normalize_var(&z);
+    return secp256k1_fe_cmp_var(&z, &one) == 0;
+}
+
 static secp256k1_ge gej_to_ge(const secp256k1_gej &gej)
 {
     secp256k1_ge ge;
+    // Deserialized and normalized points already have z == 1 and don't need the field inversion
+    if (!gej.infinity && gej_is_affine(gej)) {
+        secp256k1_ge_set_xy(&ge, &gej.x, &gej.y);
+        return ge;
+    }
     secp256k1_gej j(gej);
     secp256k1_ge_set_gej(&ge, &j);
     return ge;
@@ -536,19 +551,44 @@ std::vector<unsigned char> GroupElement::getvch() const {
     return result;
 }
 
-std::size_t GroupElement::hash() const
+void GroupElement::get_affine_coordinates(unsigned char* buffer) const
 {
     auto ge = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
-    std::array<unsigned char, 32 * 2> coord;
 
     if (ge.infinity) {
-        coord.fill(0);
-    } else {
-        secp256k1_fe_get_b32(&coord[0], &ge.x);
-        secp256k1_fe_get_b32(&coord[32], &ge.y);
+        std::fill(buffer, buffer + affine_size, 0);
+        return;
     }
 
-    return std::hash<std::string>()(std::string(coord.begin(), coord.end()));
+    secp256k1_fe_normalize_var(&ge.x);
+    secp256k1_fe_normalize_var(&ge.y);
+    secp256k1_fe_get_b32(buffer, &ge.x);
+    secp256k1_fe_get_b32(buffer + 32, &ge.y);
+}
+
+GroupElement& GroupElement::normalize()
+{
+    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    if (g->infinity || gej_is_affine(*g))
+        return *this;
+
+    auto ge = gej_to_ge(*g);
+    secp256k1_fe_normalize_var(&ge.x);
+    secp256k1_fe_normalize_var(&ge.y);
+    secp256k1_gej_set_ge(g, &ge);
+    return *this;
+}
+
+std::size_t GroupElement::hash() const
+{
+    std::array<unsigned char, affine_size> coord;
+    get_affine_coordinates(coord.data());
+
+    // The coordinates are uniformly distributed, there is no need to hash them again
+    std::size_t x, y;
+    std::memcpy(&x, &coord[0], sizeof(x));
+    std::memcpy(&y, &coord[32], sizeof(y));
+    return x ^ y;
 }
 
 const void* GroupElement::get_value() const {
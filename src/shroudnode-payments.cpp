@@ -188,6 +188,8 @@ void CShroudnodePayments::Clear() {
     LOCK2(cs_mapShroudnodeBlocks, cs_mapShroudnodePaymentVotes);
     mapShroudnodeBlocks.clear();
     mapShroudnodePaymentVotes.clear();
+    mapScheduledPayees.clear();
+    mapScheduledPayeeCounts.clear();
 }
 
 bool CShroudnodePayments::CanVote(COutPoint outShroudnode, int nBlockHeight) {
@@ -415,18 +417,55 @@ bool CShroudnodePayments::IsScheduled(CShroudnode &mn, int nNotBlockHeight) {
 
     if (!pCurrentBlockIndex) return false;
 
-    CScript mnpayee;
-    mnpayee = GetScriptForDestination(mn.pubKeyCollateralAddress.GetID());
+    CKeyID mnpayee = mn.pubKeyCollateralAddress.GetID();
 
-    CScript payee;
-    for (int64_t h = pCurrentBlockIndex->nHeight; h <= pCurrentBlockIndex->nHeight + 8; h++) {
-        if (h == nNotBlockHeight) continue;
-        if (mapShroudnodeBlocks.count(h) && mapShroudnodeBlocks[h].GetBestPayee(payee) && mnpayee == payee) {
-            return true;
-        }
+    std::unordered_map<CKeyID, int, CKeyIDHasher>::const_iterator it = mapScheduledPayeeCounts.find(mnpayee);
+    if (it == mapScheduledPayeeCounts.end()) return false;
+
+    // nNotBlockHeight doesn't count, so it has to be scheduled for another block too
+    std::map<int, CKeyID>::const_iterator itNot = mapScheduledPayees.find(nNotBlockHeight);
+    if (itNot != mapScheduledPayees.end() && itNot->second == mnpayee) {
+        return it->second > 1;
     }
 
-    return false;
+    return true;
+}
+
+// Sets the scheduled payee of nBlockHeight to its best payee, or to none if it's not one of the blocks IsScheduled
+// looks at
+void CShroudnodePayments::UpdateScheduledPayee(int nBlockHeight) {
+    AssertLockHeld(cs_mapShroudnodeBlocks);
+
+    std::map<int, CKeyID>::iterator it = mapScheduledPayees.find(nBlockHeight);
+    if (it != mapScheduledPayees.end()) {
+        std::unordered_map<CKeyID, int, CKeyIDHasher>::iterator itCount = mapScheduledPayeeCounts.find(it->second);
+        if (--itCount->second == 0) mapScheduledPayeeCounts.erase(itCount);
+        mapScheduledPayees.erase(it);
+    }
+
+    if (!pCurrentBlockIndex) return;
+    if (nBlockHeight < pCurrentBlockIndex->nHeight || nBlockHeight > pCurrentBlockIndex->nHeight + MNPAYMENTS_SCHEDULED_BLOCKS) return;
+
+    std::map<int, CShroudnodeBlockPayees>::iterator itBlock = mapShroudnodeBlocks.find(nBlockHeight);
+    CScript payee;
+    if (itBlock == mapShroudnodeBlocks.end() || !itBlock->second.GetBestPayee(payee) || !payee.IsPayToPublicKeyHash()) return;
+
+    CKeyID keyID(uint160(std::vector<unsigned char>(payee.begin() + 3, payee.begin() + 23)));
+    mapScheduledPayees[nBlockHeight] = keyID;
+    mapScheduledPayeeCounts[keyID]++;
+}
+
+void CShroudnodePayments::UpdateScheduledPayees() {
+    AssertLockHeld(cs_mapShroudnodeBlocks);
+
+    mapScheduledPayees.clear();
+    mapScheduledPayeeCounts.clear();
+
+    if (!pCurrentBlockIndex) return;
+
+    for (int h = pCurrentBlockIndex->nHeight; h <= pCurrentBlockIndex->nHeight + MNPAYMENTS_SCHEDULED_BLOCKS; h++) {
+        UpdateScheduledPayee(h);
+    }
 }
 
 bool CShroudnodePayments::AddPaymentVote(const CShroudnodePaymentVote &vote) {
@@ -446,6 +485,7 @@ bool CShroudnodePayments::AddPaymentVote(const CShroudnodePaymentVote &vote) {
     }
 
     mapShroudnodeBlocks[vote.nBlockHeight].AddPayee(vote);
+    UpdateScheduledPayee(vote.nBlockHeight);
 
     return true;
 }
@@ -615,6 +655,7 @@ void CShroudnodePayments::CheckAndRemove() {
             ++it;
         }
     }
+    UpdateScheduledPayees();
     LogPrintf("CShroudnodePayments::CheckAndRemove -- %s\n", ToString());
 }
 
@@ -907,8 +948,12 @@ int CShroudnodePayments::GetStorageLimit() {
 }
 
 void CShroudnodePayments::UpdatedBlockTip(const CBlockIndex *pindex) {
-    pCurrentBlockIndex = pindex;
+    {
+        LOCK(cs_mapShroudnodeBlocks);
+        pCurrentBlockIndex = pindex;
+        UpdateScheduledPayees();
+    }
     LogPrint("mnpayments", "CShroudnodePayments::UpdatedBlockTip -- pCurrentBlockIndex->nHeight=%d\n", pCurrentBlockIndex->nHeight);
-    
+
     ProcessBlock(pindex->nHeight + 5);
 }
@@ -12,6 +12,9 @@
 #include "main.h"
 #include "shroudnode.h"
 #include "utilstrencodings.h"
+#include "crypto/common.h"
+
+#include <unordered_map>
 
 class CShroudnodePayments;
 class CShroudnodePaymentVote;
@@ -19,6 +22,8 @@ class CShroudnodeBlockPayees;
 
 static const int MNPAYMENTS_SIGNATURES_REQUIRED         = 6;
 static const int MNPAYMENTS_SIGNATURES_TOTAL            = 10;
+//! a shroudnode is scheduled if it's the best payee of the tip or up to this many blocks after it
+static const int MNPAYMENTS_SCHEDULED_BLOCKS            = 8;
 
 //! minimum peer version that can receive and send shroudnode payment messages,
 //  vote for shroudnode and be elected as a payment winner
@@ -39,6 +44,14 @@ bool IsBlockPayeeValid(const CTransaction& txNew, int nBlockHeight, CAmount bloc
 void FillBlockPayments(CMutableTransaction& txNew, int nBlockHeight, CAmount blockReward, CTxOut& txoutShroudnodeRet, std::vector<CTxOut>& voutSuperblockRet);
 std::string GetRequiredPaymentsString(int nBlockHeight);
 
+/** Key ids are hashes, so any 64 bits of them are as good a hash */
+struct CKeyIDHasher
+{
+    size_t operator()(const CKeyID& keyID) const {
+        return ReadLE64(keyID.begin());
+    }
+};
+
 class CShroudnodePayee
 {
 private:
@@ -177,6 +190,14 @@ private:
     // Keep track of current block index
     const CBlockIndex *pCurrentBlockIndex;
 
+    // Best payees of the blocks IsScheduled looks at, by height and counted by the key of their pay-to-pubkey-hash
+    // script, the only kind a shroudnode is paid to. Guarded by cs_mapShroudnodeBlocks
+    std::map<int, CKeyID> mapScheduledPayees;
+    std::unordered_map<CKeyID, int, CKeyIDHasher> mapScheduledPayeeCounts;
+
+    void UpdateScheduledPayee(int nBlockHeight);
+    void UpdateScheduledPayees();
+
 public:
     std::map<uint256, CShroudnodePaymentVote> mapShroudnodePaymentVotes;
     std::map<int, CShroudnodeBlockPayees> mapShroudnodeBlocks;
@@ -178,10 +178,8 @@ void CShroudnode::Check(bool fForce) {
         TRY_LOCK(cs_main, lockMain);
         if (!lockMain) return;
 
-        CCoins coins;
-        if (!pcoinsTip->GetCoins(vin.prevout.hash, coins) ||
-            (unsigned int) vin.prevout.n >= coins.vout.size() ||
-            coins.vout[vin.prevout.n].IsNull()) {
+        Coin coin;
+        if (!pcoinsTip->GetCoin(vin.prevout, coin)) {
             SetStatus(SHROUDNODE_OUTPOINT_SPENT);
             LogPrint("shroudnode", "CShroudnode::Check -- Failed to find Shroudnode UTXO, shroudnode=%s\n", vin.prevout.ToStringShort());
             return;
@@ -772,20 +770,18 @@ bool CShroudnodeBroadcast::CheckOutpoint(int &nDos) {
             return false;
         }
 
-        CCoins coins;
-        if (!pcoinsTip->GetCoins(vin.prevout.hash, coins) ||
-            (unsigned int) vin.prevout.n >= coins.vout.size() ||
-            coins.vout[vin.prevout.n].IsNull()) {
+        Coin coin;
+        if (!pcoinsTip->GetCoin(vin.prevout, coin)) {
             LogPrint("shroudnode", "CShroudnodeBroadcast::CheckOutpoint -- Failed to find Shroudnode UTXO, shroudnode=%s\n", vin.prevout.ToStringShort());
             return false;
         }
 
-        if (coins.vout[vin.prevout.n].nValue != SHROUDNODE_COIN_REQUIRED(chainActive.Height()) * COIN) {
+        if (coin.out.nValue != SHROUDNODE_COIN_REQUIRED(chainActive.Height()) * COIN) {
             LogPrint("shroudnode", "CShroudnodeBroadcast::CheckOutpoint -- Shroudnode UTXO should have 50000 SHROUD, shroudnode=%s\n", vin.prevout.ToStringShort());
             return false;
         }
 
-        if (chainActive.Height() - coins.nHeight + 1 < Params().GetConsensus().nShroudnodeMinimumConfirmations) {
+        if (chainActive.Height() - (int)coin.nHeight + 1 < Params().GetConsensus().nShroudnodeMinimumConfirmations) {
             LogPrintf("CShroudnodeBroadcast::CheckOutpoint -- Shroudnode UTXO must have at least %d confirmations, shroudnode=%s\n",
                       Params().GetConsensus().nShroudnodeMinimumConfirmations, vin.prevout.ToStringShort());
             // maybe we miss few blocks, let this mnb to be checked again later
@@ -16,7 +16,12 @@
 #include "shroudnode-payments.h"
 #include "shroudnode-sync.h"
 #include "primitives/zerocoin.h"
+#include "clientversion.h"
+#include "fs.h"
+#include "hash.h"
+#include "random.h"
 
+#include <algorithm>
 #include <atomic>
 #include <sstream>
 #include <chrono>
@@ -30,6 +35,12 @@ namespace sigma {
 
 static CSigmaState sigmaState;
 
+static const char *SIGMA_STATE_SNAPSHOT_FILENAME = "sigmastate.dat";
+static const int SIGMA_STATE_SNAPSHOT_VERSION = 1;
+
+// Tip of the last snapshot written, to avoid rewriting the file on every full flush
+static uint256 hashLastSnapshotTip;
+
 static bool CheckSigmaSpendSerial(
         CValidationState &state,
         CSigmaTxInfo *sigmaTxInfo,
@@ -104,6 +115,34 @@ std::pair<std::unique_ptr<sigma::CoinSpend>, uint32_t> ParseSigmaSpend(const CTx
     return std::make_pair(std::move(spend), groupId);
 }
 
+// Writes the serialization of tx without witness data straight to the hasher, with empty scriptSigs in place of
+// the sigma spends, so the transaction isn't copied
+template <typename TxType>
+static uint256 SigmaSpendTxHash(const TxType& tx)
+{
+    CHashWriter hasher(SER_GETHASH, SERIALIZE_TRANSACTION_NO_WITNESS);
+    hasher << tx.nVersion;
+    WriteCompactSize(hasher, tx.vin.size());
+    for (const CTxIn& in : tx.vin) {
+        if (in.scriptSig.IsSigmaSpend())
+            hasher << CTxIn(in.prevout, CScript(), in.nSequence);
+        else
+            hasher << in;
+    }
+    hasher << tx.vout << tx.nLockTime;
+    return hasher.GetHash();
+}
+
+uint256 GetSigmaSpendTxHash(const CTransaction& tx)
+{
+    return SigmaSpendTxHash(tx);
+}
+
+uint256 GetSigmaSpendTxHash(const CMutableTransaction& tx)
+{
+    return SigmaSpendTxHash(tx);
+}
+
 // This function will not report an error only if the transaction is sigma spend.
 CAmount GetSpendAmount(const CTxIn& in) {
     if (in.IsSigmaSpend()) {
@@ -193,6 +232,9 @@ bool CheckSigmaSpendTransaction(
     int vinIndex = -1;
     std::unordered_set<Scalar, sigma::CScalarHash> txSerials;
 
+    // Obtain the hash of the transaction sans the zerocoin part, the same for all the inputs
+    uint256 txHashForMetadata = GetSigmaSpendTxHash(tx);
+
     Consensus::Params const & params = ::Params().GetConsensus();
 
     if(!isVerifyDB && !isCheckWallet) {
@@ -228,17 +270,6 @@ bool CheckSigmaSpendTransaction(
                              "CTransaction::CheckTransaction() : Error: incorrect spend transaction verion");
         }
 
-        uint256 txHashForMetadata;
-
-        // Obtain the hash of the transaction sans the zerocoin part
-        CMutableTransaction txTemp = tx;
-        BOOST_FOREACH(CTxIn &txTempIn, txTemp.vin) {
-            if (txTempIn.scriptSig.IsSigmaSpend()) {
-                txTempIn.scriptSig.clear();
-            }
-        }
-        txHashForMetadata = txTemp.GetHash();
-
         LogPrintf("CheckSigmaSpendTransaction: tx version=%d, tx metadata hash=%s, serial=%s\n",
                 spend->getVersion(), txHashForMetadata.ToString(),
                 spend->getCoinSerialNumber().tostring());
@@ -274,10 +305,10 @@ bool CheckSigmaSpendTransaction(
         // This list of public coins is required by function "Verify" of CoinSpend.
         std::vector<sigma::PublicCoin> anonymity_set;
         while(true) {
-            BOOST_FOREACH(const sigma::PublicCoin& pubCoinValue,
-                    index->sigmaMintedPubCoins[denominationAndId]) {
-                anonymity_set.push_back(pubCoinValue);
-            }
+            const auto& blockMints = index->GetPrivacyData().sigmaMintedPubCoins;
+            auto mints = blockMints.find(denominationAndId);
+            if (mints != blockMints.end())
+                anonymity_set.insert(anonymity_set.end(), mints->second.begin(), mints->second.end());
             if (index == coinGroup.firstBlock)
                 break;
             index = index->pprev;
@@ -598,8 +629,8 @@ bool ConnectBlockSigma(
     // Add zerocoin transaction information to index
     if (pblock && pblock->sigmaTxInfo) {
         if (!fJustCheck) {
-            pindexNew->sigmaMintedPubCoins.clear();
-            pindexNew->sigmaSpentSerials.clear();
+            pindexNew->PrivacyData().sigmaMintedPubCoins.clear();
+            pindexNew->PrivacyData().sigmaSpentSerials.clear();
         }
 
         if (!CheckSigmaBlock(state, *pblock)) {
@@ -618,7 +649,7 @@ bool ConnectBlockSigma(
             }
 
             if (!fJustCheck) {
-                pindexNew->sigmaSpentSerials.insert(serial);
+                pindexNew->PrivacyData().sigmaSpentSerials.insert(serial);
                 sigmaState.AddSpend(serial.first, serial.second.denomination, serial.second.coinGroupId);
             }
         }
@@ -716,6 +747,12 @@ bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash) {
     return GetOutPoint(outPoint, pubCoinValue);
 }
 
+void GetMintHeights(std::map<uint256, int>& mintHeights) {
+    LOCK(cs_main);
+    for (const auto& mint : sigmaState.GetMints())
+        mintHeights[mint.first.getValueHash()] = mint.second.nHeight;
+}
+
 bool BuildSigmaStateFromIndex(CChain *chain) {
     for (CBlockIndex *blockIndex = chain->Genesis(); blockIndex; blockIndex=chain->Next(blockIndex))
     {
@@ -732,6 +769,115 @@ bool BuildSigmaStateFromIndex(CChain *chain) {
     return true;
 }
 
+bool WriteSigmaStateSnapshot(CChain *chain) {
+    CBlockIndex *tip = chain->Tip();
+    if (tip == NULL)
+        return false;
+    if (tip->GetBlockHash() == hashLastSnapshotTip)
+        return true;
+
+    int64_t nStart = GetTimeMicros();
+
+    // serialize header and state, checksum data up to that point, then append csum
+    CDataStream ssState(SER_DISK, CLIENT_VERSION);
+    ssState << FLATDATA(::Params().MessageStart());
+    ssState << SIGMA_STATE_SNAPSHOT_VERSION;
+    ssState << tip->GetBlockHash();
+    ssState << tip->nHeight;
+    sigmaState.WriteSnapshot(ssState);
+    uint256 hash = Hash(ssState.begin(), ssState.end());
+    ssState << hash;
+
+    unsigned short randv = 0;
+    GetRandBytes((unsigned char *) &randv, sizeof(randv));
+    fs::path pathTmp = GetDataDir() / strprintf("%s.%04x", SIGMA_STATE_SNAPSHOT_FILENAME, randv);
+    CAutoFile fileout(fsbridge::fopen(pathTmp, "wb"), SER_DISK, CLIENT_VERSION);
+    if (fileout.IsNull())
+        return error("%s: Failed to open file %s", __func__, pathTmp.string());
+
+    try {
+        fileout << ssState;
+    }
+    catch (const std::exception &e) {
+        return error("%s: Serialize or I/O error - %s", __func__, e.what());
+    }
+    FileCommit(fileout.Get());
+    fileout.fclose();
+
+    if (!RenameOver(pathTmp, GetDataDir() / SIGMA_STATE_SNAPSHOT_FILENAME))
+        return error("%s: Rename-into-place failed", __func__);
+
+    hashLastSnapshotTip = tip->GetBlockHash();
+    LogPrint("bench", "%s: %u bytes at height %d in %.2fms\n", __func__,
+        ssState.size(), tip->nHeight, 0.001 * (GetTimeMicros() - nStart));
+    return true;
+}
+
+bool LoadSigmaStateSnapshot(CChain *chain) {
+    CBlockIndex *tip = chain->Tip();
+    if (tip == NULL)
+        return false;
+
+    fs::path pathState = GetDataDir() / SIGMA_STATE_SNAPSHOT_FILENAME;
+    CAutoFile filein(fsbridge::fopen(pathState, "rb"), SER_DISK, CLIENT_VERSION);
+    // Allowed to fail, the file is missing on first startup and after an unclean shutdown of older versions
+    if (filein.IsNull())
+        return false;
+
+    int64_t nStart = GetTimeMicros();
+
+    // read the whole file at once, the checksum is at the end
+    uint64_t fileSize = fs::file_size(pathState);
+    if (fileSize < sizeof(uint256))
+        return error("%s: Snapshot file is truncated", __func__);
+    std::vector<char> vchData(fileSize - sizeof(uint256));
+    uint256 hashIn;
+    try {
+        filein.read(vchData.data(), vchData.size());
+        filein >> hashIn;
+    }
+    catch (const std::exception &e) {
+        return error("%s: Deserialize or I/O error - %s", __func__, e.what());
+    }
+    filein.fclose();
+
+    CDataStream ssState(vchData, SER_DISK, CLIENT_VERSION);
+    if (hashIn != Hash(ssState.begin(), ssState.end()))
+        return error("%s: Checksum mismatch, data corrupted", __func__);
+
+    try {
+        unsigned char pchMsgTmp[4];
+        int nVersion, nHeight;
+        uint256 hashTip;
+        ssState >> FLATDATA(pchMsgTmp) >> nVersion >> hashTip >> nHeight;
+
+        if (memcmp(pchMsgTmp, ::Params().MessageStart(), sizeof(pchMsgTmp)))
+            return error("%s: Invalid network magic number", __func__);
+        if (nVersion != SIGMA_STATE_SNAPSHOT_VERSION) {
+            LogPrintf("%s: ignoring snapshot of unsupported version %d\n", __func__, nVersion);
+            return false;
+        }
+        if (hashTip != tip->GetBlockHash() || nHeight != tip->nHeight) {
+            LogPrintf("%s: snapshot is for block %s at height %d, chain tip is at height %d\n",
+                __func__, hashTip.ToString(), nHeight, tip->nHeight);
+            return false;
+        }
+
+        if (!sigmaState.ReadSnapshot(ssState, chain))
+            return error("%s: Snapshot doesn't match the block index", __func__);
+    }
+    catch (const std::exception &e) {
+        sigmaState.Reset();
+        return error("%s: Deserialize or I/O error - %s", __func__, e.what());
+    }
+
+    hashLastSnapshotTip = tip->GetBlockHash();
+    LogPrintf("%s: loaded %u mints and %u spends at height %d in %.2fms\n", __func__,
+        sigmaState.GetMints().size(), sigmaState.GetSpends().size(), tip->nHeight,
+        0.001 * (GetTimeMicros() - nStart));
+    return true;
+}
+
 // CZerocoinTxInfoV3
 
 void CSigmaTxInfo::Complete() {
@@ -809,6 +955,11 @@ void CSigmaState::Containers::Reset() {
     surgeCondition = false;
 }
 
+void CSigmaState::Containers::Reserve(size_t nMints, size_t nSpends) {
+    mintedPubCoins.reserve(nMints);
+    usedCoinSerials.reserve(nSpends);
+}
+
 void CSigmaState::Containers::CheckSurgeCondition(int groupId, CoinDenomination denom) {
     bool result = spendMetaInfo[groupId][denom] > mintMetaInfo[groupId][denom];
     if( result ) {
@@ -882,8 +1033,9 @@ void CSigmaState::AddMintsToStateAndBlockIndex(
             containers.AddMint(mint, CMintedCoinInfo::make(denomination, mintCoinGroupId, index->nHeight));
 
             LogPrintf("AddMintsToStateAndBlockIndex: mint added denomination=%d, id=%d\n", denomination, mintCoinGroupId);
-            index->sigmaMintedPubCoins[{denomination, mintCoinGroupId}].push_back(mint);
+            index->PrivacyData().sigmaMintedPubCoins[{denomination, mintCoinGroupId}].push_back(mint);
         }
+        AddToCoinGroupCache(make_pair(denomination, mintCoinGroupId), index, mintsWithThisDenom);
     }
 }
 
@@ -892,9 +1044,10 @@ void CSigmaState::AddSpend(const Scalar &serial, CoinDenomination denom, int coi
 }
 
 void CSigmaState::AddBlock(CBlockIndex *index) {
+    const CBlockIndexPrivacyData& data = index->GetPrivacyData();
     BOOST_FOREACH(
         const PAIRTYPE(PAIRTYPE(sigma::CoinDenomination, int), vector<sigma::PublicCoin>) &pubCoins,
-            index->sigmaMintedPubCoins) {
+            data.sigmaMintedPubCoins) {
         if (!pubCoins.second.empty()) {
             SigmaCoinGroupInfo& coinGroup = coinGroups[pubCoins.first];
 
@@ -902,6 +1055,7 @@ void CSigmaState::AddBlock(CBlockIndex *index) {
                 coinGroup.firstBlock = index;
             coinGroup.lastBlock = index;
             coinGroup.nCoins += pubCoins.second.size();
+            AddToCoinGroupCache(pubCoins.first, index, pubCoins.second);
         }
 
         latestCoinIds[pubCoins.first.first] = pubCoins.first.second;
@@ -910,16 +1064,17 @@ void CSigmaState::AddBlock(CBlockIndex *index) {
         }
     }
 
-    BOOST_FOREACH(const spend_info_container::value_type &serial, index->sigmaSpentSerials) {
+    BOOST_FOREACH(const spend_info_container::value_type &serial, data.sigmaSpentSerials) {
         AddSpend(serial.first, serial.second.denomination, serial.second.coinGroupId);
     }
 }
 
 void CSigmaState::RemoveBlock(CBlockIndex *index) {
+    const CBlockIndexPrivacyData& data = index->GetPrivacyData();
     // roll back accumulator updates
     BOOST_FOREACH(
         const PAIRTYPE(PAIRTYPE(sigma::CoinDenomination, int),vector<sigma::PublicCoin>) &coin,
-        index->sigmaMintedPubCoins)
+        data.sigmaMintedPubCoins)
     {
         SigmaCoinGroupInfo   &coinGroup = coinGroups[coin.first];
         int  nMintsToForget = coin.second.size();
@@ -929,6 +1084,7 @@ void CSigmaState::RemoveBlock(CBlockIndex *index) {
         if ((coinGroup.nCoins -= nMintsToForget) == 0) {
             // all the coins of this group have been erased, remove the group altogether
             coinGroups.erase(coin.first);
+            coinGroupCaches.erase(coin.first);
             // decrease pubcoin id for this denomination
             latestCoinIds[coin.first.first]--;
             if (0 == latestCoinIds[coin.first.first]) {
@@ -942,13 +1098,15 @@ void CSigmaState::RemoveBlock(CBlockIndex *index) {
             do {
                 assert(coinGroup.lastBlock != coinGroup.firstBlock);
                 coinGroup.lastBlock = coinGroup.lastBlock->pprev;
-            } while (coinGroup.lastBlock->sigmaMintedPubCoins.count(coin.first) == 0);
+            } while (coinGroup.lastBlock->GetPrivacyData().sigmaMintedPubCoins.count(coin.first) == 0);
+
+            RemoveFromCoinGroupCache(coin.first, index);
         }
     }
 
     // roll back mints
     BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(sigma::CoinDenomination, int),vector<sigma::PublicCoin>) &pubCoins,
-                  index->sigmaMintedPubCoins) {
+                  data.sigmaMintedPubCoins) {
         BOOST_FOREACH(const sigma::PublicCoin &coin, pubCoins.second) {
             auto coins = containers.GetMints().equal_range(coin);
             auto coinIt = find_if(
@@ -963,7 +1121,7 @@ void CSigmaState::RemoveBlock(CBlockIndex *index) {
     }
 
     // roll back spends
-    BOOST_FOREACH(const spend_info_container::value_type &serial, index->sigmaSpentSerials) {
+    BOOST_FOREACH(const spend_info_container::value_type &serial, data.sigmaSpentSerials) {
         containers.RemoveSpend(serial.first);
     }
 }
@@ -1018,37 +1176,119 @@ int CSigmaState::GetCoinSetForSpend(
         uint256& blockHash_out,
         std::vector<sigma::PublicCoin>& coins_out) {
 
+    uint256 blockHash;
+    if (!GetAnonymitySet(denomination, coinGroupID, maxHeight, uint256(), blockHash, coins_out))
+        return 0;
+
+    // latest block satisfying given conditions
+    if (!coins_out.empty())
+        blockHash_out = blockHash;
+    return coins_out.size();
+}
+
+bool CSigmaState::GetAnonymitySet(
+        sigma::CoinDenomination denomination,
+        int coinGroupID,
+        int maxHeight,
+        const uint256& sinceBlock,
+        uint256& blockHash_out,
+        std::vector<sigma::PublicCoin>& coins_out) {
+
     coins_out.clear();
 
     pair<sigma::CoinDenomination, int> denomAndId = std::make_pair(denomination, coinGroupID);
 
-    if (coinGroups.count(denomAndId) == 0)
-        return 0;
+    auto groupIt = coinGroups.find(denomAndId);
+    if (groupIt == coinGroups.end())
+        return false;
 
-    SigmaCoinGroupInfo coinGroup = coinGroups[denomAndId];
-
-    int numberOfCoins = 0;
-    for (CBlockIndex *block = coinGroup.lastBlock;
-            ;
-            block = block->pprev) {
-        if (block->sigmaMintedPubCoins[denomAndId].size() > 0) {
-            if (block->nHeight <= maxHeight) {
-                if (numberOfCoins == 0) {
-                    // latest block satisfying given conditions
-                    // remember block hash
-                    blockHash_out = block->GetBlockHash();
-                }
-                numberOfCoins += block->sigmaMintedPubCoins[denomAndId].size();
-                coins_out.insert(coins_out.end(),
-                        block->sigmaMintedPubCoins[denomAndId].begin(),
-                        block->sigmaMintedPubCoins[denomAndId].end());
-            }
-        }
-        if (block == coinGroup.firstBlock) {
-            break ;
+    const SigmaCoinGroupCache& cache = GetCoinGroupCache(denomAndId, groupIt->second);
+
+    // blocks are in chain order, take the ones up to maxHeight and after sinceBlock
+    size_t nEnd = std::upper_bound(cache.blocks.begin(), cache.blocks.end(), maxHeight,
+        [](int height, const std::pair<CBlockIndex*, size_t>& block) {
+            return height < block.first->nHeight;
+        }) - cache.blocks.begin();
+
+    size_t nBegin = 0;
+    if (!sinceBlock.IsNull()) {
+        for (nBegin = cache.blocks.size(); nBegin > 0; nBegin--) {
+            if (cache.blocks[nBegin - 1].first->GetBlockHash() == sinceBlock)
+                break;
         }
+        if (nBegin == 0)
+            return false;
+    }
+
+    if (nEnd == 0)
+        return true;
+    blockHash_out = cache.blocks[nEnd - 1].first->GetBlockHash();
+
+    if (nBegin >= nEnd)
+        return true;
+
+    coins_out.reserve(cache.blocks[nEnd - 1].second - (nBegin > 0 ? cache.blocks[nBegin - 1].second : 0));
+    for (size_t i = nEnd; i > nBegin; i--) {
+        size_t nFirst = i > 1 ? cache.blocks[i - 2].second : 0;
+        coins_out.insert(coins_out.end(), cache.coins.begin() + nFirst, cache.coins.begin() + cache.blocks[i - 1].second);
     }
-    return numberOfCoins;
+    return true;
+}
+
+CSigmaState::SigmaCoinGroupCache& CSigmaState::GetCoinGroupCache(
+        const pair<CoinDenomination, int>& key,
+        const SigmaCoinGroupInfo& coinGroup) {
+    auto cacheIt = coinGroupCaches.find(key);
+    if (cacheIt != coinGroupCaches.end())
+        return cacheIt->second;
+
+    std::vector<CBlockIndex*> blocks;
+    for (CBlockIndex *block = coinGroup.lastBlock; ; block = block->pprev) {
+        if (block->GetPrivacyData().sigmaMintedPubCoins.count(key) > 0)
+            blocks.push_back(block);
+        if (block == coinGroup.firstBlock)
+            break;
+    }
+
+    SigmaCoinGroupCache& cache = coinGroupCaches[key];
+    cache.coins.reserve(coinGroup.nCoins);
+    cache.blocks.reserve(blocks.size());
+    for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+        const std::vector<sigma::PublicCoin>& mints = (*it)->GetPrivacyData().sigmaMintedPubCoins.at(key);
+        cache.coins.insert(cache.coins.end(), mints.begin(), mints.end());
+        cache.blocks.push_back(std::make_pair(*it, cache.coins.size()));
+    }
+    return cache;
+}
+
+void CSigmaState::AddToCoinGroupCache(
+        const pair<CoinDenomination, int>& key,
+        CBlockIndex *index,
+        const std::vector<sigma::PublicCoin>& mints) {
+    // groups nobody asked for are not cached yet
+    auto cacheIt = coinGroupCaches.find(key);
+    if (cacheIt == coinGroupCaches.end() || mints.empty())
+        return;
+
+    SigmaCoinGroupCache& cache = cacheIt->second;
+    cache.coins.insert(cache.coins.end(), mints.begin(), mints.end());
+    cache.blocks.push_back(std::make_pair(index, cache.coins.size()));
+}
+
+void CSigmaState::RemoveFromCoinGroupCache(const pair<CoinDenomination, int>& key, CBlockIndex *index) {
+    auto cacheIt = coinGroupCaches.find(key);
+    if (cacheIt == coinGroupCaches.end())
+        return;
+
+    SigmaCoinGroupCache& cache = cacheIt->second;
+    if (cache.blocks.empty() || cache.blocks.back().first != index) {
+        // out of sync, build it again on next use
+        coinGroupCaches.erase(cacheIt);
+        return;
+    }
+
+    cache.blocks.pop_back();
+    cache.coins.resize(cache.blocks.empty() ? 0 : cache.blocks.back().second);
 }
 
 std::pair<int, int> CSigmaState::GetMintedCoinHeightAndId(
@@ -1111,12 +1351,104 @@ bool CSigmaState::CanAddMintToMempool(const GroupElement& pubCoin){
 
 void CSigmaState::Reset() {
     coinGroups.clear();
+    coinGroupCaches.clear();
     latestCoinIds.clear();
     mempoolCoinSerials.clear();
     mempoolMints.clear();
     containers.Reset();
 }
 
+void CSigmaState::WriteSnapshot(CDataStream& stream) const {
+    WriteCompactSize(stream, coinGroups.size());
+    for (const auto& group : coinGroups) {
+        stream << int64_t(group.first.first) << group.first.second;
+        stream << group.second.firstBlock->nHeight << group.second.firstBlock->GetBlockHash();
+        stream << group.second.lastBlock->nHeight << group.second.lastBlock->GetBlockHash();
+        stream << group.second.nCoins;
+    }
+
+    WriteCompactSize(stream, latestCoinIds.size());
+    for (const auto& id : latestCoinIds)
+        stream << int64_t(id.first) << id.second;
+
+    WriteCompactSize(stream, GetMints().size());
+    for (const auto& mint : GetMints())
+        stream << mint.first << int64_t(mint.second.denomination) << mint.second.coinGroupId << mint.second.nHeight;
+
+    WriteCompactSize(stream, GetSpends().size());
+    for (const auto& spend : GetSpends())
+        stream << spend.first << spend.second;
+}
+
+bool CSigmaState::ReadSnapshot(CDataStream& stream, CChain *chain) {
+    Reset();
+
+    // Only the blocks referenced by the coin groups are checked here, walking the chain is what the snapshot avoids
+    auto findBlock = [chain](int nHeight, const uint256& hash) -> CBlockIndex* {
+        CBlockIndex *index = (*chain)[nHeight];
+        return index != NULL && index->GetBlockHash() == hash ? index : NULL;
+    };
+
+    int64_t nTotalCoins = 0;
+    for (uint64_t n = ReadCompactSize(stream); n > 0; n--) {
+        int64_t denomination;
+        int id, firstHeight, lastHeight, nCoins;
+        uint256 firstHash, lastHash;
+        stream >> denomination >> id >> firstHeight >> firstHash >> lastHeight >> lastHash >> nCoins;
+
+        std::pair<CoinDenomination, int> key(CoinDenomination(denomination), id);
+        SigmaCoinGroupInfo& coinGroup = coinGroups[key];
+        coinGroup.firstBlock = findBlock(firstHeight, firstHash);
+        coinGroup.lastBlock = findBlock(lastHeight, lastHash);
+        coinGroup.nCoins = nCoins;
+
+        if (coinGroup.firstBlock == NULL || coinGroup.lastBlock == NULL
+                || coinGroup.firstBlock->GetPrivacyData().sigmaMintedPubCoins.count(key) == 0
+                || coinGroup.lastBlock->GetPrivacyData().sigmaMintedPubCoins.count(key) == 0) {
+            Reset();
+            return false;
+        }
+        nTotalCoins += nCoins;
+    }
+
+    for (uint64_t n = ReadCompactSize(stream); n > 0; n--) {
+        int64_t denomination;
+        int id;
+        stream >> denomination >> id;
+        latestCoinIds[CoinDenomination(denomination)] = id;
+    }
+
+    uint64_t nMints = ReadCompactSize(stream);
+    if (int64_t(nMints) != nTotalCoins) {
+        Reset();
+        return false;
+    }
+    // spends follow the mints, reserve them once their count is known
+    containers.Reserve(nMints, 0);
+    for (; nMints > 0; nMints--) {
+        sigma::PublicCoin pubCoin;
+        int64_t denomination;
+        int id, nHeight;
+        stream >> pubCoin >> denomination >> id >> nHeight;
+        if (nHeight > chain->Height()) {
+            Reset();
+            return false;
+        }
+        containers.AddMint(pubCoin, CMintedCoinInfo::make(CoinDenomination(denomination), id, nHeight));
+    }
+
+    uint64_t nSpends = ReadCompactSize(stream);
+    containers.Reserve(GetMints().size(), nSpends);
+    for (; nSpends > 0; nSpends--) {
+        Scalar serial;
+        CSpendCoinInfo info;
+        stream >> serial >> info;
+        containers.AddSpend(serial, info);
+    }
+
+    return true;
+}
+
 CSigmaState* CSigmaState::GetState() {
     return &sigmaState;
 }
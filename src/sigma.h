@@ -6,6 +6,7 @@
 #include "sigma/coin.h"
 #include "sigma/coinspend.h"
 #include "consensus/validation.h"
+#include "streams.h"
 #include <secp256k1/include/Scalar.h>
 #include <secp256k1/include/GroupElement.h>
 #include "sigma/params.h"
@@ -51,6 +52,11 @@ bool IsRemintWindow(int height);
 
 secp_primitives::GroupElement ParseSigmaMintScript(const CScript& script);
 std::pair<std::unique_ptr<sigma::CoinSpend>, uint32_t> ParseSigmaSpend(const CTxIn& in);
+
+// Hash of tx with the scriptSigs of its sigma spend inputs left empty. It is the txHash of the SpendMetaData signed
+// by the spend proofs of all the inputs
+uint256 GetSigmaSpendTxHash(const CTransaction& tx);
+uint256 GetSigmaSpendTxHash(const CMutableTransaction& tx);
 CAmount GetSpendAmount(const CTxIn& in);
 CAmount GetSpendAmount(const CTransaction& tx);
 bool CheckSigmaBlock(CValidationState &state, const CBlock& block);
@@ -82,8 +88,21 @@ bool GetOutPoint(COutPoint& outPoint, const sigma::PublicCoin &pubCoin);
 bool GetOutPoint(COutPoint& outPoint, const GroupElement &pubCoinValue);
 bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash);
 
+/*
+ * Get the height of the minting block for every pubcoin value hash in the sigma state, in a single pass.
+ * Used instead of GetOutPoint when a large number of mints have to be looked up.
+ */
+void GetMintHeights(std::map<uint256, int>& mintHeights);
+
 bool BuildSigmaStateFromIndex(CChain *chain);
 
+/*
+ * Snapshot of the sigma state stored in sigmastate.dat, used instead of BuildSigmaStateFromIndex on startup.
+ * The snapshot is tied to the tip it was written at and is ignored if the chain was loaded with a different tip.
+ */
+bool WriteSigmaStateSnapshot(CChain *chain);
+bool LoadSigmaStateSnapshot(CChain *chain);
+
 Scalar GetSigmaSpendSerialNumber(const CTransaction &tx, const CTxIn &txin);
 CAmount GetSigmaSpendInput(const CTransaction &tx);
 
@@ -152,12 +171,30 @@ public:
         uint256& blockHash_out,
         std::vector<sigma::PublicCoin>& coins_out);
 
+    // Same as GetCoinSetForSpend, but only coins minted after the block sinceBlock are returned unless it is null.
+    // Coins of later blocks come first, the order spends are proven against. Returns false if there is no such
+    // group or sinceBlock doesn't mint coins of it
+    bool GetAnonymitySet(
+        sigma::CoinDenomination denomination,
+        int id,
+        int maxHeight,
+        const uint256& sinceBlock,
+        uint256& blockHash_out,
+        std::vector<sigma::PublicCoin>& coins_out);
+
     // Return height of mint transaction and id of minted coin
     std::pair<int, int> GetMintedCoinHeightAndId(const sigma::PublicCoin& pubCoin);
 
     // Reset to initial values
     void Reset();
 
+    // Serialize everything except the mempool part of the state
+    void WriteSnapshot(CDataStream& stream) const;
+
+    // Restore the state written by WriteSnapshot. Coin group blocks are resolved against the chain,
+    // returns false if they don't match it. The state is left reset in that case
+    bool ReadSnapshot(CDataStream& stream, CChain *chain);
+
     // Check if there is a conflicting tx in the blockchain or mempool
     bool CanAddSpendToMempool(const Scalar& coinSerial);
 
@@ -201,13 +238,26 @@ private:
     // Collection of coin groups. Map from <denomination,id> to SigmaCoinGroupInfo structure
     std::unordered_map<pair<CoinDenomination, int>, SigmaCoinGroupInfo, pairhash> coinGroups;
 
+    // Coins of a group in chain order together with the blocks minting them, so that anonymity sets are served
+    // without walking the block index. Built on first use and kept up to date when blocks are added or removed
+    struct SigmaCoinGroupCache {
+        std::vector<sigma::PublicCoin> coins;
+        // blocks minting coins of the group and the number of coins up to and including each of them
+        std::vector<std::pair<CBlockIndex*, size_t>> blocks;
+    };
+    std::unordered_map<pair<CoinDenomination, int>, SigmaCoinGroupCache, pairhash> coinGroupCaches;
+
+    SigmaCoinGroupCache& GetCoinGroupCache(const pair<CoinDenomination, int>& key, const SigmaCoinGroupInfo& coinGroup);
+    void AddToCoinGroupCache(const pair<CoinDenomination, int>& key, CBlockIndex *index, const std::vector<sigma::PublicCoin>& mints);
+    void RemoveFromCoinGroupCache(const pair<CoinDenomination, int>& key, CBlockIndex *index);
+
     // Latest IDs of coins by denomination
     std::unordered_map<CoinDenomination, int> latestCoinIds;
 
     // serials of spends currently in the mempool mapped to tx hashes
     std::unordered_map<Scalar, uint256, CScalarHash> mempoolCoinSerials;
 
-    std::unordered_set<GroupElement> mempoolMints;
+    std::unordered_set<GroupElement, CGroupElementHash> mempoolMints;
 
     std::atomic<bool> surgeCondition;
 
@@ -221,6 +271,7 @@ private:
         void RemoveSpend(Scalar const & serial);
 
         void Reset();
+        void Reserve(size_t nMints, size_t nSpends);
 
         mint_info_container const & GetMints() const;
         spend_info_container const & GetSpends() const;
@@ -168,6 +168,8 @@ PublicCoin::PublicCoin(const GroupElement& coin, const CoinDenomination d)
     : value(coin)
     , denomination(d)
 {
+    // Coins are compared and hashed a lot in the sigma state, keep the value in affine form
+    value.normalize();
 }
 
 const GroupElement& PublicCoin::getValue() const{
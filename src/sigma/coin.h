@@ -69,6 +69,7 @@ public:
         s.read(b, size + sizeof(int32_t));
         value.deserialize(buffer);
         std::memcpy(&denomination, buffer + size, sizeof(denomination));
+        valueHash.SetNull();
     }
 
 private:
@@ -2,6 +2,10 @@
 #include "openssl_context.h"
 #include "util.h"
 
+#include "../libzerocoin/ParallelTasks.h"
+
+#include <algorithm>
+
 namespace sigma {
 
 CoinSpend::CoinSpend(
@@ -29,21 +33,32 @@ CoinSpend::CoinSpend(
         params->get_m());
     //compute inverse of g^s
     GroupElement gs = (params->get_g() * coinSerialNumber).inverse();
-    std::vector<GroupElement> C_;
-    C_.reserve(anonymity_set.size());
-    std::size_t coinIndex;
-    bool indexFound = false;
 
-    for (std::size_t j = 0; j < anonymity_set.size(); ++j) {
-        if(anonymity_set[j] == coin.getPublicCoin()){
-            coinIndex = j;
-            indexFound = true;
-        }
-
-        C_.emplace_back(anonymity_set[j].getValue() + gs);
+    // Shift the set and look for the coin in slices on the thread pool, both take a field inversion or an
+    // addition per member
+    std::size_t setSize = anonymity_set.size();
+    std::vector<GroupElement> C_(setSize);
+    std::size_t nSlices = std::min<std::size_t>(std::max(boost::thread::hardware_concurrency(), 1u), setSize);
+    std::vector<std::size_t> coinIndexes(nSlices, setSize);
+    libzerocoin::ParallelTasks tasks(nSlices);
+    for (std::size_t nSlice = 0; nSlice < nSlices; ++nSlice) {
+        tasks.Add([&anonymity_set, &coin, &gs, &C_, &coinIndexes, setSize, nSlices, nSlice] {
+            for (std::size_t j = setSize * nSlice / nSlices; j < setSize * (nSlice + 1) / nSlices; ++j) {
+                if (anonymity_set[j] == coin.getPublicCoin())
+                    coinIndexes[nSlice] = j;
+
+                C_[j] = anonymity_set[j].getValue() + gs;
+            }
+        });
     }
+    tasks.Wait();
+
+    // the last occurrence of the coin is proven, as before
+    std::size_t coinIndex = setSize;
+    for (std::size_t nSlice = nSlices; nSlice-- > 0 && coinIndex == setSize; )
+        coinIndex = coinIndexes[nSlice];
 
-    if(!indexFound)
+    if(coinIndex == setSize)
         throw ZerocoinException("No such coin in this anonymity set");
 
     sigmaProver.proof(C_, coinIndex, coin.getRandomness(), fPadding, sigmaProof);
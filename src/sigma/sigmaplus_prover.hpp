@@ -1,4 +1,9 @@
 #include <math.h>
+
+#include "../libzerocoin/ParallelTasks.h"
+
+#include <algorithm>
+
 namespace sigma {
 
 template<class Exponent, class GroupElement>
@@ -46,15 +51,25 @@ void SigmaPlusProver<Exponent, GroupElement>::proof(
     std::vector <std::vector<Exponent>> P_i_k;
     P_i_k.resize(N);
 
+    // Polynomials are independent of each other, compute them in slices on the thread pool
+    std::size_t nThreads = std::max(boost::thread::hardware_concurrency(), 1u);
+    libzerocoin::ParallelTasks tasks(nThreads);
+
     // last polynomial is special case if fPadding is true
-    for (std::size_t i = 0; i < (fPadding ? N-1 : N); ++i) {
-        std::vector<Exponent>& coefficients = P_i_k[i];
-        std::vector<uint64_t> I = SigmaPrimitives<Exponent, GroupElement>::convert_to_nal(i, n_, m_);
-        coefficients.push_back(a[I[0]]);
-        coefficients.push_back(sigma[I[0]]);
-        for (int j = 1; j < m_; ++j) {
-            SigmaPrimitives<Exponent, GroupElement>::new_factor(sigma[j * n_ + I[j]], a[j * n_ + I[j]], coefficients);
-        }
+    std::size_t nPolynomials = fPadding ? N-1 : N;
+    std::size_t nSlices = std::min(nThreads, nPolynomials);
+    for (std::size_t nSlice = 0; nSlice < nSlices; ++nSlice) {
+        tasks.Add([this, &P_i_k, &sigma, &a, nPolynomials, nSlices, nSlice] {
+            for (std::size_t i = nPolynomials * nSlice / nSlices; i < nPolynomials * (nSlice + 1) / nSlices; ++i) {
+                std::vector<Exponent>& coefficients = P_i_k[i];
+                std::vector<uint64_t> I = SigmaPrimitives<Exponent, GroupElement>::convert_to_nal(i, n_, m_);
+                coefficients.push_back(a[I[0]]);
+                coefficients.push_back(sigma[I[0]]);
+                for (int j = 1; j < m_; ++j) {
+                    SigmaPrimitives<Exponent, GroupElement>::new_factor(sigma[j * n_ + I[j]], a[j * n_ + I[j]], coefficients);
+                }
+            }
+        });
     }
 
     if (fPadding) {
@@ -108,18 +123,38 @@ void SigmaPlusProver<Exponent, GroupElement>::proof(
         P_i_k[N-1] = p_i_sum;
     }
 
+    tasks.Wait();
+    tasks.Reset();
+
     //computing G_k`s;
+    // Every k is split into slices of the set so that all the threads are busy even though m is small,
+    // multi-exponentiations of the slices are summed up afterwards
+    std::size_t nSetSlices = std::min(std::max<std::size_t>(nThreads / m_, 1), N);
+    std::vector<GroupElement> partial_Gk(m_ * nSetSlices);
+    for (int k = 0; k < m_; ++k) {
+        for (std::size_t nSlice = 0; nSlice < nSetSlices; ++nSlice) {
+            tasks.Add([&commits, &P_i_k, &partial_Gk, N, nSetSlices, k, nSlice] {
+                std::size_t begin = N * nSlice / nSetSlices, end = N * (nSlice + 1) / nSetSlices;
+                std::vector <GroupElement> C_i(commits.begin() + begin, commits.begin() + end);
+                std::vector <Exponent> P_i;
+                P_i.reserve(end - begin);
+                for (std::size_t i = begin; i < end; ++i) {
+                    P_i.emplace_back(P_i_k[i][k]);
+                }
+                secp_primitives::MultiExponent mult(C_i, P_i);
+                partial_Gk[k * nSetSlices + nSlice] = mult.get_multiple();
+            });
+        }
+    }
+    tasks.Wait();
+
     std::vector <GroupElement> Gk;
     Gk.reserve(m_);
     for (int k = 0; k < m_; ++k) {
-        std::vector <Exponent> P_i;
-        P_i.reserve(N);
-        for (size_t i = 0; i < N; ++i) {
-            P_i.emplace_back(P_i_k[i][k]);
+        GroupElement c_k = SigmaPrimitives<Exponent, GroupElement>::commit(g_, Exponent(uint64_t(0)), h_[0], Pk[k]);
+        for (std::size_t nSlice = 0; nSlice < nSetSlices; ++nSlice) {
+            c_k += partial_Gk[k * nSetSlices + nSlice];
         }
-        secp_primitives::MultiExponent mult(commits, P_i);
-        GroupElement c_k = mult.get_multiple();
-        c_k += SigmaPrimitives<Exponent, GroupElement>::commit(g_, Exponent(uint64_t(0)), h_[0], Pk[k]);
         Gk.emplace_back(c_k);
     }
     proof_out.Gk_ = Gk;
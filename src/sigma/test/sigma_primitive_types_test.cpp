@@ -20,4 +20,37 @@ BOOST_AUTO_TEST_CASE(scalar_test)
     BOOST_CHECK(s == s2);
 }
 
+BOOST_AUTO_TEST_CASE(group_element_normalize_test)
+{
+    secp_primitives::GroupElement g, p;
+    g.set_base_g();
+    p.set_base_g();
+    for (int i = 0; i < 10; i++)
+        p += g;
+
+    // Normalizing keeps the point, its encoding and its hash
+    secp_primitives::GroupElement normalized(p);
+    normalized.normalize();
+    BOOST_CHECK(normalized == p);
+    BOOST_CHECK(normalized.getvch() == p.getvch());
+    BOOST_CHECK_EQUAL(normalized.hash(), p.hash());
+
+    // A deserialized point matches as well
+    secp_primitives::GroupElement deserialized;
+    deserialized.deserialize(p.getvch().data());
+    BOOST_CHECK(deserialized == p);
+    BOOST_CHECK_EQUAL(deserialized.hash(), p.hash());
+
+    unsigned char coord1[secp_primitives::GroupElement::affine_size], coord2[secp_primitives::GroupElement::affine_size];
+    p.get_affine_coordinates(coord1);
+    deserialized.get_affine_coordinates(coord2);
+    BOOST_CHECK(std::equal(coord1, coord1 + sizeof(coord1), coord2));
+
+    // Arithmetic on a normalized point works as before
+    normalized += g;
+    p += g;
+    BOOST_CHECK(normalized == p);
+    BOOST_CHECK(normalized != g);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -373,4 +373,53 @@ struct CAddressIndexIteratorHeightKey {
 };
 
 
+struct CAddressBalanceValue {
+    CAmount balance;
+    CAmount received;
+    int64_t utxoCount;
+    int firstHeight;
+    int lastHeight;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
+        READWRITE(balance);
+        READWRITE(received);
+        READWRITE(utxoCount);
+        READWRITE(firstHeight);
+        READWRITE(lastHeight);
+    }
+
+    CAddressBalanceValue() {
+        SetNull();
+    }
+
+    void SetNull() {
+        balance = 0;
+        received = 0;
+        utxoCount = 0;
+        firstHeight = -1;
+        lastHeight = -1;
+    }
+
+    bool IsNull() const {
+        return firstHeight == -1;
+    }
+
+    void ApplyDelta(const CAddressIndexKey &key, CAmount delta) {
+        balance += delta;
+        if (delta > 0)
+            received += delta;
+        utxoCount += key.spending ? -1 : 1;
+        if (firstHeight == -1 || key.blockHeight < firstHeight)
+            firstHeight = key.blockHeight;
+        if (key.blockHeight > lastHeight)
+            lastHeight = key.blockHeight;
+    }
+};
+
+//! Previous aggregates of the addresses touched by a block, a null value means the address was new
+typedef std::vector<std::pair<CAddressIndexIteratorKey, CAddressBalanceValue> > CAddressBalanceUndo;
+
 #endif // BITCOIN_SPENTINDEX_H
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "hash.h"
+#include "primitives/block.h"
 #include "utilstrencodings.h"
 #include "test/test_bitcoin.h"
 
@@ -128,4 +129,26 @@ BOOST_AUTO_TEST_CASE(siphash)
     BOOST_CHECK_EQUAL(SipHashUint256(1, 2, ss.GetHash()), 0x79751e980c2a0a35ULL);
 }
 
+BOOST_AUTO_TEST_CASE(x16rv2)
+{
+    // the last 16 nibbles of the previous block hash select all the algorithms in order
+    CBlockHeader header;
+    header.nVersion = 0x20000000;
+    header.hashPrevBlock = uint256S("fedcba98765432100f1e2d3c4b5a69788796a5b4c3d2e1f00123456789abcdef");
+    header.hashMerkleRoot = uint256S("00112233445566778899aabbccddeeff00112233445566778899aabbccddeeff");
+    header.nTime = 1583020800;
+    header.nBits = 0x1e0ffff0;
+    header.nNonce = 12345;
+    BOOST_CHECK_EQUAL(header.GetPoWHash().GetHex(), "549ca355764911f91b152f387d95b643ae6f854375a33a0417de01c6e13136f8");
+
+    // hashing nonces side by side gives the same hashes as one at a time
+    uint256 hashes[5];
+    header.GetPoWHashes(5, hashes);
+    for (int i = 0; i < 5; i++) {
+        CBlockHeader single = header;
+        single.nNonce += i;
+        BOOST_CHECK(hashes[i] == single.GetPoWHash());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -355,4 +355,106 @@ BOOST_AUTO_TEST_CASE(blockchain_restore)
 
 }
 
+/*
+HDMint tracker balance test
+- test that the incrementally maintained balance matches the listed mints and that decrypted mints are cached.
+*/
+BOOST_AUTO_TEST_CASE(tracker_balance)
+{
+    string stringError;
+    CHDMintTracker& tracker = zwalletMain->GetTracker();
+
+    // Create 400-200+1 = 201 new empty blocks. // consensus.nMintV3SigmaStartBlock = 400
+    CreateAndProcessEmptyBlocks(201, scriptPubKey);
+    pwalletMain->SetBroadcastTransactions(true);
+
+    vector<pair<std::string, int>> denominationPairs = {{"1", 1}, {"10", 2}};
+    BOOST_CHECK_MESSAGE(pwalletMain->CreateZerocoinMintModel(
+        stringError, denominationPairs, SIGMA), stringError + " - Create Mint failed");
+
+    CAmount all, confirmed;
+    {
+        LOCK2(cs_main, pwalletMain->cs_wallet);
+        tracker.GetBalance(all, confirmed, chainActive.Height());
+    }
+    BOOST_CHECK_EQUAL(all, 21 * COIN);
+    BOOST_CHECK_EQUAL(confirmed, 0);
+
+    CreateAndProcessBlock({}, scriptPubKey);
+    CreateAndProcessEmptyBlocks(5, scriptPubKey);
+
+    std::vector<CMintMeta> mints = tracker.ListMints(true, false);
+    CAmount listed = 0;
+    for (const CMintMeta& mint : mints) {
+        int64_t amount;
+        DenominationToInteger(mint.denom, amount);
+        listed += amount;
+    }
+
+    {
+        LOCK2(cs_main, pwalletMain->cs_wallet);
+        tracker.GetBalance(all, confirmed, chainActive.Height());
+    }
+    BOOST_CHECK_EQUAL(all, listed);
+    BOOST_CHECK_EQUAL(confirmed, 21 * COIN);
+
+    // The second lookup is served from the cache and returns the same mint
+    for (const CMintMeta& mint : mints) {
+        CSigmaEntry entry, cached;
+        BOOST_CHECK(!tracker.GetMintEntry(mint.hashSerial, cached));
+        BOOST_CHECK(pwalletMain->GetMint(mint.hashSerial, entry));
+        BOOST_CHECK(tracker.GetMintEntry(mint.hashSerial, cached));
+        BOOST_CHECK(cached.serialNumber == entry.serialNumber);
+        BOOST_CHECK(cached.value == entry.value);
+    }
+
+    // Marking a mint used updates both the cache and the balance
+    tracker.SetPubcoinUsed(mints[0].GetPubCoinValueHash(), uint256());
+    CSigmaEntry used;
+    BOOST_CHECK(tracker.GetMintEntry(mints[0].hashSerial, used));
+    BOOST_CHECK(used.IsUsed);
+
+    int64_t usedAmount;
+    DenominationToInteger(mints[0].denom, usedAmount);
+    {
+        LOCK2(cs_main, pwalletMain->cs_wallet);
+        tracker.GetBalance(all, confirmed, chainActive.Height());
+    }
+    BOOST_CHECK_EQUAL(all, 21 * COIN - usedAmount);
+
+    tracker.ClearMintEntries();
+    BOOST_CHECK(!tracker.GetMintEntry(mints[0].hashSerial, used));
+}
+
+/*
+HDMint mintpool regeneration test
+- test that mints derived in parallel batches match the mintpool written by GenerateMintPool.
+*/
+BOOST_AUTO_TEST_CASE(mintpool_regenerate)
+{
+    CWalletDB walletdb(pwalletMain->strWalletFile);
+    vector<std::pair<uint256, MintPoolEntry>> listMintPool = walletdb.ListMintPool();
+    std::vector<std::pair<uint256, GroupElement>> serialPubcoinPairs = walletdb.ListSerialPubcoinPairs();
+    BOOST_CHECK(!listMintPool.empty());
+
+    std::vector<MintPoolEntry> entries;
+    for (auto& mintPoolPair : listMintPool)
+        entries.push_back(mintPoolPair.second);
+
+    std::vector<std::pair<uint256,uint256>> vIndexes = zwalletMain->RegenerateMintPoolEntries(entries);
+    BOOST_CHECK_EQUAL(vIndexes.size(), listMintPool.size());
+
+    for (size_t i = 0; i < listMintPool.size(); i++) {
+        uint256 hashSerial;
+        BOOST_CHECK(vIndexes[i].first == listMintPool[i].first);
+        BOOST_CHECK(zwalletMain->GetSerialForPubcoin(serialPubcoinPairs, listMintPool[i].first, hashSerial));
+        BOOST_CHECK(vIndexes[i].second == hashSerial);
+    }
+
+    // The same mint regenerated on its own
+    CKeyID seedId = get<1>(entries[0]);
+    std::pair<uint256,uint256> nIndexes = zwalletMain->RegenerateMintPoolEntry(get<0>(entries[0]), seedId, get<2>(entries[0]));
+    BOOST_CHECK(nIndexes == vIndexes[0]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -236,4 +236,56 @@ BOOST_AUTO_TEST_CASE(Test_EnforceShroudnodePayment)
 
 
 
+BOOST_AUTO_TEST_CASE(Test_IsScheduled)
+{
+    CShroudnodePayments payments;
+
+    CKey key, keyOther;
+    key.MakeNewKey(true);
+    keyOther.MakeNewKey(true);
+    CShroudnode mn, mnOther;
+    mn.pubKeyCollateralAddress = key.GetPubKey();
+    mnOther.pubKeyCollateralAddress = keyOther.GetPubKey();
+
+    CBlockIndex tip;
+    tip.nHeight = 1000;
+    payments.UpdatedBlockTip(&tip);
+    BOOST_CHECK(!payments.IsScheduled(mn, 0));
+
+    // Scheduled for one block, unless it's the block asked about
+    CShroudnodeBlockPayees payees;
+    payees.vecPayees.push_back(CShroudnodePayee(GetScriptForDestination(key.GetPubKey().GetID()), uint256()));
+    payments.mapShroudnodeBlocks[1003] = payees;
+    payments.UpdatedBlockTip(&tip);
+    BOOST_CHECK(payments.IsScheduled(mn, 0));
+    BOOST_CHECK(!payments.IsScheduled(mn, 1003));
+    BOOST_CHECK(!payments.IsScheduled(mnOther, 0));
+
+    // Scheduled for two blocks
+    payments.mapShroudnodeBlocks[1005] = payees;
+    payments.UpdatedBlockTip(&tip);
+    BOOST_CHECK(payments.IsScheduled(mn, 1003));
+    BOOST_CHECK(payments.IsScheduled(mn, 1005));
+
+    // Only a pay-to-pubkey-hash script pays a shroudnode, and only the next blocks count
+    CShroudnodeBlockPayees payeesOther;
+    payeesOther.vecPayees.push_back(CShroudnodePayee(CScript() << ToByteVector(keyOther.GetPubKey()) << OP_CHECKSIG, uint256()));
+    payments.mapShroudnodeBlocks[1001] = payeesOther;
+    payeesOther.vecPayees[0] = CShroudnodePayee(GetScriptForDestination(keyOther.GetPubKey().GetID()), uint256());
+    payments.mapShroudnodeBlocks[1000 + MNPAYMENTS_SCHEDULED_BLOCKS + 1] = payeesOther;
+    payments.UpdatedBlockTip(&tip);
+    BOOST_CHECK(!payments.IsScheduled(mnOther, 0));
+
+    // The tip moves past the first block
+    tip.nHeight = 1004;
+    payments.UpdatedBlockTip(&tip);
+    BOOST_CHECK(!payments.IsScheduled(mn, 1005));
+    BOOST_CHECK(payments.IsScheduled(mn, 0));
+    BOOST_CHECK(payments.IsScheduled(mnOther, 0));
+
+    payments.Clear();
+    BOOST_CHECK(!payments.IsScheduled(mn, 0));
+    BOOST_CHECK(!payments.IsScheduled(mnOther, 0));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -560,9 +560,9 @@ BOOST_AUTO_TEST_CASE(sigma_getcoingroupinfo_existing)
     sigmaState->GetCoinGroupInfo(pubcoin.getDenomination(), 1, result);
     BOOST_CHECK_MESSAGE(result.nCoins == 1,
         "Unexpected number of coins in group.");
-    BOOST_CHECK_MESSAGE(result.firstBlock->mintedPubCoins.size() == index.mintedPubCoins.size(),
+    BOOST_CHECK_MESSAGE(result.firstBlock->GetPrivacyData().mintedPubCoins.size() == index.PrivacyData().mintedPubCoins.size(),
         "Unexpected first block index for Group info.");
-    BOOST_CHECK_MESSAGE(result.lastBlock->mintedPubCoins.size() == index.mintedPubCoins.size(),
+    BOOST_CHECK_MESSAGE(result.lastBlock->GetPrivacyData().mintedPubCoins.size() == index.PrivacyData().mintedPubCoins.size(),
         "Unexpected last block index for Group info.");
 
     sigmaState->Reset();
@@ -627,8 +627,8 @@ BOOST_AUTO_TEST_CASE(zerocoin_sigma_addblock_minted_spend)
     std::pair<sigma::CoinDenomination, int> denomination1Group1(
         sigma::CoinDenomination::SIGMA_DENOM_1,1);
 
-	index.sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin1);
-	index.sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin2);
+	index.PrivacyData().sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin1);
+	index.PrivacyData().sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin2);
 
 	sigmaState->AddBlock(&index);
 	BOOST_CHECK_MESSAGE(sigmaState->GetMints().size() == 2,
@@ -651,8 +651,8 @@ BOOST_AUTO_TEST_CASE(zerocoin_sigma_addblock_minted_spend)
 	auto spendSerial = coinSpend.getCoinSerialNumber();
 
     CBlockIndex index2 = CreateBlockIndex(2);
-	index2.sigmaSpentSerials.clear();
-	index2.sigmaSpentSerials.insert(std::make_pair(spendSerial, sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
+	index2.PrivacyData().sigmaSpentSerials.clear();
+	index2.PrivacyData().sigmaSpentSerials.insert(std::make_pair(spendSerial, sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
 	sigmaState->AddBlock(&index2);
 	BOOST_CHECK_MESSAGE(sigmaState->GetMints().size() == 2,
 	  "Unexpected mintedPubCoins size, add new block without additional minted.");
@@ -666,7 +666,7 @@ BOOST_AUTO_TEST_CASE(zerocoin_sigma_addblock_minted_spend)
     pubcoin3 = privcoin3.getPublicCoin();
     CBlockIndex index3 = CreateBlockIndex(3);
 
-    index3.sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin3);
+    index3.PrivacyData().sigmaMintedPubCoins[denomination1Group1].push_back(pubcoin3);
     sigmaState->AddBlock(&index3);
     BOOST_CHECK_MESSAGE(sigmaState->GetMints().size() == 3,
 	  "Unexpected mintedPubCoins size, add new block with one more minted.");
@@ -689,7 +689,7 @@ BOOST_AUTO_TEST_CASE(zerocoin_sigma_removeblock_remove)
 
     auto index1 = CreateBlockIndex(1);
     std::pair<sigma::CoinDenomination, int> denomination1Group1(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
-    index1.sigmaMintedPubCoins[denomination1Group1] = pubCoins;
+    index1.PrivacyData().sigmaMintedPubCoins[denomination1Group1] = pubCoins;
 
     // add index 2 with 10 minted and 1 spend
     auto coins2 = generateCoins(params,10, sigma::CoinDenomination::SIGMA_DENOM_1);
@@ -697,15 +697,15 @@ BOOST_AUTO_TEST_CASE(zerocoin_sigma_removeblock_remove)
 
     auto index2 = CreateBlockIndex(2);
     std::pair<sigma::CoinDenomination, int> denomination1Group2(sigma::CoinDenomination::SIGMA_DENOM_1, 2);
-    index2.sigmaMintedPubCoins[denomination1Group2] = pubCoins2;
+    index2.PrivacyData().sigmaMintedPubCoins[denomination1Group2] = pubCoins2;
 
     // Doesn't really matter what metadata we give here, it must pass.
     sigma::SpendMetaData metaData(0, uint256S("120"), uint256S("120"));
 
     sigma::CoinSpend coinSpend(params, coins[0], pubCoins, metaData, true);
 
-    index2.sigmaSpentSerials.clear();
-    index2.sigmaSpentSerials.insert(std::make_pair(coinSpend.getCoinSerialNumber(), sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
+    index2.PrivacyData().sigmaSpentSerials.clear();
+    index2.PrivacyData().sigmaSpentSerials.insert(std::make_pair(coinSpend.getCoinSerialNumber(), sigma::CSpendCoinInfo::make(coinSpend.getDenomination(), 0)));
 
     sigmaState->AddBlock(&index1);
     sigmaState->AddBlock(&index2);
@@ -921,7 +921,7 @@ BOOST_AUTO_TEST_CASE(sigma_build_state)
     std::pair<sigma::CoinDenomination, int> denomination1Group1(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
     std::pair<sigma::CoinDenomination, int> denomination10Group1(sigma::CoinDenomination::SIGMA_DENOM_10, 1);
 
-    index1.sigmaMintedPubCoins[denomination1Group1] = pubCoins;
+    index1.PrivacyData().sigmaMintedPubCoins[denomination1Group1] = pubCoins;
 
     chainActive.SetTip(&index1);
 
@@ -936,10 +936,10 @@ BOOST_AUTO_TEST_CASE(sigma_build_state)
     secp_primitives::Scalar serial;
     serial.randomize();
 
-    index2.sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
+    index2.PrivacyData().sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
 
-    index2.sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
-    index2.sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
+    index2.PrivacyData().sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
+    index2.PrivacyData().sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
 
     chainActive.SetTip(&index2);
 
@@ -1054,7 +1054,7 @@ BOOST_AUTO_TEST_CASE(sigma_getcoinsetforspend)
     auto coins3 = generateCoins(params, 5, sigma::CoinDenomination::SIGMA_DENOM_10);
     auto pubCoins3 = getPubcoins(coins3);
 
-    indexes[nextIndex].sigmaMintedPubCoins[denomination1Group1] = pubCoins;
+    indexes[nextIndex].PrivacyData().sigmaMintedPubCoins[denomination1Group1] = pubCoins;
     chainActive.SetTip(&indexes[nextIndex]);
 
     nextIndex++;
@@ -1064,9 +1064,9 @@ BOOST_AUTO_TEST_CASE(sigma_getcoinsetforspend)
     secp_primitives::Scalar serial;
     serial.randomize();
 
-    indexes[nextIndex].sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
-    indexes[nextIndex].sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
-    indexes[nextIndex].sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
+    indexes[nextIndex].PrivacyData().sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 0)));
+    indexes[nextIndex].PrivacyData().sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
+    indexes[nextIndex].PrivacyData().sigmaMintedPubCoins[denomination10Group1] = pubCoins3;
 
     chainActive.SetTip(&indexes[nextIndex]);
 
@@ -1109,6 +1109,92 @@ BOOST_AUTO_TEST_CASE(sigma_getcoinsetforspend)
     sigmaState->Reset();
 }
 
+BOOST_AUTO_TEST_CASE(sigma_getanonymityset)
+{
+    sigma::CSigmaState sigmaState;
+    sigma::Params* params = sigma::Params::get_default();
+    std::pair<sigma::CoinDenomination, int> denomination1Group1(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
+
+    // blocks 1, 3 and 4 mint coins of the group, block 2 doesn't
+    std::vector<uint256> hashes(5);
+    std::vector<CBlockIndex> indexes(5);
+    std::vector<std::vector<sigma::PublicCoin>> pubCoins(5);
+    for (int i = 1; i < 5; i++) {
+        hashes[i] = uint256S(std::to_string(i));
+        indexes[i].nHeight = i;
+        indexes[i].pprev = i > 1 ? &indexes[i - 1] : NULL;
+        indexes[i].phashBlock = &hashes[i];
+        if (i != 2) {
+            pubCoins[i] = getPubcoins(generateCoins(params, i == 4 ? 1 : 5 - i, sigma::CoinDenomination::SIGMA_DENOM_1));
+            indexes[i].PrivacyData().sigmaMintedPubCoins[denomination1Group1] = pubCoins[i];
+        }
+        sigmaState.AddBlock(&indexes[i]);
+    }
+
+    auto concat = [&pubCoins](std::initializer_list<int> blocks) {
+        std::vector<sigma::PublicCoin> result;
+        for (int i : blocks)
+            result.insert(result.end(), pubCoins[i].begin(), pubCoins[i].end());
+        return result;
+    };
+
+    uint256 blockHash;
+    std::vector<sigma::PublicCoin> coins;
+
+    // later blocks first, as spends are proven against them
+    BOOST_CHECK(sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_1, 1, 100, uint256(), blockHash, coins));
+    BOOST_CHECK(coins == concat({4, 3, 1}));
+    BOOST_CHECK(blockHash == hashes[4]);
+
+    // same as the set used for spends
+    std::vector<sigma::PublicCoin> spendCoins;
+    uint256 spendBlockHash;
+    BOOST_CHECK_EQUAL(sigmaState.GetCoinSetForSpend(&chainActive, 100, sigma::CoinDenomination::SIGMA_DENOM_1, 1, spendBlockHash, spendCoins), coins.size());
+    BOOST_CHECK(spendCoins == coins);
+    BOOST_CHECK(spendBlockHash == blockHash);
+
+    BOOST_CHECK(sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_1, 1, 3, uint256(), blockHash, coins));
+    BOOST_CHECK(coins == concat({3, 1}));
+    BOOST_CHECK(blockHash == hashes[3]);
+
+    BOOST_CHECK(sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_1, 1, 2, uint256(), blockHash, coins));
+    BOOST_CHECK(coins == concat({1}));
+    BOOST_CHECK(blockHash == hashes[1]);
+
+    blockHash.SetNull();
+    BOOST_CHECK(sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_1, 1, 0, uint256(), blockHash, coins));
+    BOOST_CHECK(coins.empty());
+    BOOST_CHECK(blockHash.IsNull());
+
+    // tails since an earlier reply
+    BOOST_CHECK(sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_1, 1, 100, hashes[1], blockHash, coins));
+    BOOST_CHECK(coins == concat({4, 3}));
+    BOOST_CHECK(blockHash == hashes[4]);
+
+    BOOST_CHECK(sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_1, 1, 100, hashes[4], blockHash, coins));
+    BOOST_CHECK(coins.empty());
+    BOOST_CHECK(blockHash == hashes[4]);
+
+    BOOST_CHECK(!sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_1, 1, 100, hashes[2], blockHash, coins));
+    BOOST_CHECK(!sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_1, 2, 100, uint256(), blockHash, coins));
+    BOOST_CHECK(!sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_10, 1, 100, uint256(), blockHash, coins));
+
+    // the cache follows disconnected and connected blocks
+    sigmaState.RemoveBlock(&indexes[4]);
+    BOOST_CHECK(sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_1, 1, 100, uint256(), blockHash, coins));
+    BOOST_CHECK(coins == concat({3, 1}));
+    BOOST_CHECK(blockHash == hashes[3]);
+
+    sigmaState.AddBlock(&indexes[4]);
+    BOOST_CHECK(sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_1, 1, 100, uint256(), blockHash, coins));
+    BOOST_CHECK(coins == concat({4, 3, 1}));
+    BOOST_CHECK(blockHash == hashes[4]);
+
+    for (int i = 4; i > 0; i--)
+        sigmaState.RemoveBlock(&indexes[i]);
+    BOOST_CHECK(!sigmaState.GetAnonymitySet(sigma::CoinDenomination::SIGMA_DENOM_1, 1, 100, uint256(), blockHash, coins));
+}
+
 namespace {
     Scalar generateSpend(sigma::CoinDenomination denom) {
         auto params = sigma::Params::get_default();
@@ -1199,5 +1285,114 @@ BOOST_AUTO_TEST_CASE(sigma_surge_detection_failure_anywhere)
     sigmaState->Reset();
 }
 
+BOOST_AUTO_TEST_CASE(sigma_snapshot_roundtrip)
+{
+    auto params = sigma::Params::get_default();
+
+    std::vector<uint256> hashes(4);
+    std::vector<CBlockIndex> indexes(4);
+    for (int i = 0; i < 4; i++) {
+        hashes[i] = uint256S(strprintf("%064x", i + 1));
+        indexes[i].nHeight = i;
+        indexes[i].phashBlock = &hashes[i];
+        indexes[i].pprev = i > 0 ? &indexes[i - 1] : NULL;
+    }
+
+    std::pair<sigma::CoinDenomination, int> denomination1Group1(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
+    auto pubCoins1 = getPubcoins(generateCoins(params, 5, sigma::CoinDenomination::SIGMA_DENOM_1));
+    auto pubCoins2 = getPubcoins(generateCoins(params, 3, sigma::CoinDenomination::SIGMA_DENOM_1));
+    indexes[1].PrivacyData().sigmaMintedPubCoins[denomination1Group1] = pubCoins1;
+    indexes[3].PrivacyData().sigmaMintedPubCoins[denomination1Group1] = pubCoins2;
+
+    secp_primitives::Scalar serial;
+    serial.randomize();
+    indexes[3].PrivacyData().sigmaSpentSerials[serial] = sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
+
+    CChain chain;
+    chain.SetTip(&indexes[3]);
+
+    sigma::CSigmaState state;
+    for (auto& index : indexes)
+        state.AddBlock(&index);
+
+    CDataStream stream(SER_DISK, CLIENT_VERSION);
+    state.WriteSnapshot(stream);
+    CDataStream copy(stream);
+
+    sigma::CSigmaState loaded;
+    BOOST_CHECK(loaded.ReadSnapshot(stream, &chain));
+    BOOST_CHECK(stream.empty());
+
+    sigma::CSigmaState::SigmaCoinGroupInfo group;
+    BOOST_CHECK(loaded.GetCoinGroupInfo(sigma::CoinDenomination::SIGMA_DENOM_1, 1, group));
+    BOOST_CHECK(group.firstBlock == &indexes[1]);
+    BOOST_CHECK(group.lastBlock == &indexes[3]);
+    BOOST_CHECK_EQUAL(group.nCoins, 8);
+    BOOST_CHECK_EQUAL(loaded.GetLatestCoinID(sigma::CoinDenomination::SIGMA_DENOM_1), 1);
+    BOOST_CHECK(loaded.HasCoin(pubCoins1[0]));
+    BOOST_CHECK(loaded.GetMintedCoinHeightAndId(pubCoins2[2]) == std::make_pair(3, 1));
+    BOOST_CHECK(loaded.IsUsedCoinSerial(serial));
+    BOOST_CHECK_EQUAL(loaded.GetMints().size(), state.GetMints().size());
+    BOOST_CHECK_EQUAL(loaded.GetSpends().size(), state.GetSpends().size());
+
+    // The snapshot is rejected if the coin group blocks are not in the chain
+    hashes[3] = uint256S("ff");
+    BOOST_CHECK(!loaded.ReadSnapshot(copy, &chain));
+    BOOST_CHECK(loaded.GetMints().empty());
+    BOOST_CHECK(loaded.GetCoinGroups().empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(sigma_spend_tx_hash)
+{
+    auto params = sigma::Params::get_default();
+    auto coins = generateCoins(params, 2, sigma::CoinDenomination::SIGMA_DENOM_0_1);
+    auto pubCoins = getPubcoins(coins);
+    sigma::SpendMetaData metaData(0, uint256S("120"), uint256S("120"));
+
+    CMutableTransaction tx;
+    for (const sigma::PrivateCoin& coin : coins) {
+        sigma::CoinSpend coinSpend(params, coin, pubCoins, metaData, true);
+        CDataStream serializedCoinSpend(SER_NETWORK, PROTOCOL_VERSION);
+        serializedCoinSpend << coinSpend;
+
+        CTxIn in;
+        in.prevout.n = 1;
+        in.scriptSig = CScript() << OP_SIGMASPEND;
+        in.scriptSig.insert(in.scriptSig.end(), serializedCoinSpend.begin(), serializedCoinSpend.end());
+        tx.vin.push_back(in);
+    }
+    // an input that isn't a sigma spend keeps its scriptSig
+    tx.vin.push_back(CTxIn(COutPoint(txHash, 3), CScript() << OP_TRUE, 5));
+    tx.vout.push_back(CTxOut(10 * COIN, CScript() << OP_TRUE));
+    tx.nLockTime = 100;
+
+    CMutableTransaction txStripped(tx);
+    for (CTxIn& in : txStripped.vin) {
+        if (in.scriptSig.IsSigmaSpend())
+            in.scriptSig.clear();
+    }
+
+    BOOST_CHECK(sigma::GetSigmaSpendTxHash(tx) == txStripped.GetHash());
+    BOOST_CHECK(sigma::GetSigmaSpendTxHash(CTransaction(tx)) == txStripped.GetHash());
+    BOOST_CHECK(sigma::GetSigmaSpendTxHash(tx) != tx.GetHash());
+
+    // witness data is left out, the same way the copy with cleared sigma scriptSigs hashes it
+    tx.wit.vtxinwit.resize(tx.vin.size());
+    tx.wit.vtxinwit.back().scriptWitness.stack.push_back(std::vector<unsigned char>(72, 1));
+    tx.wit.vtxinwit.back().scriptWitness.stack.push_back(std::vector<unsigned char>(33, 2));
+
+    CMutableTransaction txWitnessStripped(tx);
+    for (CTxIn& in : txWitnessStripped.vin) {
+        if (in.scriptSig.IsSigmaSpend())
+            in.scriptSig.clear();
+    }
+
+    BOOST_CHECK(!CTransaction(tx).wit.IsNull());
+    BOOST_CHECK(sigma::GetSigmaSpendTxHash(tx) == txWitnessStripped.GetHash());
+    BOOST_CHECK(sigma::GetSigmaSpendTxHash(CTransaction(tx)) == txWitnessStripped.GetHash());
+    BOOST_CHECK(sigma::GetSigmaSpendTxHash(tx) == txStripped.GetHash());
+    BOOST_CHECK(sigma::GetSigmaSpendTxHash(CTransaction(tx)) != CTransaction(txWitnessStripped).GetWitnessHash());
+}
 
 BOOST_AUTO_TEST_SUITE_END()
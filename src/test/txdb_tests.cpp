@@ -3,6 +3,9 @@
 #include "random.h"
 #include "test/test_bitcoin.h"
 #include "base58.h"
+#include "main.h"
+#include "sigma.h"
+#include "zerocoin.h"
 
 #include <boost/assert.hpp>
 #include <boost/test/unit_test.hpp>
@@ -32,8 +35,7 @@ CTransaction TxFromStr(std::string const & str)
 
 void AddTxToView(CTransaction const & tx, int height, CCoinsViewCache & viewCache)
 {
-    CCoinsModifier coins = viewCache.ModifyCoins(tx.GetHash());
-    coins->FromTx(tx, height);
+    AddCoins(viewCache, tx, height);
 }
 }
 
@@ -339,4 +341,136 @@ BOOST_AUTO_TEST_CASE(dbindexhelper_zerospend)
     }
 }
 
+BOOST_AUTO_TEST_CASE(privacysupply_connect_disconnect)
+{
+    CBlock block;
+    block.zerocoinTxInfo = std::make_shared<CZerocoinTxInfo>();
+    block.zerocoinTxInfo->mints.push_back(std::make_pair(10, CBigNum(1)));
+    block.zerocoinTxInfo->mints.push_back(std::make_pair(10, CBigNum(2)));
+    block.zerocoinTxInfo->spentSerials[CBigNum(3)] = 10;
+    block.sigmaTxInfo = std::make_shared<sigma::CSigmaTxInfo>();
+    block.sigmaTxInfo->mints.push_back(sigma::PublicCoin(GroupElement(), sigma::CoinDenomination::SIGMA_DENOM_1));
+    block.sigmaTxInfo->spentSerials.insert(std::make_pair(Scalar(uint64_t(1)), sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 1)));
+
+    CBlock emptyBlock;
+    CPrivacySupply supply;
+
+    BOOST_CHECK(!pblocktree->ReadPrivacySupply(supply));
+
+    BOOST_CHECK(pblocktree->ConnectPrivacySupply(block, 100));
+    BOOST_CHECK(pblocktree->ConnectPrivacySupply(emptyBlock, 101));
+    BOOST_CHECK(pblocktree->ReadPrivacySupply(supply));
+    BOOST_CHECK_EQUAL(supply.nHeight, 100);
+    BOOST_CHECK_EQUAL(supply.nPrevHeight, -1);
+    BOOST_CHECK_EQUAL(supply.zerocoin[10 * COIN].nMinted, 2);
+    BOOST_CHECK_EQUAL(supply.zerocoin[10 * COIN].nSpent, 1);
+    BOOST_CHECK_EQUAL(supply.sigma[COIN].nMinted, 1);
+    BOOST_CHECK_EQUAL(supply.sigma[COIN].nSpent, 1);
+    BOOST_CHECK_EQUAL(CPrivacySupply::GetUnspentAmount(supply.zerocoin), 10 * COIN);
+    BOOST_CHECK_EQUAL(CPrivacySupply::GetUnspentAmount(supply.sigma), 0);
+
+    BOOST_CHECK(pblocktree->ConnectPrivacySupply(block, 102));
+    BOOST_CHECK(pblocktree->ReadPrivacySupply(supply));
+    BOOST_CHECK_EQUAL(supply.nHeight, 102);
+    BOOST_CHECK_EQUAL(supply.nPrevHeight, 100);
+    BOOST_CHECK_EQUAL(supply.zerocoin[10 * COIN].nMinted, 4);
+
+    std::vector<CPrivacySupply> history;
+    BOOST_CHECK(pblocktree->ReadPrivacySupplyHistory(0, 1000, history));
+    BOOST_CHECK_EQUAL(history.size(), 2);
+    history.clear();
+    BOOST_CHECK(pblocktree->ReadPrivacySupplyHistory(101, 1000, history));
+    BOOST_CHECK_EQUAL(history.size(), 1);
+    BOOST_CHECK_EQUAL(history[0].nHeight, 102);
+
+    BOOST_CHECK(pblocktree->DisconnectPrivacySupply(102));
+    BOOST_CHECK(pblocktree->DisconnectPrivacySupply(101));
+    BOOST_CHECK(pblocktree->ReadPrivacySupply(supply));
+    BOOST_CHECK_EQUAL(supply.nHeight, 100);
+    BOOST_CHECK_EQUAL(supply.zerocoin[10 * COIN].nMinted, 2);
+
+    BOOST_CHECK(pblocktree->DisconnectPrivacySupply(100));
+    BOOST_CHECK(!pblocktree->ReadPrivacySupply(supply));
+    history.clear();
+    BOOST_CHECK(pblocktree->ReadPrivacySupplyHistory(0, 1000, history));
+    BOOST_CHECK(history.empty());
+}
+
+BOOST_AUTO_TEST_CASE(addressbalanceindex_connect_disconnect)
+{
+    uint160 const hash = uint160(ParseHex("0101010101010101010101010101010101010101"));
+    uint256 const txid1 = uint256S("01"), txid2 = uint256S("02");
+
+    std::vector<std::pair<CAddressIndexKey, CAmount> > block1, block2;
+    block1.push_back(std::make_pair(CAddressIndexKey(AddressType::payToPubKeyHash, hash, 10, 1, txid1, 0, false), 50));
+    block1.push_back(std::make_pair(CAddressIndexKey(AddressType::payToPubKeyHash, hash, 10, 1, txid1, 1, false), 20));
+    block2.push_back(std::make_pair(CAddressIndexKey(AddressType::payToPubKeyHash, hash, 12, 1, txid2, 0, true), -50));
+
+    CAddressBalanceValue value;
+
+    BOOST_CHECK(pblocktree->ConnectAddressBalanceIndex(block1, 10));
+    BOOST_CHECK(pblocktree->ConnectAddressBalanceIndex(block2, 12));
+    BOOST_CHECK(pblocktree->ReadAddressBalanceIndex(hash, AddressType::payToPubKeyHash, value));
+    BOOST_CHECK_EQUAL(value.balance, 20);
+    BOOST_CHECK_EQUAL(value.received, 70);
+    BOOST_CHECK_EQUAL(value.utxoCount, 1);
+    BOOST_CHECK_EQUAL(value.firstHeight, 10);
+    BOOST_CHECK_EQUAL(value.lastHeight, 12);
+
+    BOOST_CHECK(pblocktree->DisconnectAddressBalanceIndex(12));
+    BOOST_CHECK(pblocktree->ReadAddressBalanceIndex(hash, AddressType::payToPubKeyHash, value));
+    BOOST_CHECK_EQUAL(value.balance, 70);
+    BOOST_CHECK_EQUAL(value.utxoCount, 2);
+    BOOST_CHECK_EQUAL(value.lastHeight, 10);
+
+    BOOST_CHECK(pblocktree->DisconnectAddressBalanceIndex(10));
+    BOOST_CHECK(pblocktree->ReadAddressBalanceIndex(hash, AddressType::payToPubKeyHash, value));
+    BOOST_CHECK(value.IsNull());
+}
+
+BOOST_AUTO_TEST_CASE(blockprivacydata_release_reload)
+{
+    uint256 hash = uint256S("0a");
+    CBlockIndex* pindex = new CBlockIndex();
+    pindex->nHeight = 10;
+    pindex->phashBlock = &mapBlockIndex.insert(std::make_pair(hash, pindex)).first->first;
+
+    sigma::PublicCoin coin(GroupElement(), sigma::CoinDenomination::SIGMA_DENOM_1);
+    pindex->PrivacyData().sigmaMintedPubCoins[std::make_pair(sigma::CoinDenomination::SIGMA_DENOM_1, 1)].push_back(coin);
+    pindex->PrivacyData().spentSerials.insert(CBigNum(3));
+    pindex->UpdatePrivacyDataStatus();
+    BOOST_CHECK(pindex->nStatus & BLOCK_HAVE_PRIVACY_DATA);
+
+    std::vector<const CBlockIndex*> blocks(1, pindex);
+    BOOST_CHECK(pblocktree->WriteBatchSync(std::vector<std::pair<int, const CBlockFileInfo*> >(), 0, blocks));
+
+    // Dirty entries stay in memory
+    std::set<CBlockIndex*> pinned;
+    pinned.insert(pindex);
+    pblocktree->TrimPrivacyData(0, pinned);
+    BOOST_CHECK(pindex->privacyData);
+
+    pblocktree->TrimPrivacyData(0, std::set<CBlockIndex*>());
+    BOOST_CHECK(!pindex->privacyData);
+
+    const CBlockIndexPrivacyData& data = pindex->GetPrivacyData();
+    BOOST_CHECK(pindex->privacyData);
+    BOOST_CHECK_EQUAL(data.sigmaMintedPubCoins.size(), 1);
+    BOOST_CHECK(data.sigmaMintedPubCoins.begin()->second == std::vector<sigma::PublicCoin>(1, coin));
+    BOOST_CHECK_EQUAL(data.spentSerials.size(), 1);
+    BOOST_CHECK_EQUAL(data.spentSerials.count(CBigNum(3)), 1);
+
+    // Block without a payload, nothing is allocated or read
+    pindex->PrivacyData().SetNull();
+    pindex->UpdatePrivacyDataStatus();
+    BOOST_CHECK(!(pindex->nStatus & BLOCK_HAVE_PRIVACY_DATA));
+    BOOST_CHECK(pblocktree->WriteBatchSync(std::vector<std::pair<int, const CBlockFileInfo*> >(), 0, blocks));
+    pblocktree->TrimPrivacyData(0, std::set<CBlockIndex*>());
+    BOOST_CHECK(pindex->GetPrivacyData().IsNull());
+    BOOST_CHECK(!pindex->privacyData);
+
+    mapBlockIndex.erase(hash);
+    delete pindex;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
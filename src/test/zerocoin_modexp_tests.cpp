@@ -0,0 +1,84 @@
+// Copyright (c) 2020 The ShroudX developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "libzerocoin/ModExp.h"
+#include "zerocoin.h"
+
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(zerocoin_modexp_tests, BasicTestingSetup)
+
+static void CheckFixedBase(const CBigNum& base, const CBigNum& modulus)
+{
+    auto modExp = libzerocoin::FixedBaseModExp::Get(base, modulus);
+    BOOST_CHECK(modExp == libzerocoin::FixedBaseModExp::Get(base, modulus));
+
+    // exponents shorter and longer than the precomputed tables, negative ones and zero
+    BOOST_CHECK(modExp->pow(CBigNum(0)) == base.pow_mod(CBigNum(0), modulus));
+    for (int bits : {1, 64, modulus.bitSize() - 1, modulus.bitSize() + 700, modulus.bitSize() + 1100}) {
+        CBigNum exponent = CBigNum::RandKBitBigum(bits);
+        BOOST_CHECK(modExp->pow(exponent) == base.pow_mod(exponent, modulus));
+        BOOST_CHECK(modExp->pow(exponent * -1) == base.pow_mod(exponent * -1, modulus));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fixed_base)
+{
+    const libzerocoin::Params* params = ZCParams;
+
+    CheckFixedBase(params->coinCommitmentGroup.g, params->coinCommitmentGroup.modulus);
+    CheckFixedBase(params->coinCommitmentGroup.h, params->serialNumberSoKCommitmentGroup.groupOrder);
+    CheckFixedBase(params->serialNumberSoKCommitmentGroup.h, params->serialNumberSoKCommitmentGroup.modulus);
+    CheckFixedBase(params->accumulatorParams.accumulatorPoKCommitmentGroup.g, params->accumulatorParams.accumulatorPoKCommitmentGroup.modulus);
+    CheckFixedBase(params->accumulatorParams.accumulatorQRNCommitmentGroup.h, params->accumulatorParams.accumulatorModulus);
+
+    // Montgomery multiplication doesn't work with even moduli
+    CheckFixedBase(CBigNum(3), CBigNum(1) << 300);
+}
+
+BOOST_AUTO_TEST_CASE(montgomery_modulus)
+{
+    const CBigNum& modulus = ZCParams->accumulatorParams.accumulatorModulus;
+    auto modExp = libzerocoin::MontgomeryModulus::Get(modulus);
+    BOOST_CHECK(modExp == libzerocoin::MontgomeryModulus::Get(modulus));
+
+    for (int i = 0; i < 4; i++) {
+        CBigNum base = CBigNum::randBignum(modulus);
+        CBigNum exponent = CBigNum::RandKBitBigum(modulus.bitSize());
+        BOOST_CHECK(modExp->pow(base, exponent) == base.pow_mod(exponent, modulus));
+        BOOST_CHECK(modExp->pow(base, exponent * -1) == base.pow_mod(exponent * -1, modulus));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(multi_exponentiation)
+{
+    const libzerocoin::Params* params = ZCParams;
+
+    for (const CBigNum& modulus : {params->accumulatorParams.accumulatorModulus, params->serialNumberSoKCommitmentGroup.modulus, CBigNum(1) << 300}) {
+        libzerocoin::MontgomeryModulus modExp(modulus);
+
+        // no bases at all, zero exponents, negative exponents and exponents of different lengths
+        BOOST_CHECK(modExp.pow(std::vector<CBigNum>(), std::vector<CBigNum>()) == CBigNum(1));
+        for (size_t k = 1; k <= 4; k++) {
+            std::vector<CBigNum> bases, exponents;
+            CBigNum expected = 1;
+            for (size_t i = 0; i < k; i++) {
+                bases.push_back(CBigNum::randBignum(modulus) + (i == 1 ? modulus : CBigNum(0)));
+                exponents.push_back(i == 2 ? CBigNum(0) : CBigNum::RandKBitBigum(modulus.bitSize() + 64 * i));
+                // a random base is invertible modulo the odd moduli
+                if (i == 3 && BN_is_odd(&modulus))
+                    exponents.back() = exponents.back() * -1;
+                expected = expected * bases.back().pow_mod(exponents.back(), modulus) % modulus;
+            }
+            BOOST_CHECK(modExp.pow(bases, exponents) == expected);
+        }
+    }
+
+    libzerocoin::MontgomeryModulus modExp(CBigNum(97));
+    BOOST_CHECK_THROW(modExp.pow({CBigNum(2)}, {CBigNum(1), CBigNum(2)}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -12,6 +12,8 @@
 #include "main.h"
 #include "consensus/consensus.h"
 #include "base58.h"
+#include "init.h"
+#include "ui_interface.h"
 
 #include <stdint.h>
 
@@ -19,11 +21,14 @@
 
 using namespace std;
 
+static const char DB_COIN = 'C';
 static const char DB_COINS = 'c';
 static const char DB_BLOCK_FILES = 'f';
 static const char DB_TXINDEX = 't';
 static const char DB_ADDRESSINDEX = 'a';
 static const char DB_ADDRESSUNSPENTINDEX = 'u';
+static const char DB_ADDRESSBALANCEINDEX = 'd';
+static const char DB_ADDRESSBALANCEUNDO = 'D';
 static const char DB_TIMESTAMPINDEX = 's';
 static const char DB_SPENTINDEX = 'p';
 static const char DB_BLOCK_INDEX = 'b';
@@ -33,18 +38,40 @@ static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
 static const char DB_TOTAL_SUPPLY = 'S';
+static const char DB_PRIVACY_SUPPLY = 'z';
+static const char DB_PRIVACY_SUPPLY_HISTORY = 'Z';
+static const char DB_BLOCK_PRIVACY_DATA = 'P';
 
 
+namespace {
+
+struct CoinEntry {
+    COutPoint* outpoint;
+    char key;
+    CoinEntry(const COutPoint* ptr) : outpoint(const_cast<COutPoint*>(ptr)), key(DB_COIN) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
+        READWRITE(key);
+        READWRITE(outpoint->hash);
+        READWRITE(VARINT(outpoint->n));
+    }
+};
+
+}
+
 CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true)
 {
 }
 
-bool CCoinsViewDB::GetCoins(const uint256 &txid, CCoins &coins) const {
-    return db.Read(make_pair(DB_COINS, txid), coins);
+bool CCoinsViewDB::GetCoin(const COutPoint &outpoint, Coin &coin) const {
+    return db.Read(CoinEntry(&outpoint), coin);
 }
 
-bool CCoinsViewDB::HaveCoins(const uint256 &txid) const {
-    return db.Exists(make_pair(DB_COINS, txid));
+bool CCoinsViewDB::HaveCoin(const COutPoint &outpoint) const {
+    return db.Exists(CoinEntry(&outpoint));
 }
 
 uint256 CCoinsViewDB::GetBestBlock() const {
@@ -60,10 +87,11 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     size_t changed = 0;
     for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
         if (it->second.flags & CCoinsCacheEntry::DIRTY) {
-            if (it->second.coins.IsPruned())
-                batch.Erase(make_pair(DB_COINS, it->first));
+            CoinEntry entry(&it->first);
+            if (it->second.coin.IsSpent())
+                batch.Erase(entry);
             else
-                batch.Write(make_pair(DB_COINS, it->first), it->second.coins);
+                batch.Write(entry, it->second.coin);
             changed++;
         }
         count++;
@@ -73,11 +101,17 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     if (!hashBlock.IsNull())
         batch.Write(DB_BEST_BLOCK, hashBlock);
 
-    LogPrint("coindb", "Committing %u changed transactions (out of %u) to coin database...\n", (unsigned int)changed, (unsigned int)count);
+    LogPrint("coindb", "Committing %u changed transaction outputs (out of %u) to coin database...\n", (unsigned int)changed, (unsigned int)count);
     return db.WriteBatch(batch);
 }
 
 CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe) {
+    pprivacydatastore = this;
+}
+
+CBlockTreeDB::~CBlockTreeDB() {
+    if (pprivacydatastore == this)
+        pprivacydatastore = NULL;
 }
 
 bool CBlockTreeDB::ReadBlockFileInfo(int nFile, CBlockFileInfo &info) {
@@ -106,25 +140,31 @@ CCoinsViewCursor *CCoinsViewDB::Cursor() const
     /* It seems that there are no "const iterators" for LevelDB.  Since we
        only need read operations on it, use a const-cast to get around
        that restriction.  */
-    i->pcursor->Seek(DB_COINS);
+    i->pcursor->Seek(DB_COIN);
     // Cache key of first record
-    i->pcursor->GetKey(i->keyTmp);
+    if (i->pcursor->Valid()) {
+        CoinEntry entry(&i->keyTmp.second);
+        i->pcursor->GetKey(entry);
+        i->keyTmp.first = entry.key;
+    } else {
+        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+    }
     return i;
 }
 
-bool CCoinsViewDBCursor::GetKey(uint256 &key) const
+bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
 {
     // Return cached key
-    if (keyTmp.first == DB_COINS) {
+    if (keyTmp.first == DB_COIN) {
         key = keyTmp.second;
         return true;
     }
     return false;
 }
 
-bool CCoinsViewDBCursor::GetValue(CCoins &coins) const
+bool CCoinsViewDBCursor::GetValue(Coin &coin) const
 {
-    return pcursor->GetValue(coins);
+    return pcursor->GetValue(coin);
 }
 
 unsigned int CCoinsViewDBCursor::GetValueSize() const
@@ -134,14 +174,155 @@ unsigned int CCoinsViewDBCursor::GetValueSize() const
 
 bool CCoinsViewDBCursor::Valid() const
 {
-    return keyTmp.first == DB_COINS;
+    return keyTmp.first == DB_COIN;
 }
 
 void CCoinsViewDBCursor::Next()
 {
     pcursor->Next();
-    if (!pcursor->Valid() || !pcursor->GetKey(keyTmp))
+    CoinEntry entry(&keyTmp.second);
+    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
         keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
+    } else {
+        keyTmp.first = entry.key;
+    }
+}
+
+namespace {
+
+/**
+ * Per-transaction record of unspent outputs, the chainstate format before the upgrade to one
+ * record per output. Only read by CCoinsViewDB::Upgrade.
+ *
+ * Serialized format:
+ * - VARINT(nVersion)
+ * - VARINT(nCode)
+ * - unspentness bitvector, for vout[2] and further; least significant byte first
+ * - the non-spent CTxOuts (via CTxOutCompressor)
+ * - VARINT(nHeight)
+ *
+ * The nCode value consists of:
+ * - bit 0: IsCoinBase()
+ * - bit 1: IsCoinStake()
+ * - bit 2: vout[0] is not spent
+ * - bit 3: vout[1] is not spent
+ * - The higher bits encode N, the number of non-zero bytes in the following bitvector.
+ *   - In case both bit 2 and bit 3 are unset, they encode N-1, as there must be at
+ *     least one non-spent output).
+ */
+class CCoins
+{
+public:
+    bool fCoinBase;
+    bool fCoinStake;
+    std::vector<CTxOut> vout;
+    int nHeight;
+
+    CCoins() : fCoinBase(false), fCoinStake(false), nHeight(0) {}
+
+    template <typename Stream>
+    void Unserialize(Stream& s, int nType, int nVersion)
+    {
+        unsigned int nCode = 0;
+        // version
+        int nVersionDummy;
+        ::Unserialize(s, VARINT(nVersionDummy), nType, nVersion);
+        // header code
+        ::Unserialize(s, VARINT(nCode), nType, nVersion);
+        fCoinBase = nCode & 1;
+        fCoinStake = (nCode & 2) != 0;
+        std::vector<bool> vAvail(2, false);
+        vAvail[0] = (nCode & 4) != 0;
+        vAvail[1] = (nCode & 8) != 0;
+        unsigned int nMaskCode = (nCode / 16) + ((nCode & 12) != 0 ? 0 : 1);
+        // spentness bitmask
+        while (nMaskCode > 0) {
+            unsigned char chAvail = 0;
+            ::Unserialize(s, chAvail, nType, nVersion);
+            for (unsigned int p = 0; p < 8; p++) {
+                bool f = (chAvail & (1 << p)) != 0;
+                vAvail.push_back(f);
+            }
+            if (chAvail != 0)
+                nMaskCode--;
+        }
+        // txouts themself
+        vout.assign(vAvail.size(), CTxOut());
+        for (unsigned int i = 0; i < vAvail.size(); i++) {
+            if (vAvail[i])
+                ::Unserialize(s, REF(CTxOutCompressor(vout[i])), nType, nVersion);
+        }
+        // coinbase height
+        ::Unserialize(s, VARINT(nHeight), nType, nVersion);
+    }
+};
+
+}
+
+/** Upgrade the database from the older per-transaction format to the per-output one. */
+bool CCoinsViewDB::Upgrade() {
+    boost::scoped_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(make_pair(DB_COINS, uint256()));
+    if (!pcursor->Valid()) {
+        return true;
+    }
+
+    int64_t count = 0;
+    LogPrintf("Upgrading utxo-set database...\n");
+    LogPrintf("[0%%]...");
+    uiInterface.ShowProgress(_("Upgrading UTXO database"), 0);
+    size_t batch_size = 1 << 24;
+    CDBBatch batch(db);
+    int reportDone = 0;
+    std::pair<char, uint256> key;
+    std::pair<char, uint256> prev_key = make_pair(DB_COINS, uint256());
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        if (ShutdownRequested()) {
+            break;
+        }
+        if (pcursor->GetKey(key) && key.first == DB_COINS) {
+            if (count++ % 256 == 0) {
+                uint32_t high = 0x100 * *key.second.begin() + *(key.second.begin() + 1);
+                int percentageDone = (int)(high * 100.0 / 65536.0 + 0.5);
+                uiInterface.ShowProgress(_("Upgrading UTXO database"), percentageDone);
+                if (reportDone < percentageDone/10) {
+                    // report max. every 10% step
+                    LogPrintf("[%d%%]...", percentageDone);
+                    reportDone = percentageDone/10;
+                }
+            }
+            CCoins old_coins;
+            if (!pcursor->GetValue(old_coins)) {
+                return error("%s: cannot parse CCoins record", __func__);
+            }
+            COutPoint outpoint(key.second, 0);
+            for (size_t i = 0; i < old_coins.vout.size(); ++i) {
+                if (!old_coins.vout[i].IsNull() && !old_coins.vout[i].scriptPubKey.IsUnspendable()) {
+                    Coin newcoin(std::move(old_coins.vout[i]), old_coins.nHeight, old_coins.fCoinBase, old_coins.fCoinStake);
+                    outpoint.n = i;
+                    CoinEntry entry(&outpoint);
+                    batch.Write(entry, newcoin);
+                }
+            }
+            batch.Erase(key);
+            // Both formats are written in the same batch, an interrupted upgrade resumes where it stopped
+            if (batch.SizeEstimate() > batch_size) {
+                db.WriteBatch(batch);
+                batch.Clear();
+                db.CompactRange(prev_key, key);
+                prev_key = key;
+            }
+            pcursor->Next();
+        } else {
+            break;
+        }
+    }
+    db.WriteBatch(batch);
+    db.CompactRange(make_pair(DB_COINS, uint256()), key);
+    uiInterface.ShowProgress("", 100);
+    LogPrintf("[%s].\n", ShutdownRequested() ? "CANCELLED" : "DONE");
+    return !ShutdownRequested();
 }
 
 bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*> >& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo) {
@@ -152,10 +333,72 @@ bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockF
     batch.Write(DB_LAST_BLOCK, nLastFile);
     for (std::vector<const CBlockIndex*>::const_iterator it=blockinfo.begin(); it != blockinfo.end(); it++) {
     	batch.Write(make_pair(DB_BLOCK_INDEX, (*it)->GetBlockHash()), CDiskBlockIndex(*it));
+        // A payload which is not in memory didn't change since it was written
+        if ((*it)->privacyData) {
+            if ((*it)->nStatus & BLOCK_HAVE_PRIVACY_DATA)
+                batch.Write(make_pair(DB_BLOCK_PRIVACY_DATA, CBlockPrivacyDataKey(**it)), *(*it)->privacyData);
+            else
+                batch.Erase(make_pair(DB_BLOCK_PRIVACY_DATA, CBlockPrivacyDataKey(**it)));
+        }
     }
     return WriteBatch(batch, true);
 }
 
+bool CBlockTreeDB::WriteUpgradedBlockIndex(const std::vector<CBlockIndex*>& vBlocks) {
+    CDBBatch batch(*this);
+    for (CBlockIndex* pindex : vBlocks) {
+        pindex->UpdatePrivacyDataStatus();
+        batch.Write(make_pair(DB_BLOCK_INDEX, pindex->GetBlockHash()), CDiskBlockIndex(pindex));
+        if (pindex->nStatus & BLOCK_HAVE_PRIVACY_DATA)
+            batch.Write(make_pair(DB_BLOCK_PRIVACY_DATA, CBlockPrivacyDataKey(*pindex)), *pindex->privacyData);
+    }
+    if (!WriteBatch(batch, true))
+        return false;
+    for (CBlockIndex* pindex : vBlocks)
+        pindex->privacyData.reset();
+    return true;
+}
+
+void CBlockTreeDB::LoadPrivacyData(const CBlockIndex& index, CBlockIndexPrivacyData& data) {
+    if ((index.nStatus & BLOCK_HAVE_PRIVACY_DATA) &&
+            !Read(make_pair(DB_BLOCK_PRIVACY_DATA, CBlockPrivacyDataKey(index)), data))
+        LogPrintf("%s: no zerocoin/sigma data for block %s at height %d\n", __func__,
+            index.GetBlockHash().ToString(), index.nHeight);
+
+    LOCK(cs_privacyData);
+    uint256 hash = index.GetBlockHash();
+    auto it = mapPrivacyData.find(hash);
+    if (it != mapPrivacyData.end())
+        listPrivacyData.splice(listPrivacyData.end(), listPrivacyData, it->second);
+    else
+        mapPrivacyData[hash] = listPrivacyData.insert(listPrivacyData.end(), hash);
+}
+
+void CBlockTreeDB::TouchPrivacyData(const CBlockIndex& index) {
+    LOCK(cs_privacyData);
+    auto it = mapPrivacyData.find(index.GetBlockHash());
+    if (it != mapPrivacyData.end())
+        listPrivacyData.splice(listPrivacyData.end(), listPrivacyData, it->second);
+}
+
+void CBlockTreeDB::TrimPrivacyData(size_t nMaxEntries, const std::set<CBlockIndex*>& setPinned) {
+    LOCK(cs_privacyData);
+    // Every entry is looked at once at most, pinned ones go to the back of the list
+    for (size_t nLeft = listPrivacyData.size(); listPrivacyData.size() > nMaxEntries && nLeft > 0; nLeft--) {
+        uint256 hash = listPrivacyData.front();
+        BlockMap::iterator mi = mapBlockIndex.find(hash);
+        CBlockIndex* pindex = mi != mapBlockIndex.end() ? mi->second : NULL;
+        if (pindex && setPinned.count(pindex) > 0) {
+            listPrivacyData.splice(listPrivacyData.end(), listPrivacyData, listPrivacyData.begin());
+            continue;
+        }
+        if (pindex)
+            pindex->privacyData.reset();
+        mapPrivacyData.erase(hash);
+        listPrivacyData.pop_front();
+    }
+}
+
 bool CBlockTreeDB::ReadTxIndex(const uint256 &txid, CDiskTxPos &pos) {
     return Read(make_pair(DB_TXINDEX, txid), pos);
 }
@@ -237,11 +480,13 @@ bool CBlockTreeDB::EraseAddressIndex(const std::vector<std::pair<CAddressIndexKe
 
 bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, AddressType type,
                                     std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
-                                    int start, int end) {
+                                    int start, int end, size_t limit) {
 
     boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+    size_t count = 0;
+    int lastHeight = -1;
 
-    if (start > 0 && end > 0) {
+    if (start > 0) {
         pcursor->Seek(make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, start)));
     } else {
         pcursor->Seek(make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorKey(type, addressHash)));
@@ -254,9 +499,15 @@ bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, AddressType type,
             if (end > 0 && key.second.blockHeight > end) {
                 break;
             }
+            // Stop at a block boundary so the caller can continue from the next height
+            if (limit > 0 && count >= limit && key.second.blockHeight != lastHeight) {
+                break;
+            }
             CAmount nValue;
             if (pcursor->GetValue(nValue)) {
                 addressIndex.push_back(make_pair(key.second, nValue));
+                lastHeight = key.second.blockHeight;
+                ++count;
                 pcursor->Next();
             } else {
                 return error("failed to get address index value");
@@ -270,6 +521,56 @@ bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, AddressType type,
 }
 
 
+bool CBlockTreeDB::ConnectAddressBalanceIndex(const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect, int height) {
+    typedef std::map<std::pair<AddressType, uint160>, CAddressBalanceValue> BalanceMap;
+    BalanceMap balances;
+    CAddressBalanceUndo undo;
+
+    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
+        BalanceMap::iterator balance = balances.find(std::make_pair(it->first.type, it->first.hashBytes));
+        if (balance == balances.end()) {
+            CAddressIndexIteratorKey key(it->first.type, it->first.hashBytes);
+            CAddressBalanceValue value;
+            Read(make_pair(DB_ADDRESSBALANCEINDEX, key), value);
+            undo.push_back(make_pair(key, value));
+            balance = balances.insert(make_pair(std::make_pair(key.type, key.hashBytes), value)).first;
+        }
+        balance->second.ApplyDelta(it->first, it->second);
+    }
+
+    if (balances.empty())
+        return true;
+
+    CDBBatch batch(*this);
+    for (BalanceMap::const_iterator it=balances.begin(); it!=balances.end(); it++)
+        batch.Write(make_pair(DB_ADDRESSBALANCEINDEX, CAddressIndexIteratorKey(it->first.first, it->first.second)), it->second);
+    batch.Write(make_pair(DB_ADDRESSBALANCEUNDO, height), undo);
+    return WriteBatch(batch);
+}
+
+bool CBlockTreeDB::DisconnectAddressBalanceIndex(int height) {
+    CAddressBalanceUndo undo;
+    if (!Read(make_pair(DB_ADDRESSBALANCEUNDO, height), undo))
+        return true;
+
+    CDBBatch batch(*this);
+    for (CAddressBalanceUndo::const_iterator it=undo.begin(); it!=undo.end(); it++) {
+        if (it->second.IsNull())
+            batch.Erase(make_pair(DB_ADDRESSBALANCEINDEX, it->first));
+        else
+            batch.Write(make_pair(DB_ADDRESSBALANCEINDEX, it->first), it->second);
+    }
+    batch.Erase(make_pair(DB_ADDRESSBALANCEUNDO, height));
+    return WriteBatch(batch);
+}
+
+bool CBlockTreeDB::ReadAddressBalanceIndex(uint160 addressHash, AddressType type, CAddressBalanceValue &value) {
+    value.SetNull();
+    Read(make_pair(DB_ADDRESSBALANCEINDEX, CAddressIndexIteratorKey(type, addressHash)), value);
+    return true;
+}
+
+
 bool CBlockTreeDB::WriteTimestampIndex(const CTimestampIndexKey &timestampIndex) {
     CDBBatch batch(*this);
     batch.Write(make_pair(DB_TIMESTAMPINDEX, timestampIndex), 0);
@@ -317,6 +618,9 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
 
     pcursor->Seek(make_pair(DB_BLOCK_INDEX, uint256()));
 
+    // Entries written by older versions, their payload is moved to separate records
+    std::vector<CBlockIndex*> vUpgrade;
+
     // Load mapBlockIndex
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
@@ -343,18 +647,23 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
                 pindexNew->nStatus        = diskindex.nStatus;
                 pindexNew->nTx            = diskindex.nTx;
 
-                pindexNew->accumulatorChanges = diskindex.accumulatorChanges;
-                pindexNew->mintedPubCoins     = diskindex.mintedPubCoins;
-                pindexNew->spentSerials       = diskindex.spentSerials;
-
-                pindexNew->sigmaMintedPubCoins   = diskindex.sigmaMintedPubCoins;
-                pindexNew->sigmaSpentSerials     = diskindex.sigmaSpentSerials;
                 pindexNew->nStakeModifier = diskindex.nStakeModifier;
                 pindexNew->vchBlockSig    = diskindex.vchBlockSig; // qtum
 
                 if (pindexNew->nNonce != 0 && !CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams))
                         return error("LoadBlockIndex(): CheckProofOfWork failed: %s", pindexNew->ToString());
 
+                if (!(diskindex.nStatus & BLOCK_PRIVACY_DATA_EXTERNAL)) {
+                    pindexNew->nStatus |= BLOCK_PRIVACY_DATA_EXTERNAL;
+                    pindexNew->privacyData = diskindex.privacyData;
+                    vUpgrade.push_back(pindexNew);
+                    if (vUpgrade.size() >= 1000) {
+                        if (!WriteUpgradedBlockIndex(vUpgrade))
+                            return error("LoadBlockIndex() : failed to write upgraded block index entries");
+                        vUpgrade.clear();
+                    }
+                }
+
                 pcursor->Next();
             } else {
                 return error("LoadBlockIndex() : failed to read value");
@@ -364,6 +673,9 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
         }
     }
 
+    if (!vUpgrade.empty() && !WriteUpgradedBlockIndex(vUpgrade))
+        return error("LoadBlockIndex() : failed to write upgraded block index entries");
+
     return true;
 }
 
@@ -418,6 +730,71 @@ bool CBlockTreeDB::ReadTotalSupply(CAmount & supply)
     return false;
 }
 
+bool CBlockTreeDB::ConnectPrivacySupply(CBlock const & block, int height)
+{
+    CPrivacySupply supply;
+    Read(DB_PRIVACY_SUPPLY, supply);
+
+    if (!supply.ApplyBlock(block))
+        return true;
+
+    supply.nPrevHeight = supply.nHeight;
+    supply.nHeight = height;
+
+    CDBBatch batch(*this);
+    batch.Write(DB_PRIVACY_SUPPLY, supply);
+    batch.Write(make_pair(DB_PRIVACY_SUPPLY_HISTORY, CPrivacySupplyHeightKey(height)), supply);
+    return WriteBatch(batch);
+}
+
+bool CBlockTreeDB::DisconnectPrivacySupply(int height)
+{
+    CPrivacySupply supply;
+    if (!Read(DB_PRIVACY_SUPPLY, supply) || supply.nHeight != height)
+        return true;
+
+    CDBBatch batch(*this);
+    batch.Erase(make_pair(DB_PRIVACY_SUPPLY_HISTORY, CPrivacySupplyHeightKey(height)));
+
+    if (supply.nPrevHeight < 0) {
+        batch.Erase(DB_PRIVACY_SUPPLY);
+    } else {
+        CPrivacySupply prev;
+        if (!Read(make_pair(DB_PRIVACY_SUPPLY_HISTORY, CPrivacySupplyHeightKey(supply.nPrevHeight)), prev))
+            return error("DisconnectPrivacySupply(): missing privacy supply record at height %d", supply.nPrevHeight);
+        batch.Write(DB_PRIVACY_SUPPLY, prev);
+    }
+
+    return WriteBatch(batch);
+}
+
+bool CBlockTreeDB::ReadPrivacySupply(CPrivacySupply & supply)
+{
+    return Read(DB_PRIVACY_SUPPLY, supply);
+}
+
+bool CBlockTreeDB::ReadPrivacySupplyHistory(int start, int end, std::vector<CPrivacySupply> & history)
+{
+    boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(make_pair(DB_PRIVACY_SUPPLY_HISTORY, CPrivacySupplyHeightKey(start)));
+
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char, CPrivacySupplyHeightKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_PRIVACY_SUPPLY_HISTORY || key.second.nHeight > end)
+            break;
+
+        CPrivacySupply supply;
+        if (!pcursor->GetValue(supply))
+            return error("failed to get privacy supply value");
+        history.push_back(supply);
+        pcursor->Next();
+    }
+
+    return true;
+}
+
 /******************************************************************************/
 
 CDbIndexHelper::CDbIndexHelper(bool addressIndex_, bool spentIndex_)
@@ -457,8 +834,7 @@ std::pair<AddressType, uint160> classifyAddress(txnouttype type, vector<vector<u
 void handleInput(CTxIn const & input, size_t inputNo, uint256 const & txHash, int height, int txNumber, CCoinsViewCache const & view,
         AddressIndexPtr & addressIndex, AddressUnspentIndexPtr & addressUnspentIndex, SpentIndexPtr & spentIndex)
 {
-    const CCoins* coins = view.AccessCoins(input.prevout.hash);
-    const CTxOut &prevout = coins->vout[input.prevout.n];
+    const CTxOut &prevout = view.AccessCoin(input.prevout).out;
 
     txnouttype type;
     vector<vector<unsigned char> > addresses;
@@ -10,14 +10,20 @@
 #include "dbwrapper.h"
 #include "chain.h"
 #include "spentindex.h"
+#include "privacysupply.h"
+#include "sync.h"
 
+#include <list>
 #include <map>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <boost/function.hpp>
 
+class CBlock;
 class CBlockIndex;
 class CCoinsViewDBCursor;
 class uint256;
@@ -36,6 +42,8 @@ static const int64_t nMaxBlockDBCache = 2;
 static const int64_t nMaxBlockDBAndTxIndexCache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
+//! Number of block zerocoin/sigma payloads kept in memory
+static const size_t nMaxBlockPrivacyDataCache = 5000;
 
 struct CDiskTxPos : public CDiskBlockPos
 {
@@ -70,11 +78,14 @@ protected:
 public:
     CCoinsViewDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
 
-    bool GetCoins(const uint256 &txid, CCoins &coins) const;
-    bool HaveCoins(const uint256 &txid) const;
+    bool GetCoin(const COutPoint &outpoint, Coin &coin) const;
+    bool HaveCoin(const COutPoint &outpoint) const;
     uint256 GetBestBlock() const;
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock);
     CCoinsViewCursor *Cursor() const;
+
+    //! Convert per-transaction records of older versions to per-output ones. Returns false on error or shutdown.
+    bool Upgrade();
 };
 
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
@@ -83,8 +94,8 @@ class CCoinsViewDBCursor: public CCoinsViewCursor
 public:
     ~CCoinsViewDBCursor() {}
 
-    bool GetKey(uint256 &key) const;
-    bool GetValue(CCoins &coins) const;
+    bool GetKey(COutPoint &key) const;
+    bool GetValue(Coin &coin) const;
     unsigned int GetValueSize() const;
 
     bool Valid() const;
@@ -94,19 +105,51 @@ private:
     CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256 &hashBlockIn):
         CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn) {}
     boost::scoped_ptr<CDBIterator> pcursor;
-    std::pair<char, uint256> keyTmp;
+    std::pair<char, COutPoint> keyTmp;
 
     friend class CCoinsViewDB;
 };
 
+/** Block tree database key of a block zerocoin/sigma payload, big endian height keeps the records in chain order. */
+struct CBlockPrivacyDataKey
+{
+    int nHeight;
+    uint256 hash;
+
+    CBlockPrivacyDataKey() : nHeight(0) {}
+    explicit CBlockPrivacyDataKey(const CBlockIndex& index) : nHeight(index.nHeight), hash(index.GetBlockHash()) {}
+
+    size_t GetSerializeSize(int nType, int nVersion) const {
+        return 4 + 32;
+    }
+    template<typename Stream>
+    void Serialize(Stream& s, int nType, int nVersion) const {
+        ser_writedata32be(s, nHeight);
+        hash.Serialize(s, nType, nVersion);
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s, int nType, int nVersion) {
+        nHeight = ser_readdata32be(s);
+        hash.Unserialize(s, nType, nVersion);
+    }
+};
+
 /** Access to the block database (blocks/index/) */
-class CBlockTreeDB : public CDBWrapper
+class CBlockTreeDB : public CDBWrapper, public CBlockIndexPrivacyDataStore
 {
 public:
     CBlockTreeDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+    ~CBlockTreeDB();
 private:
     CBlockTreeDB(const CBlockTreeDB&);
     void operator=(const CBlockTreeDB&);
+
+    //! Hashes of the blocks with the payload in memory, least recently used first
+    CCriticalSection cs_privacyData;
+    std::list<uint256> listPrivacyData;
+    std::unordered_map<uint256, std::list<uint256>::iterator, SaltedTxidHasher> mapPrivacyData;
+
+    bool WriteUpgradedBlockIndex(const std::vector<CBlockIndex*>& vBlocks);
 public:
     bool WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*> >& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo);
     bool ReadBlockFileInfo(int nFile, CBlockFileInfo &fileinfo);
@@ -124,7 +167,10 @@ public:
     bool EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> > &vect);
     bool ReadAddressIndex(uint160 addressHash, AddressType type,
                           std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
-                          int start = 0, int end = 0);
+                          int start = 0, int end = 0, size_t limit = 0);
+    bool ConnectAddressBalanceIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> > &vect, int height);
+    bool DisconnectAddressBalanceIndex(int height);
+    bool ReadAddressBalanceIndex(uint160 addressHash, AddressType type, CAddressBalanceValue &value);
 
     bool WriteTimestampIndex(const CTimestampIndexKey &timestampIndex);
     bool ReadTimestampIndex(const unsigned int &high, const unsigned int &low, std::vector<uint256> &vect);
@@ -135,6 +181,16 @@ public:
     int GetBlockIndexVersion(uint256 const & blockHash);
     bool AddTotalSupply(CAmount const & supply);
     bool ReadTotalSupply(CAmount & supply);
+    bool ConnectPrivacySupply(CBlock const & block, int height);
+    bool DisconnectPrivacySupply(int height);
+    bool ReadPrivacySupply(CPrivacySupply & supply);
+    bool ReadPrivacySupplyHistory(int start, int end, std::vector<CPrivacySupply> & history);
+
+    void LoadPrivacyData(const CBlockIndex& index, CBlockIndexPrivacyData& data);
+    void TouchPrivacyData(const CBlockIndex& index);
+    //! Release the least recently used payloads until at most nMaxEntries are left in memory.
+    //! Payloads of the blocks in setPinned are not written yet and are kept
+    void TrimPrivacyData(size_t nMaxEntries, const std::set<CBlockIndex*>& setPinned);
 };
 
 
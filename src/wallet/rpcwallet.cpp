@@ -2011,7 +2011,8 @@ UniValue keypoolrefill(const UniValue& params, bool fHelp)
 
 static void LockWallet(CWallet* pWallet)
 {
-    LOCK(cs_nWalletUnlockTime);
+    // Lock() takes cs_wallet, which has to come before cs_nWalletUnlockTime as in walletlock
+    LOCK2(pWallet->cs_wallet, cs_nWalletUnlockTime);
     nWalletUnlockTime = 0;
     pWallet->Lock();
 }
@@ -2747,23 +2748,34 @@ UniValue regeneratemintpool(const UniValue &params, bool fHelp) {
     vector<std::pair<uint256, MintPoolEntry>> listMintPool = walletdb.ListMintPool();
     std::vector<std::pair<uint256, GroupElement>> serialPubcoinPairs = walletdb.ListSerialPubcoinPairs();
 
+    std::vector<MintPoolEntry> entries;
+    entries.reserve(listMintPool.size());
+    for (auto& mintPoolPair : listMintPool)
+        entries.push_back(mintPoolPair.second);
+
     // <hashPubcoin, hashSerial>
-    std::pair<uint256,uint256> nIndexes;
+    std::vector<std::pair<uint256,uint256>> vIndexes = zwalletMain->RegenerateMintPoolEntries(entries);
+
+    // <hashPubcoin, hashSerial> of the pubcoins stored in the DB
+    std::map<uint256, uint256> mapSerialByPubcoin;
+    for (const auto& serialPubcoinPair : serialPubcoinPairs)
+        mapSerialByPubcoin[primitives::GetPubCoinValueHash(serialPubcoinPair.second)] = serialPubcoinPair.first;
 
     uint256 oldHashSerial;
     uint256 oldHashPubcoin;
 
     bool reindexRequired = false;
 
-    for (auto& mintPoolPair : listMintPool){
+    for (size_t i = 0; i < listMintPool.size(); i++){
+        const auto& mintPoolPair = listMintPool[i];
+        const auto& nIndexes = vIndexes[i];
         LogPrintf("regeneratemintpool: hashPubcoin: %d hashSeedMaster: %d seedId: %d nCount: %s\n",
             mintPoolPair.first.GetHex(), get<0>(mintPoolPair.second).GetHex(), get<1>(mintPoolPair.second).GetHex(), get<2>(mintPoolPair.second));
 
         oldHashPubcoin = mintPoolPair.first;
-        bool hasSerial = zwalletMain->GetSerialForPubcoin(serialPubcoinPairs, oldHashPubcoin, oldHashSerial);
-
-        MintPoolEntry entry = mintPoolPair.second;
-        nIndexes = zwalletMain->RegenerateMintPoolEntry(get<0>(entry),get<1>(entry),get<2>(entry));
+        auto itSerial = mapSerialByPubcoin.find(oldHashPubcoin);
+        bool hasSerial = itSerial != mapSerialByPubcoin.end();
+        oldHashSerial = hasSerial ? itSerial->second : uint256();
 
         if(nIndexes.first != oldHashPubcoin){
             walletdb.EraseMintPoolPair(oldHashPubcoin);
@@ -3403,7 +3415,7 @@ UniValue spendmany(const UniValue& params, bool fHelp) {
 
     EnsureSigmaWalletIsAvailable();
 
-    LOCK2(cs_main, pwalletMain->cs_wallet);
+    // No LOCK2 here, SpendSigma takes the locks it needs and releases them while the spend proofs are created
 
     // Only account "" have sigma coins.
     std::string strAccount = AccountFromValue(params[0]);
@@ -1,4 +1,5 @@
 #include "sigmaspendbuilder.h"
+#include "walletdb.h"
 #include "walletexcept.h"
 
 #include "../primitives/transaction.h"
@@ -14,7 +15,9 @@
 #include "../version.h"
 #include "../sigma.h"
 #include "../hdmint/wallet.h"
+#include "../libzerocoin/ParallelTasks.h"
 
+#include <exception>
 #include <stdexcept>
 #include <tuple>
 
@@ -57,6 +60,74 @@ public:
     }
 };
 
+// Keeps what a spend has taken from the wallet while the builder doesn't hold cs_wallet. The selected coins are left
+// out of coin selection and the indexes of the change mints are written to the wallet database, so that other spends
+// and mints, which start from the count in the database, don't take them. Both have to be created and destroyed with
+// the builder's locks held
+class SigmaSpendReservation
+{
+public:
+    SigmaSpendReservation(CWallet& wallet, CHDMintWallet& mintWallet, const std::vector<CSigmaEntry>& coins) :
+        wallet(wallet),
+        nCountBefore(0),
+        nCountReserved(mintWallet.GetCount())
+    {
+        for (auto& coin : coins) {
+            COutPoint outPoint;
+            if (sigma::GetOutPoint(outPoint, sigma::PublicCoin(coin.value, coin.get_denomination())) &&
+                wallet.setPendingSigmaSpends.insert(outPoint).second) {
+                outPoints.push_back(outPoint);
+            }
+        }
+
+        CWalletDB walletdb(wallet.strWalletFile);
+        if (!walletdb.ReadMintCount(nCountBefore) || nCountBefore < nCountReserved) {
+            walletdb.WriteMintCount(nCountReserved);
+        }
+    }
+
+    ~SigmaSpendReservation()
+    {
+        for (auto& outPoint : outPoints) {
+            wallet.setPendingSigmaSpends.erase(outPoint);
+        }
+
+        // Give the indexes back unless something was minted after them meanwhile, the spend either gets committed
+        // under the builder's locks, which writes the count again, or is dropped and shouldn't leave a gap
+        CWalletDB walletdb(wallet.strWalletFile);
+        int32_t nCount;
+        if (nCountBefore < nCountReserved && walletdb.ReadMintCount(nCount) && nCount == nCountReserved) {
+            walletdb.WriteMintCount(nCountBefore);
+        }
+    }
+
+private:
+    CWallet& wallet;
+    std::vector<COutPoint> outPoints;
+    int32_t nCountBefore;
+    int32_t nCountReserved;
+};
+
+// Releases the locks taken by SigmaSpendBuilder for its lifetime and takes them back on destruction
+class SigmaSpendUnlock
+{
+public:
+    explicit SigmaSpendUnlock(CWallet& wallet) : wallet(wallet)
+    {
+        wallet.cs_wallet.unlock();
+        cs_main.unlock();
+    }
+
+    ~SigmaSpendUnlock()
+    {
+        cs_main.lock();
+        wallet.cs_wallet.lock();
+    }
+
+private:
+    CWallet& wallet;
+};
+
 static std::unique_ptr<SigmaSpendSigner> CreateSigner(const CSigmaEntry& coin)
 {
     sigma::CSigmaState* state = sigma::CSigmaState::GetState();
@@ -160,6 +231,63 @@ CAmount SigmaSpendBuilder::GetInputs(std::vector<std::unique_ptr<InputSigner>>&
     return total;
 }
 
+std::vector<CScript> SigmaSpendBuilder::SignInputs(const CMutableTransaction& tx, const uint256& sig, const std::vector<std::unique_ptr<InputSigner>>& signers, bool fDummy)
+{
+    std::vector<CScript> scripts(signers.size());
+    std::vector<std::exception_ptr> errors(signers.size());
+
+    {
+        // Signers hold copies of the anonymity sets, so the chain and the wallet are left unlocked while the
+        // proofs are created. Otherwise block connection and every RPC call would wait for them. The reservation
+        // outlives the unlock, so it's given back with the locks held again
+        std::unique_ptr<SigmaSpendReservation> reservation;
+        if (!fDummy) {
+            reservation.reset(new SigmaSpendReservation(wallet, mintWallet, selected));
+        }
+        SigmaSpendUnlock unlock(wallet);
+
+        libzerocoin::ParallelTasks tasks(signers.size());
+        for (size_t i = 0; i < signers.size(); i++) {
+            tasks.Add([&tx, &sig, &signers, &scripts, &errors, fDummy, i] {
+                try {
+                    scripts[i] = signers[i]->Sign(tx, sig, fDummy);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        tasks.Wait();
+    }
+
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    if (fDummy) {
+        return scripts;
+    }
+
+    // The chain could have changed in the meantime, make sure the proofs are still good
+    sigma::CSigmaState* state = sigma::CSigmaState::GetState();
+
+    for (auto& signer : signers) {
+        auto sigmaSigner = static_cast<SigmaSpendSigner*>(signer.get());
+
+        auto it = mapBlockIndex.find(sigmaSigner->lastBlockOfGroup);
+        if (it == mapBlockIndex.end() || !chainActive.Contains(it->second)) {
+            throw std::runtime_error(_("The anonymity set of one of the coins has been reorganized, try again"));
+        }
+
+        if (!state->CanAddSpendToMempool(sigmaSigner->coin.getSerialNumber())) {
+            throw std::runtime_error(_("One of the coins has been spent in the meantime"));
+        }
+    }
+
+    return scripts;
+}
+
 CAmount SigmaSpendBuilder::GetChanges(std::vector<CTxOut>& outputs, CAmount amount, bool fDummy)
 {
     outputs.clear();
@@ -22,6 +22,9 @@ protected:
     CAmount GetInputs(std::vector<std::unique_ptr<InputSigner>>& signers, CAmount required, bool fDummy) override;
     // remint change
     CAmount GetChanges(std::vector<CTxOut>& outputs, CAmount amount, bool fDummy) override;
+    // spend proofs of the inputs are independent, create them on the thread pool and without holding the locks, with
+    // the coins and change indexes reserved, then check the chain state they were created against is still current
+    std::vector<CScript> SignInputs(const CMutableTransaction& tx, const uint256& sig, const std::vector<std::unique_ptr<InputSigner>>& signers, bool fDummy) override;
 
 private:
     CHDMintWallet& mintWallet;
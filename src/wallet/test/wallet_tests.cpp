@@ -351,4 +351,37 @@ BOOST_AUTO_TEST_CASE(ApproximateBestSubset)
     BOOST_CHECK_EQUAL(setCoinsRet.size(), 2U);
 }*/
 
+BOOST_AUTO_TEST_CASE(tx_change_log)
+{
+    CWallet changeLogWallet;
+    LOCK(changeLogWallet.cs_wallet);
+
+    uint256 hash1 = uint256S("01"), hash2 = uint256S("02");
+    std::vector<std::pair<uint64_t, uint256> > changes;
+
+    changeLogWallet.ListTxChangesSince(0, 10, changes);
+    BOOST_CHECK(changes.empty());
+
+    changeLogWallet.MarkTxChanged(hash1);
+    changeLogWallet.MarkTxChanged(hash2);
+    changeLogWallet.MarkTxChanged(hash1);
+
+    // A transaction is listed once, at its last change
+    changeLogWallet.ListTxChangesSince(0, 10, changes);
+    BOOST_CHECK_EQUAL(changes.size(), 2U);
+    BOOST_CHECK(changes[0] == std::make_pair(uint64_t(2), hash2));
+    BOOST_CHECK(changes[1] == std::make_pair(uint64_t(3), hash1));
+
+    changeLogWallet.ListTxChangesSince(0, 1, changes);
+    BOOST_CHECK_EQUAL(changes.size(), 1U);
+    BOOST_CHECK(changes[0].second == hash2);
+
+    changeLogWallet.ListTxChangesSince(2, 10, changes);
+    BOOST_CHECK_EQUAL(changes.size(), 1U);
+    BOOST_CHECK(changes[0].second == hash1);
+
+    changeLogWallet.ListTxChangesSince(3, 10, changes);
+    BOOST_CHECK(changes.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -213,8 +213,10 @@ CWalletTx TxBuilder::Build(const std::vector<CRecipient>& recipients, CAmount& f
         // now every fields is populated then we can sign transaction
         uint256 sig = tx.GetHash();
 
+        std::vector<CScript> scripts = SignInputs(tx, sig, signers, fDummy);
+
         for (size_t i = 0; i < tx.vin.size(); i++) {
-            tx.vin[i].scriptSig = signers[i]->Sign(tx, sig, fDummy);
+            tx.vin[i].scriptSig = std::move(scripts[i]);
         }
 
         // check fee
@@ -265,3 +267,15 @@ CAmount TxBuilder::AdjustFee(CAmount needed, unsigned txSize)
 {
     return needed;
 }
+
+std::vector<CScript> TxBuilder::SignInputs(const CMutableTransaction& tx, const uint256& sig, const std::vector<std::unique_ptr<InputSigner>>& signers, bool fDummy)
+{
+    std::vector<CScript> scripts;
+    scripts.reserve(signers.size());
+
+    for (auto& signer : signers) {
+        scripts.push_back(signer->Sign(tx, sig, fDummy));
+    }
+
+    return scripts;
+}
@@ -43,6 +43,8 @@ protected:
     virtual CAmount GetInputs(std::vector<std::unique_ptr<InputSigner>>& signers, CAmount required, bool fDummy = false) = 0;
     virtual CAmount GetChanges(std::vector<CTxOut>& outputs, CAmount amount, bool fDummy = false) = 0;
     virtual CAmount AdjustFee(CAmount needed, unsigned txSize);
+    // signature scripts of all the inputs, in the order of signers
+    virtual std::vector<CScript> SignInputs(const CMutableTransaction& tx, const uint256& sig, const std::vector<std::unique_ptr<InputSigner>>& signers, bool fDummy);
 };
 
 #endif
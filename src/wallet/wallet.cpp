@@ -416,6 +416,17 @@ bool CWallet::Unlock(const SecureString &strWalletPassphrase, const bool& fFirst
     return false;
 }
 
+bool CWallet::Lock() {
+    if (!CCryptoKeyStore::Lock())
+        return false;
+
+    if (zwalletMain) {
+        LOCK(cs_wallet);
+        zwalletMain->GetTracker().ClearMintEntries();
+    }
+    return true;
+}
+
 bool CWallet::ChangeWalletPassphrase(const SecureString &strOldWalletPassphrase,
                                      const SecureString &strNewWalletPassphrase) {
     bool fWasLocked = IsLocked();
@@ -1203,6 +1214,7 @@ bool CWallet::AddToWallet(const CWalletTx &wtxIn, bool fFromLoadWallet, CWalletD
 //        if (!wtx.IsZerocoinSpend()) {
         wtxOrdered.insert(make_pair(wtx.nOrderPos, TxPair(&wtx, (CAccountingEntry *) 0)));
         AddToSpends(hash);
+        MarkTxChanged(hash);
 //            BOOST_FOREACH(const CTxIn &txin, wtx.vin) {
 //                LogPrintf("txin.prevout.hash=%s\n", txin.prevout.hash.ToString());
 //                if (mapWallet.count(txin.prevout.hash)) {
@@ -1297,6 +1309,7 @@ bool CWallet::AddToWallet(const CWalletTx &wtxIn, bool fFromLoadWallet, CWalletD
 
         // Break debit/credit balance caches:
         wtx.MarkDirty();
+        MarkTxChanged(hash);
 
         // Notify UI of new or updated transaction
         NotifyTransactionChanged(this, hash, fInsertedNew ? CT_NEW : CT_UPDATED);
@@ -1411,6 +1424,7 @@ bool CWallet::AbandonTransaction(const uint256 &hashTx) {
             wtx.setAbandoned();
             wtx.MarkDirty();
             walletdb.WriteTx(wtx);
+            MarkTxChanged(wtx.GetHash());
             NotifyTransactionChanged(this, wtx.GetHash(), CT_UPDATED);
             // Iterate over all its outputs, and mark transactions in the wallet that spend them abandoned too
             TxSpends::const_iterator iter = mapTxSpends.lower_bound(COutPoint(hashTx, 0));
@@ -2788,12 +2802,13 @@ std::list<CSigmaEntry> CWallet::GetAvailableCoins(const CCoinControl *coinContro
     }
 
     std::set<COutPoint> lockedCoins = setLockedCoins;
+    std::set<COutPoint> pendingSpends = setPendingSigmaSpends;
 
     // Filter out coins which are not confirmed, I.E. do not have at least 6 blocks
     // above them, after they were minted.
-    // Also filter out used coins.
+    // Also filter out used coins and coins another spend is creating its proofs for.
     // Finally filter out coins that have not been selected from CoinControl should that be used
-    coins.remove_if([lockedCoins, coinControl, includeUnsafe](const CSigmaEntry& coin) {
+    coins.remove_if([lockedCoins, pendingSpends, coinControl, includeUnsafe](const CSigmaEntry& coin) {
         sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
         if (coin.IsUsed)
             return true;
@@ -2837,6 +2852,10 @@ std::list<CSigmaEntry> CWallet::GetAvailableCoins(const CCoinControl *coinContro
             return true;
         }
 
+        if(pendingSpends.count(outPoint) > 0){
+            return true;
+        }
+
         if(coinControl != NULL){
             if(coinControl->HasSelected()){
                 if(!coinControl->IsSelected(outPoint)){
@@ -4497,6 +4516,7 @@ bool CWallet::CommitTransaction(CWalletTx &wtxNew, CReserveKey &reservekey) {
             {
                 CWalletTx &coin = mapWallet[txin.prevout.hash];
                 coin.BindWallet(this);
+                MarkTxChanged(coin.GetHash());
                 NotifyTransactionChanged(this, coin.GetHash(), CT_UPDATED);
             }
 
@@ -4529,12 +4549,34 @@ bool CWallet::EraseFromWallet(uint256 hash) {
         return false;
     {
         LOCK(cs_wallet);
-        if (mapWallet.erase(hash))
+        if (mapWallet.erase(hash)) {
             CWalletDB(strWalletFile).EraseTx(hash);
+            MarkTxChanged(hash);
+        }
     }
     return true;
 }
 
+void CWallet::MarkTxChanged(const uint256& hash) {
+    AssertLockHeld(cs_wallet);
+    std::map<uint256, uint64_t>::iterator it = mapTxSequenceByHash.find(hash);
+    if (it != mapTxSequenceByHash.end()) {
+        mapTxSequence.erase(it->second);
+        it->second = ++nTxSequence;
+    } else {
+        mapTxSequenceByHash.insert(std::make_pair(hash, ++nTxSequence));
+    }
+    mapTxSequence.insert(std::make_pair(nTxSequence, hash));
+}
+
+void CWallet::ListTxChangesSince(uint64_t nSequence, size_t nMax, std::vector<std::pair<uint64_t, uint256> >& vChanges) const {
+    AssertLockHeld(cs_wallet);
+    vChanges.clear();
+    for (std::map<uint64_t, uint256>::const_iterator it = mapTxSequence.upper_bound(nSequence);
+            it != mapTxSequence.end() && vChanges.size() < nMax; ++it)
+        vChanges.push_back(*it);
+}
+
 bool CWallet::CreateZerocoinMintModel(
         string &stringError,
         const std::vector<std::pair<std::string,int>>& denominationPairs,
@@ -6232,10 +6274,8 @@ bool CWallet::CreateSigmaSpendTransaction(
             nFeeRet = nFeeNeeded;
             txNew.vout[0].nValue -= nFeeRet;
 
-            CMutableTransaction txTemp(txNew);
-            txTemp.vin[0].scriptSig.clear();
             // We use incomplete transaction hash as metadata.
-            sigma::SpendMetaData metaDataNew(serializedId, blockHash, txTemp.GetHash());
+            sigma::SpendMetaData metaDataNew(serializedId, blockHash, sigma::GetSigmaSpendTxHash(txNew));
             spend.updateMetaData(privateCoin, metaDataNew);
             // Serialize the CoinSpend object into a buffer.
             CDataStream serializedCoinSpendNew(SER_NETWORK, PROTOCOL_VERSION);
@@ -6276,6 +6316,23 @@ bool CWallet::CreateSigmaSpendTransaction(
     return true;
 }
 
+static void EnsureSigmaSpendAvailable(const CWallet& wallet, bool fDummy)
+{
+    int nHeight;
+    {
+        LOCK(cs_main);
+        nHeight = chainActive.Height();
+    }
+    if(nHeight >= ::Params().GetConsensus().nDisableUnpaddedSigmaBlock && nHeight < ::Params().GetConsensus().nSigmaPaddingBlock)
+        throw std::runtime_error(_("Sigma is disabled at this period."));
+    // sanity check
+    EnsureMintWalletAvailable();
+
+    if (!fDummy && wallet.IsLocked()) {
+        throw std::runtime_error(_("Wallet locked"));
+    }
+}
+
 CWalletTx CWallet::CreateSigmaSpendTransaction(
     const std::vector<CRecipient>& recipients,
     CAmount& fee,
@@ -6285,17 +6342,9 @@ CWalletTx CWallet::CreateSigmaSpendTransaction(
     const CCoinControl *coinControl,
     bool fDummy)
 {
-    int nHeight = chainActive.Height();
-    if(nHeight >= ::Params().GetConsensus().nDisableUnpaddedSigmaBlock && nHeight < ::Params().GetConsensus().nSigmaPaddingBlock)
-        throw std::runtime_error(_("Sigma is disabled at this period."));
-    // sanity check
-    EnsureMintWalletAvailable();
+    EnsureSigmaSpendAvailable(*this, fDummy);
 
-    if (!fDummy && IsLocked()) {
-        throw std::runtime_error(_("Wallet locked"));
-    }
-
-    // create transaction
+    // create transaction, the builder holds cs_main and cs_wallet except while the proofs are being created
     SigmaSpendBuilder builder(*this, *zwalletMain, coinControl);
 
     CWalletTx tx = builder.Build(recipients, fee, fChangeAddedToFee, fDummy);
@@ -6944,16 +6993,11 @@ bool CWallet::CreateMultipleSigmaSpendTransaction(
             nFeeRet = nFeeNeeded;
             txNew.vout[0].nValue -= nFeeRet;
 
-            CMutableTransaction txTempNew(txNew);
-            BOOST_FOREACH(CTxIn &txTempIn, txTempNew.vin) {
-                if (txTempIn.scriptSig.IsSigmaSpend()) {
-                    txTempIn.scriptSig.clear();
-                }
-            }
+            // We use incomplete transaction hash as metadata.
+            uint256 txHashForMetadataNew = sigma::GetSigmaSpendTxHash(txNew);
 
             for(int i = 0; i < txNew.vin.size(); i++){
-                // We use incomplete transaction hash as metadata.
-                sigma::SpendMetaData metaDataNew(tempStorages[i].serializedId, tempStorages[i].blockHash, txTempNew.GetHash());
+                sigma::SpendMetaData metaDataNew(tempStorages[i].serializedId, tempStorages[i].blockHash, txHashForMetadataNew);
                 spends[i].updateMetaData(tempStorages[i].privateCoin, metaDataNew);
                 // Serialize the CoinSpend object into a buffer.
                 CDataStream serializedCoinSpendNew(SER_NETWORK, PROTOCOL_VERSION);
@@ -7661,20 +7705,25 @@ std::vector<CSigmaEntry> CWallet::SpendSigma(
     CWalletTx& result,
     CAmount& fee)
 {
-    // create transaction
-    std::vector<CSigmaEntry> coins;
-    std::vector<CHDMint> changes;
+    EnsureSigmaSpendAvailable(*this, false);
+
+    // create and commit the transaction with the builder alive, it holds cs_main and cs_wallet except while the
+    // proofs are created, so nothing can take its coins or change indexes between creating and committing
+    SigmaSpendBuilder builder(*this, *zwalletMain);
+
     bool fChangeAddedToFee;
-    result = CreateSigmaSpendTransaction(recipients, fee, coins, changes, fChangeAddedToFee);
+    result = builder.Build(recipients, fee, fChangeAddedToFee);
 
-    CommitSigmaTransaction(result, coins, changes);
+    CommitSigmaTransaction(result, builder.selected, builder.changes);
 
-    return coins;
+    return builder.selected;
 }
 
 bool CWallet::CommitSigmaTransaction(CWalletTx& wtxNew, std::vector<CSigmaEntry>& selectedCoins, std::vector<CHDMint>& changes) {
     EnsureMintWalletAvailable();
 
+    LOCK2(cs_main, cs_wallet);
+
     // commit
     try {
         CommitTransaction(wtxNew);
@@ -7764,8 +7813,12 @@ bool CWallet::GetMint(const uint256& hashSerial, CSigmaEntry& zerocoin) const
         return false;
     }
 
+    CHDMintTracker& tracker = zwalletMain->GetTracker();
+    if (tracker.GetMintEntry(hashSerial, zerocoin))
+        return true;
+
     CMintMeta meta;
-    if(!zwalletMain->GetTracker().GetMetaFromSerial(hashSerial, meta))
+    if(!tracker.GetMetaFromSerial(hashSerial, meta))
         return error("%s: serialhash %s is not in tracker", __func__, hashSerial.GetHex());
 
     CWalletDB walletdb(strWalletFile);
@@ -7775,13 +7828,12 @@ bool CWallet::GetMint(const uint256& hashSerial, CSigmaEntry& zerocoin) const
             return error("%s: failed to read deterministic mint", __func__);
         if (!zwalletMain->RegenerateMint(dMint, zerocoin))
             return error("%s: failed to generate mint", __func__);
-
-         return true;
     } else if (!walletdb.ReadSigmaEntry(meta.GetPubCoinValue(), zerocoin)) {
         return error("%s: failed to read zerocoinmint from database", __func__);
     }
 
-     return true;
+    tracker.CacheMintEntry(hashSerial, zerocoin);
+    return true;
 }
 
 bool CWallet::AddAccountingEntry(const CAccountingEntry &acentry, CWalletDB &pwalletdb) {
@@ -8272,10 +8324,12 @@ void CWallet::DisableTransaction(const CTransaction &tx)
         {
             CWalletTx &coin = mapWallet[txin.prevout.hash];
             coin.BindWallet(this);
+            MarkTxChanged(coin.GetHash());
             NotifyTransactionChanged(this, coin.GetHash(), CT_UPDATED);
         }
         CWalletTx& wtx = mapWallet[hash];
         wtx.BindWallet(this);
+        MarkTxChanged(hash);
         NotifyTransactionChanged(this, hash, CT_DELETED);
     }
 }
@@ -8333,8 +8387,10 @@ void CWallet::UpdatedTransaction(const uint256 &hashTx) {
         LOCK(cs_wallet);
         // Only notify UI if this transaction is in this wallet
         map<uint256, CWalletTx>::const_iterator mi = mapWallet.find(hashTx);
-        if (mi != mapWallet.end())
+        if (mi != mapWallet.end()) {
+            MarkTxChanged(hashTx);
             NotifyTransactionChanged(this, hashTx, CT_UPDATED);
+        }
     }
 }
 
@@ -19,6 +19,7 @@
 #include "wallet/walletdb.h"
 #include "wallet/rpcwallet.h"
 #include "pos.h"
+#include "random.h"
 #include "wallet/mnemoniccontainer.h"
 #include "../base58.h"
 #include "zerocoin_params.h"
@@ -31,6 +32,7 @@
 
 
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <set>
 #include <stdexcept>
@@ -740,6 +742,10 @@ public:
         nMasterKeyMaxID = 0;
         pwalletdbEncryption = NULL;
         nOrderPosNext = 0;
+        nTxSequence = 0;
+        nTxSequenceEpoch = GetRand(std::numeric_limits<uint64_t>::max());
+        mapTxSequence.clear();
+        mapTxSequenceByHash.clear();
         nNextResend = 0;
         nLastResend = 0;
         nTimeFirstKey = 0;
@@ -760,12 +766,30 @@ public:
     int64_t nOrderPosNext;
     std::map<uint256, int> mapRequestCount;
 
+    /**
+     * Memory only change log of the wallet transactions. Every change to a transaction gives it the
+     * next sequence number, so the transactions changed since a given point are a range of
+     * mapTxSequence. Transactions removed from mapWallet stay in the log to report the removal.
+     * The epoch changes with every start, sequence numbers of an earlier run are meaningless.
+     */
+    uint64_t nTxSequence;
+    uint64_t nTxSequenceEpoch;
+    std::map<uint64_t, uint256> mapTxSequence;
+    std::map<uint256, uint64_t> mapTxSequenceByHash;
+
+    void MarkTxChanged(const uint256& hash);
+    //! Hashes of at most nMax transactions changed after nSequence, in the order of their last change
+    void ListTxChangesSince(uint64_t nSequence, size_t nMax, std::vector<std::pair<uint64_t, uint256> >& vChanges) const;
+
     std::map<CTxDestination, CAddressBookData> mapAddressBook;
 
     CPubKey vchDefaultKey;
 
     std::set<COutPoint> setLockedCoins;
 
+    //! Sigma coins selected by spends that are creating their proofs without cs_wallet, left out of coin selection
+    std::set<COutPoint> setPendingSigmaSpends;
+
     int64_t nTimeFirstKey;
 
     const CWalletTx* GetWalletTx(const uint256& hash) const;
@@ -846,6 +870,8 @@ public:
     bool LoadWatchOnly(const CScript &dest);
 
     bool Unlock(const SecureString& strWalletPassphrase, const bool& fFirstUnlock=false);
+    //! Locks the wallet and drops the decrypted sigma mints from memory
+    bool Lock();
     bool ChangeWalletPassphrase(const SecureString& strOldWalletPassphrase, const SecureString& strNewWalletPassphrase);
     bool EncryptWallet(const SecureString& strWalletPassphrase);
 
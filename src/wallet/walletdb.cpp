@@ -984,7 +984,11 @@ DBErrors CWalletDB::ZapSelectTx(CWallet *pwallet, vector <uint256> &vTxHashIn, v
         if (it == vTxHashIn.end()) {
             break;
         } else if ((*it) == hash) {
-            pwallet->mapWallet.erase(hash);
+            {
+                LOCK(pwallet->cs_wallet);
+                pwallet->mapWallet.erase(hash);
+                pwallet->MarkTxChanged(hash);
+            }
             if (!EraseTx(hash)) {
                 LogPrint("db", "Transaction was found for deletion but returned database error: %s\n", hash.GetHex());
                 delerror = true;
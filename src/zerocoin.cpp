@@ -11,8 +11,10 @@
 #include "shroudnode-payments.h"
 #include "shroudnode-sync.h"
 #include "sigma/remint.h"
+#include "libzerocoin/ParallelTasks.h"
 
 #include <atomic>
+#include <exception>
 #include <sstream>
 #include <chrono>
 
@@ -215,6 +217,159 @@ bool CheckRemintZcoinTransaction(const CTransaction &tx,
     return true;
 }
 
+namespace {
+
+/**
+ * Accumulator values a zerocoin spend can have been made against, latest first. The block index is read here and
+ * only here, so candidates have to be taken on the thread that holds cs_main
+ */
+class ZerocoinAccumulatorCandidates {
+public:
+    ZerocoinAccumulatorCandidates(const libzerocoin::CoinSpend &spend,
+                                  const CZerocoinState::CoinGroupInfo &coinGroup,
+                                  pair<int,int> denominationAndId,
+                                  bool fAlternativeAccumulators)
+        : coinGroup(coinGroup), denominationAndId(denominationAndId), index(coinGroup.lastBlock), spendHasBlockHash(false) {
+        // Zerocoin v1.5/v2 transaction can cointain block hash of the last mint tx seen at the moment of spend. It
+        // speeds up verification
+        if (spend.getVersion() > ZEROCOIN_TX_VERSION_1 && !spend.getAccumulatorBlockHash().IsNull()) {
+            spendHasBlockHash = true;
+            uint256 accumulatorBlockHash = spend.getAccumulatorBlockHash();
+
+            // find index for block with hash of accumulatorBlockHash or set index to the coinGroup.firstBlock if not found
+            while (index != coinGroup.firstBlock && index->GetBlockHash() != accumulatorBlockHash)
+                index = index->pprev;
+        }
+
+        accChanges = !fAlternativeAccumulators ?
+                    &CBlockIndexPrivacyData::accumulatorChanges : &CBlockIndexPrivacyData::alternativeAccumulatorChanges;
+    }
+
+    /** The next accumulator value of the coin group going back in the chain, false if there are no more */
+    bool Next(CBigNum &value) {
+        while (index) {
+            const auto& blockAccChanges = index->GetPrivacyData().*accChanges;
+            auto accChange = blockAccChanges.find(denominationAndId);
+
+            // if spend has block hash we don't need to look further
+            if (index == coinGroup.firstBlock || spendHasBlockHash)
+                index = NULL;
+            else
+                index = index->pprev;
+
+            if (accChange != blockAccChanges.end()) {
+                value = accChange->second.first;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Coins minted in the coin group sorted by the time of mint */
+    vector<CBigNum> GetMintedPubCoins() const {
+        vector<CBigNum> pubCoins;
+        for (CBlockIndex *block = coinGroup.lastBlock; ; block = block->pprev) {
+            const auto& blockMints = block->GetPrivacyData().mintedPubCoins;
+            auto mints = blockMints.find(denominationAndId);
+            if (mints != blockMints.end())
+                pubCoins.insert(pubCoins.begin(), mints->second.cbegin(), mints->second.cend());
+            if (block == coinGroup.firstBlock)
+                break;
+        }
+        return pubCoins;
+    }
+
+private:
+    CZerocoinState::CoinGroupInfo coinGroup;
+    pair<int,int> denominationAndId;
+    decltype(&CBlockIndexPrivacyData::accumulatorChanges) accChanges;
+    CBlockIndex *index;
+    bool spendHasBlockHash;
+};
+
+/** A zerocoin spend input waiting for its proofs to be verified */
+struct ZerocoinSpendVerification {
+    std::unique_ptr<libzerocoin::CoinSpend> spend;
+    libzerocoin::SpendMetaData metaData;
+    const libzerocoin::Params *zcParams;
+    libzerocoin::CoinDenomination denomination;
+    ZerocoinAccumulatorCandidates candidates;
+
+    //! The latest accumulator value of the coin group, taken before the proofs go to the thread pool
+    bool fHasAccumulator;
+    CBigNum accumulatorValue;
+
+    ZerocoinSpendVerification(std::unique_ptr<libzerocoin::CoinSpend> spend,
+                              const libzerocoin::SpendMetaData &metaData,
+                              const libzerocoin::Params *zcParams,
+                              libzerocoin::CoinDenomination denomination,
+                              const ZerocoinAccumulatorCandidates &candidates)
+        : spend(std::move(spend)), metaData(metaData), zcParams(zcParams), denomination(denomination),
+          candidates(candidates) {
+        fHasAccumulator = this->candidates.Next(accumulatorValue);
+    }
+
+    /**
+     * Verifies the proofs that don't involve the accumulator and the accumulator proof against the latest accumulator
+     * value, which in most cases is the one the spend was made against. Only reads the data copied into this object so
+     * it can run on any thread
+     */
+    void VerifyLatest(bool &fProofsValid, bool &fAccumulatorValid) const {
+        fAccumulatorValid = false;
+        fProofsValid = spend->VerifyWithoutAccumulator(metaData);
+        if (!fProofsValid || !fHasAccumulator)
+            return;
+
+        libzerocoin::Accumulator accumulator(zcParams, accumulatorValue, denomination);
+        LogPrintf("CheckSpendZcoinTransaction: accumulator=%s\n", accumulator.getValue().ToString().substr(0,15));
+        fAccumulatorValid = spend->VerifyAccumulator(accumulator);
+    }
+
+    /** Tries the accumulator proof against the older accumulator values of the coin group. Reads the block index */
+    bool VerifyOlder() {
+        bool passVerify = false;
+
+        // Enumerate all the accumulator changes seen in the blockchain going back from the latest one
+        CBigNum value;
+        while (!passVerify && candidates.Next(value)) {
+            libzerocoin::Accumulator accumulator(zcParams, value, denomination);
+            LogPrintf("CheckSpendZcoinTransaction: accumulator=%s\n", accumulator.getValue().ToString().substr(0,15));
+            passVerify = spend->VerifyAccumulator(accumulator);
+        }
+
+        // Rare case: accumulator value contains some but NOT ALL coins from one block. In this case we will
+        // have to enumerate over coins manually. No optimization is really needed here because it's a rarity
+        // This can't happen if spend is of version 1.5 or 2.0
+        if (!passVerify && spend->getVersion() == ZEROCOIN_TX_VERSION_1) {
+            vector<CBigNum> pubCoins = candidates.GetMintedPubCoins();
+
+            libzerocoin::Accumulator accumulator(zcParams, denomination);
+            BOOST_FOREACH(const CBigNum &pubCoin, pubCoins) {
+                accumulator += libzerocoin::PublicCoin(zcParams, pubCoin, denomination);
+                LogPrintf("CheckSpendZcoinTransaction: accumulator=%s\n", accumulator.getValue().ToString().substr(0,15));
+                if ((passVerify = spend->VerifyAccumulator(accumulator)) == true)
+                    break;
+            }
+
+            if (!passVerify) {
+                // One more time now in reverse direction. The only reason why it's required is compatibility with
+                // previous client versions
+                libzerocoin::Accumulator accumulator(zcParams, denomination);
+                BOOST_REVERSE_FOREACH(const CBigNum &pubCoin, pubCoins) {
+                    accumulator += libzerocoin::PublicCoin(zcParams, pubCoin, denomination);
+                    LogPrintf("CheckSpendZcoinTransaction: accumulatorRev=%s\n", accumulator.getValue().ToString().substr(0,15));
+                    if ((passVerify = spend->VerifyAccumulator(accumulator)) == true)
+                        break;
+                }
+            }
+        }
+
+        return passVerify;
+    }
+};
+
+} // namespace
+
 bool CheckSpendZcoinTransaction(const CTransaction &tx,
                                 const Consensus::Params &params,
                                 const vector<libzerocoin::CoinDenomination>& targetDenominations,
@@ -231,6 +386,7 @@ bool CheckSpendZcoinTransaction(const CTransaction &tx,
     int vinIndex = -1;
 
     set<CBigNum> serialsUsedInThisTx;
+    vector<ZerocoinSpendVerification> spendVerifications;
 
     for (const CTxIn &txin : tx.vin) {
         std::unique_ptr<libzerocoin::CoinSpend> spend;
@@ -367,84 +523,37 @@ bool CheckSpendZcoinTransaction(const CTransaction &tx,
         if (!zerocoinState.GetCoinGroupInfo(targetDenominations[vinIndex], pubcoinId, coinGroup))
             return state.DoS(100, false, NO_MINT_ZEROCOIN, "CheckSpendZcoinTransaction: Error: no coins were minted with such parameters");
 
-        bool passVerify = false;
-        CBlockIndex *index = coinGroup.lastBlock;
-
+        // The proofs of all the inputs are verified together below
         pair<int,int> denominationAndId = make_pair(targetDenominations[vinIndex], pubcoinId);
+        ZerocoinAccumulatorCandidates candidates(*spend, coinGroup, denominationAndId, fModulusV2 != fModulusV2InIndex);
+        spendVerifications.emplace_back(std::move(spend), newMetadata, zcParams, targetDenominations[vinIndex], candidates);
+    }
 
-        bool spendHasBlockHash = false;
-
-        // Zerocoin v1.5/v2 transaction can cointain block hash of the last mint tx seen at the moment of spend. It speeds
-        // up verification
-        if (spendVersion > ZEROCOIN_TX_VERSION_1 && !spend->getAccumulatorBlockHash().IsNull()) {
-			spendHasBlockHash = true;
-			uint256 accumulatorBlockHash = spend->getAccumulatorBlockHash();
-
-			// find index for block with hash of accumulatorBlockHash or set index to the coinGroup.firstBlock if not found
-			while (index != coinGroup.firstBlock && index->GetBlockHash() != accumulatorBlockHash)
-				index = index->pprev;
-		}
-
-        decltype(&CBlockIndex::accumulatorChanges) accChanges = fModulusV2 == fModulusV2InIndex ?
-                    &CBlockIndex::accumulatorChanges : &CBlockIndex::alternativeAccumulatorChanges;
-
-        // Enumerate all the accumulator changes seen in the blockchain starting with the latest block
-        // In most cases the latest accumulator value will be used for verification
-        do {
-            if ((index->*accChanges).count(denominationAndId) > 0) {
-                libzerocoin::Accumulator accumulator(zcParams,
-                                                     (index->*accChanges)[denominationAndId].first,
-                                                     targetDenominations[vinIndex]);
-                LogPrintf("CheckSpendZcoinTransaction: accumulator=%s\n", accumulator.getValue().ToString().substr(0,15));
-                passVerify = spend->Verify(accumulator, newMetadata);
-            }
-
-            // if spend has block hash we don't need to look further
-            if (index == coinGroup.firstBlock || spendHasBlockHash)
-                break;
-            else
-                index = index->pprev;
-        } while (!passVerify);
-
-        // Rare case: accumulator value contains some but NOT ALL coins from one block. In this case we will
-        // have to enumerate over coins manually. No optimization is really needed here because it's a rarity
-        // This can't happen if spend is of version 1.5 or 2.0
-        if (!passVerify && spendVersion == ZEROCOIN_TX_VERSION_1) {
-            // Build vector of coins sorted by the time of mint
-            index = coinGroup.lastBlock;
-            vector<CBigNum> pubCoins = index->mintedPubCoins[denominationAndId];
-            if (index != coinGroup.firstBlock) {
-                do {
-                    index = index->pprev;
-                    if (index->mintedPubCoins.count(denominationAndId) > 0)
-                        pubCoins.insert(pubCoins.begin(),
-                                        index->mintedPubCoins[denominationAndId].cbegin(),
-                                        index->mintedPubCoins[denominationAndId].cend());
-                } while (index != coinGroup.firstBlock);
-            }
-
-            libzerocoin::Accumulator accumulator(zcParams, targetDenominations[vinIndex]);
-            BOOST_FOREACH(const CBigNum &pubCoin, pubCoins) {
-                accumulator += libzerocoin::PublicCoin(zcParams, pubCoin, (libzerocoin::CoinDenomination)targetDenominations[vinIndex]);
-                LogPrintf("CheckSpendZcoinTransaction: accumulator=%s\n", accumulator.getValue().ToString().substr(0,15));
-                if ((passVerify = spend->Verify(accumulator, newMetadata)) == true)
-                    break;
-            }
-
-            if (!passVerify) {
-                // One more time now in reverse direction. The only reason why it's required is compatibility with
-                // previous client versions
-                libzerocoin::Accumulator accumulator(zcParams, targetDenominations[vinIndex]);
-                BOOST_REVERSE_FOREACH(const CBigNum &pubCoin, pubCoins) {
-                    accumulator += libzerocoin::PublicCoin(zcParams, pubCoin, (libzerocoin::CoinDenomination)targetDenominations[vinIndex]);
-                    LogPrintf("CheckSpendZcoinTransaction: accumulatorRev=%s\n", accumulator.getValue().ToString().substr(0,15));
-                    if ((passVerify = spend->Verify(accumulator, newMetadata)) == true)
-                        break;
-                }
+    // Inputs don't depend on each other, verify their proofs at the same time against the latest accumulator values.
+    // The tasks only get the data taken above, the block index is never touched outside of this thread
+    vector<char> spendProofsValid(spendVerifications.size(), false);
+    vector<char> spendAccumulatorValid(spendVerifications.size(), false);
+    vector<std::exception_ptr> spendErrors(spendVerifications.size());
+    libzerocoin::ParallelTasks verifications(spendVerifications.size());
+    for (size_t i = 0; i < spendVerifications.size(); i++) {
+        verifications.Add([&spendVerifications, &spendProofsValid, &spendAccumulatorValid, &spendErrors, i] {
+            try {
+                bool fProofsValid, fAccumulatorValid;
+                spendVerifications[i].VerifyLatest(fProofsValid, fAccumulatorValid);
+                spendProofsValid[i] = fProofsValid;
+                spendAccumulatorValid[i] = fAccumulatorValid;
+            } catch (...) {
+                spendErrors[i] = std::current_exception();
             }
-        }
+        });
+    }
+    verifications.Wait();
 
-        if (!passVerify) {
+    for (size_t i = 0; i < spendVerifications.size(); i++) {
+        if (spendErrors[i])
+            std::rethrow_exception(spendErrors[i]);
+        // Spends made against an older accumulator value are searched for here, one by one
+        if (!spendProofsValid[i] || (!spendAccumulatorValid[i] && !spendVerifications[i].VerifyOlder())) {
             LogPrintf("CheckSpendZCoinTransaction: verification failed at block %d\n", nHeight);
             return false;
         }
@@ -715,10 +824,11 @@ bool ConnectBlockZC(CValidationState &state, const CChainParams &chainParams, CB
 
 	    if (!fJustCheck) {
             // clear the state
-			pindexNew->spentSerials.clear();
-            pindexNew->mintedPubCoins.clear();
-            pindexNew->accumulatorChanges.clear();
-            pindexNew->alternativeAccumulatorChanges.clear();
+            CBlockIndexPrivacyData& data = pindexNew->PrivacyData();
+			data.spentSerials.clear();
+            data.mintedPubCoins.clear();
+            data.accumulatorChanges.clear();
+            data.alternativeAccumulatorChanges.clear();
         }
 
         if (pindexNew->nHeight > chainParams.GetConsensus().nCheckBugFixedAtBlock) {
@@ -727,7 +837,7 @@ bool ConnectBlockZC(CValidationState &state, const CChainParams &chainParams, CB
                     return false;
 
                 if (!fJustCheck) {
-                    pindexNew->spentSerials.insert(serial.first);
+                    pindexNew->PrivacyData().spentSerials.insert(serial.first);
                     zerocoinState.AddSpend(serial.first);
                 }
 
@@ -752,7 +862,8 @@ bool ConnectBlockZC(CValidationState &state, const CChainParams &chainParams, CB
             LogPrintf("ConnectTipZC: mint added denomination=%d, id=%d\n", denomination, mintId);
             pair<int,int> denomAndId = make_pair(denomination, mintId);
 
-            pindexNew->mintedPubCoins[denomAndId].push_back(mint.second);
+            CBlockIndexPrivacyData& data = pindexNew->PrivacyData();
+            data.mintedPubCoins[denomAndId].push_back(mint.second);
 
             CZerocoinState::CoinGroupInfo coinGroupInfo;
             zerocoinState.GetCoinGroupInfo(denomination, mintId, coinGroupInfo);
@@ -763,16 +874,16 @@ bool ConnectBlockZC(CValidationState &state, const CChainParams &chainParams, CB
                                                  (libzerocoin::CoinDenomination)denomination);
             accumulator += pubCoin;
 
-            if (pindexNew->accumulatorChanges.count(denomAndId) > 0) {
-                pair<CBigNum,int> &accChange = pindexNew->accumulatorChanges[denomAndId];
+            if (data.accumulatorChanges.count(denomAndId) > 0) {
+                pair<CBigNum,int> &accChange = data.accumulatorChanges[denomAndId];
                 accChange.first = accumulator.getValue();
                 accChange.second++;
             }
             else {
-                pindexNew->accumulatorChanges[denomAndId] = make_pair(accumulator.getValue(), 1);
+                data.accumulatorChanges[denomAndId] = make_pair(accumulator.getValue(), 1);
             }
             // invalidate alternative accumulator value for this denomination and id
-            pindexNew->alternativeAccumulatorChanges.erase(denomAndId);
+            data.alternativeAccumulatorChanges.erase(denomAndId);
         }
     }
     else if (!fJustCheck) {
@@ -867,7 +978,10 @@ int CZerocoinState::AddMint(CBlockIndex *index, int denomination, const CBigNum
             coinGroup.firstBlock = coinGroup.lastBlock = index;
         }
         else {
-            previousAccValue = coinGroup.lastBlock->accumulatorChanges[make_pair(denomination,mintId)].first;
+            const auto& accChanges = coinGroup.lastBlock->GetPrivacyData().accumulatorChanges;
+            auto accChange = accChanges.find(make_pair(denomination,mintId));
+            if (accChange != accChanges.end())
+                previousAccValue = accChange->second.first;
             coinGroup.lastBlock = index;
         }
     }
@@ -892,7 +1006,8 @@ void CZerocoinState::AddSpend(const CBigNum &serial) {
 }
 
 void CZerocoinState::AddBlock(CBlockIndex *index, const Consensus::Params &params) {
-    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int), PAIRTYPE(CBigNum,int)) &accUpdate, index->accumulatorChanges)
+    const CBlockIndexPrivacyData& data = index->GetPrivacyData();
+    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int), PAIRTYPE(CBigNum,int)) &accUpdate, data.accumulatorChanges)
     {
         CoinGroupInfo   &coinGroup = coinGroups[accUpdate.first];
 
@@ -902,7 +1017,7 @@ void CZerocoinState::AddBlock(CBlockIndex *index, const Consensus::Params &param
         coinGroup.nCoins += accUpdate.second.second;
     }
 
-    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int),vector<CBigNum>) &pubCoins, index->mintedPubCoins) {
+    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int),vector<CBigNum>) &pubCoins, data.mintedPubCoins) {
         latestCoinIds[pubCoins.first.first] = pubCoins.first.second;
         BOOST_FOREACH(const CBigNum &coin, pubCoins.second) {
             CMintedCoinInfo coinInfo;
@@ -914,15 +1029,16 @@ void CZerocoinState::AddBlock(CBlockIndex *index, const Consensus::Params &param
     }
 
     if (index->nHeight > params.nCheckBugFixedAtBlock) {
-        BOOST_FOREACH(const CBigNum &serial, index->spentSerials) {
+        BOOST_FOREACH(const CBigNum &serial, data.spentSerials) {
             usedCoinSerials.insert(serial);
         }
     }
 }
 
 void CZerocoinState::RemoveBlock(CBlockIndex *index) {
+    const CBlockIndexPrivacyData& data = index->GetPrivacyData();
     // roll back accumulator updates
-    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int), PAIRTYPE(CBigNum,int)) &accUpdate, index->accumulatorChanges)
+    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int), PAIRTYPE(CBigNum,int)) &accUpdate, data.accumulatorChanges)
     {
         CoinGroupInfo   &coinGroup = coinGroups[accUpdate.first];
         int  nMintsToForget = accUpdate.second.second;
@@ -940,12 +1056,12 @@ void CZerocoinState::RemoveBlock(CBlockIndex *index) {
             do {
                 assert(coinGroup.lastBlock != coinGroup.firstBlock);
                 coinGroup.lastBlock = coinGroup.lastBlock->pprev;
-            } while (coinGroup.lastBlock->accumulatorChanges.count(accUpdate.first) == 0);
+            } while (coinGroup.lastBlock->GetPrivacyData().accumulatorChanges.count(accUpdate.first) == 0);
         }
     }
 
     // roll back mints
-    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int),vector<CBigNum>) &pubCoins, index->mintedPubCoins) {
+    BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int),vector<CBigNum>) &pubCoins, data.mintedPubCoins) {
         BOOST_FOREACH(const CBigNum &coin, pubCoins.second) {
             auto coins = mintedPubCoins.equal_range(coin);
             auto coinIt = find_if(coins.first, coins.second, [=](const decltype(mintedPubCoins)::value_type &v) {
@@ -958,7 +1074,7 @@ void CZerocoinState::RemoveBlock(CBlockIndex *index) {
     }
 
     // roll back spends
-    BOOST_FOREACH(const CBigNum &serial, index->spentSerials) {
+    BOOST_FOREACH(const CBigNum &serial, data.spentSerials) {
         usedCoinSerials.erase(serial);
     }
 }
@@ -991,33 +1107,34 @@ int CZerocoinState::GetAccumulatorValueForSpend(CChain *chain, int maxHeight, in
     CoinGroupInfo coinGroup = coinGroups[denomAndId];
     CBlockIndex *lastBlock = coinGroup.lastBlock;
 
-    assert(lastBlock->accumulatorChanges.count(denomAndId) > 0);
-    assert(coinGroup.firstBlock->accumulatorChanges.count(denomAndId) > 0);
+    assert(lastBlock->GetPrivacyData().accumulatorChanges.count(denomAndId) > 0);
+    assert(coinGroup.firstBlock->GetPrivacyData().accumulatorChanges.count(denomAndId) > 0);
 
     // is native modulus for denomination and id v2?
     bool nativeModulusIsV2 = IsZerocoinTxV2((libzerocoin::CoinDenomination)denomination, Params().GetConsensus(), id);
     // field in the block index structure for accesing accumulator changes
-    decltype(&CBlockIndex::accumulatorChanges) accChangeField;
+    decltype(&CBlockIndexPrivacyData::accumulatorChanges) accChangeField;
     if (nativeModulusIsV2 != useModulusV2) {
         CalculateAlternativeModulusAccumulatorValues(chain, denomination, id);
-        accChangeField = &CBlockIndex::alternativeAccumulatorChanges;
+        accChangeField = &CBlockIndexPrivacyData::alternativeAccumulatorChanges;
     }
     else {
-        accChangeField = &CBlockIndex::accumulatorChanges;
+        accChangeField = &CBlockIndexPrivacyData::accumulatorChanges;
     }
 
     int numberOfCoins = 0;
     for (;;) {
-        map<pair<int,int>, pair<CBigNum,int>> &accumulatorChanges = lastBlock->*accChangeField;
-        if (accumulatorChanges.count(denomAndId) > 0) {
+        const map<pair<int,int>, pair<CBigNum,int>> &accumulatorChanges = lastBlock->GetPrivacyData().*accChangeField;
+        auto accChange = accumulatorChanges.find(denomAndId);
+        if (accChange != accumulatorChanges.end()) {
             if (lastBlock->nHeight <= maxHeight) {
                 if (numberOfCoins == 0) {
                     // latest block satisfying given conditions
                     // remember accumulator value and block hash
-                    accumulator = accumulatorChanges[denomAndId].first;
+                    accumulator = accChange->second.first;
                     blockHash = lastBlock->GetBlockHash();
                 }
-                numberOfCoins += accumulatorChanges[denomAndId].second;
+                numberOfCoins += accChange->second.second;
             }
         }
 
@@ -1047,13 +1164,13 @@ libzerocoin::AccumulatorWitness CZerocoinState::GetWitnessForSpend(CChain *chain
 
     libzerocoin::Params *zcParams = useModulusV2 ? ZCParamsV2 : ZCParams;
     bool nativeModulusIsV2 = IsZerocoinTxV2((libzerocoin::CoinDenomination)denomination, Params().GetConsensus(), id);
-    decltype(&CBlockIndex::accumulatorChanges) accChangeField;
+    decltype(&CBlockIndexPrivacyData::accumulatorChanges) accChangeField;
     if (nativeModulusIsV2 != useModulusV2) {
         CalculateAlternativeModulusAccumulatorValues(chain, denomination, id);
-        accChangeField = &CBlockIndex::alternativeAccumulatorChanges;
+        accChangeField = &CBlockIndexPrivacyData::alternativeAccumulatorChanges;
     }
     else {
-        accChangeField = &CBlockIndex::accumulatorChanges;
+        accChangeField = &CBlockIndexPrivacyData::accumulatorChanges;
     }
 
     // Find accumulator value preceding mint operation
@@ -1063,16 +1180,17 @@ libzerocoin::AccumulatorWitness CZerocoinState::GetWitnessForSpend(CChain *chain
     if (block != coinGroup.firstBlock) {
         do {
             block = block->pprev;
-        } while ((block->*accChangeField).count(denomAndId) == 0);
-        accumulator = libzerocoin::Accumulator(zcParams, (block->*accChangeField)[denomAndId].first, d);
+        } while ((block->GetPrivacyData().*accChangeField).count(denomAndId) == 0);
+        accumulator = libzerocoin::Accumulator(zcParams, (block->GetPrivacyData().*accChangeField).at(denomAndId).first, d);
     }
 
     // Now add to the accumulator every coin minted since that moment except pubCoin
     block = coinGroup.lastBlock;
     for (;;) {
-        if (block->nHeight <= maxHeight && block->mintedPubCoins.count(denomAndId) > 0) {
-            vector<CBigNum> &pubCoins = block->mintedPubCoins[denomAndId];
-            for (const CBigNum &coin: pubCoins) {
+        const auto& blockMints = block->GetPrivacyData().mintedPubCoins;
+        auto mints = blockMints.find(denomAndId);
+        if (block->nHeight <= maxHeight && mints != blockMints.end()) {
+            for (const CBigNum &coin: mints->second) {
                 if (block != mintBlock || coin != pubCoin)
                     accumulator += libzerocoin::PublicCoin(zcParams, coin, d);
             }
@@ -1114,18 +1232,20 @@ void CZerocoinState::CalculateAlternativeModulusAccumulatorValues(CChain *chain,
 
     CBlockIndex *block = coinGroup.firstBlock;
     for (;;) {
-        if (block->accumulatorChanges.count(denomAndId) > 0) {
-            if (block->alternativeAccumulatorChanges.count(denomAndId) > 0)
+        if (block->GetPrivacyData().accumulatorChanges.count(denomAndId) > 0) {
+            // alternative values are not stored, they are calculated again once the payload is released
+            CBlockIndexPrivacyData& data = block->PrivacyData();
+            if (data.alternativeAccumulatorChanges.count(denomAndId) > 0)
                 // already calculated, update accumulator with cached value
-                accumulator = libzerocoin::Accumulator(altParams, block->alternativeAccumulatorChanges[denomAndId].first, d);
+                accumulator = libzerocoin::Accumulator(altParams, data.alternativeAccumulatorChanges[denomAndId].first, d);
             else {
                 // re-create accumulator changes with alternative params
-                assert(block->mintedPubCoins.count(denomAndId) > 0);
-                const vector<CBigNum> &mintedCoins = block->mintedPubCoins[denomAndId];
+                assert(data.mintedPubCoins.count(denomAndId) > 0);
+                const vector<CBigNum> &mintedCoins = data.mintedPubCoins[denomAndId];
                 BOOST_FOREACH(const CBigNum &c, mintedCoins) {
                     accumulator += libzerocoin::PublicCoin(altParams, c, d);
                 }
-                block->alternativeAccumulatorChanges[denomAndId] = make_pair(accumulator.getValue(), (int)mintedCoins.size());
+                data.alternativeAccumulatorChanges[denomAndId] = make_pair(accumulator.getValue(), (int)mintedCoins.size());
             }
         }
 
@@ -1147,22 +1267,23 @@ bool CZerocoinState::TestValidity(CChain *chain) {
 
         CBlockIndex *block = coinGroup.second.firstBlock;
         for (;;) {
-            if (block->accumulatorChanges.count(coinGroup.first) > 0) {
-                if (block->mintedPubCoins.count(coinGroup.first) == 0) {
+            const CBlockIndexPrivacyData& data = block->GetPrivacyData();
+            if (data.accumulatorChanges.count(coinGroup.first) > 0) {
+                if (data.mintedPubCoins.count(coinGroup.first) == 0) {
                     fprintf(stderr, "  no minted coins\n");
                     return false;
                 }
 
-                BOOST_FOREACH(const CBigNum &pubCoin, block->mintedPubCoins[coinGroup.first]) {
+                BOOST_FOREACH(const CBigNum &pubCoin, data.mintedPubCoins.at(coinGroup.first)) {
                     acc += libzerocoin::PublicCoin(zcParams, pubCoin, (libzerocoin::CoinDenomination)coinGroup.first.first);
                 }
 
-                if (acc.getValue() != block->accumulatorChanges[coinGroup.first].first) {
+                if (acc.getValue() != data.accumulatorChanges.at(coinGroup.first).first) {
                     fprintf (stderr, "  accumulator value mismatch at height %d\n", block->nHeight);
                     return false;
                 }
 
-                if (block->accumulatorChanges[coinGroup.first].second != (int)block->mintedPubCoins[coinGroup.first].size()) {
+                if (data.accumulatorChanges.at(coinGroup.first).second != (int)data.mintedPubCoins.at(coinGroup.first).size()) {
                     fprintf(stderr, "  number of minted coins mismatch at height %d\n", block->nHeight);
                     return false;
                 }
@@ -1193,14 +1314,15 @@ set<CBlockIndex *> CZerocoinState::RecalculateAccumulators(CChain *chain) {
         // Try to calculate accumulator for the first batch of mints. If it doesn't match we need to recalculate the rest of it
         CBlockIndex *block = coinGroup.second.firstBlock;
         for (;;) {
-            if (block->accumulatorChanges.count(coinGroup.first) > 0) {
-                BOOST_FOREACH(const CBigNum &pubCoin, block->mintedPubCoins[coinGroup.first]) {
+            if (block->GetPrivacyData().accumulatorChanges.count(coinGroup.first) > 0) {
+                CBlockIndexPrivacyData& data = block->PrivacyData();
+                BOOST_FOREACH(const CBigNum &pubCoin, data.mintedPubCoins[coinGroup.first]) {
                     acc += libzerocoin::PublicCoin(ZCParamsV2, pubCoin, (libzerocoin::CoinDenomination)coinGroup.first.first);
                 }
 
                 // First block case is special: do the check
                 if (block == coinGroup.second.firstBlock) {
-                    if (acc.getValue() != block->accumulatorChanges[coinGroup.first].first)
+                    if (acc.getValue() != data.accumulatorChanges[coinGroup.first].first)
                         // recalculation is needed
                         LogPrintf("ZerocoinState: accumulator recalculation for denomination=%d, id=%d\n", coinGroup.first.first, coinGroup.first.second);
                     else
@@ -1208,7 +1330,7 @@ set<CBlockIndex *> CZerocoinState::RecalculateAccumulators(CChain *chain) {
                         break;
                 }
 
-                block->accumulatorChanges[coinGroup.first] = make_pair(acc.getValue(), (int)block->mintedPubCoins[coinGroup.first].size());
+                data.accumulatorChanges[coinGroup.first] = make_pair(acc.getValue(), (int)data.mintedPubCoins[coinGroup.first].size());
                 changes.insert(block);
             }
 
@@ -22,6 +22,11 @@ bool CZMQAbstract::NotifyBlock(const CBlockIndex * /*CBlockIndex*/)
     return true;
 }
 
+bool CZMQAbstract::NotifyConnectedBlock(const CBlockIndex * /*CBlockIndex*/, const std::vector<uint256>& /*vTxHashes*/)
+{
+    return true;
+}
+
 bool CZMQAbstract::NotifyTransaction(const CTransaction &/*transaction*/)
 {
     return true;
@@ -67,6 +72,15 @@ bool CZMQAbstract::NotifyBalance()
     return true;
 }
 
+void CZMQAbstract::BeginBurst()
+{
+}
+
+bool CZMQAbstract::EndBurst()
+{
+    return true;
+}
+
 bool CZMQAbstract::SendMultipart(const void* data, size_t size, ...)
 {
     va_list args;
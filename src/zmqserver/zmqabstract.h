@@ -54,6 +54,7 @@ public:
 
     /* virtual functions to be implemented by publisher (defined here to allow access by notifiers) */ 
     virtual bool NotifyBlock(const CBlockIndex *pindex);
+    virtual bool NotifyConnectedBlock(const CBlockIndex *pindex, const std::vector<uint256>& vTxHashes);
     virtual bool NotifyTransaction(const CTransaction &transaction);
     virtual bool NotifyConnections();
     virtual bool NotifyStatus();
@@ -64,6 +65,10 @@ public:
     virtual bool NotifySettingsUpdate(std::string update);
     virtual bool NotifyBalance();
 
+    /* notifications between the two calls are published together */
+    virtual void BeginBurst();
+    virtual bool EndBurst();
+
     /* send message with or without topic value. */
     bool SendMessage();
 
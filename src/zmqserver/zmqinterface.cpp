@@ -109,10 +109,27 @@ CZMQReplierInterface* CZMQReplierInterface::Create()
 }
 
 
-CZMQPublisherInterface::CZMQPublisherInterface()
+CZMQPublisherEvent::CZMQPublisherEvent(Type typeIn) :
+    type(typeIn), nTime(GetTimeMicros()), pindex(NULL)
 {
 }
 
+static CZMQPublisherInterface* pactivePublisherInterface = NULL;
+
+bool GetZMQPublisherStats(CZMQPublisherStats& stats)
+{
+    if (!pactivePublisherInterface)
+        return false;
+    pactivePublisherInterface->GetStats(stats);
+    return true;
+}
+
+CZMQPublisherInterface::CZMQPublisherInterface() :
+    nPendingFlags(0), nPendingTime(0), pindexPendingTip(NULL), fStopPublisher(false), publisher(NULL)
+{
+    worker = NULL;
+}
+
 bool CZMQPublisherInterface::StartWorker()
 {
     // Create worker
@@ -122,6 +139,7 @@ bool CZMQPublisherInterface::StartWorker()
 
 CZMQPublisherInterface::~CZMQPublisherInterface()
 {
+    StopPublisher();
     Shutdown();
 
     for (std::list<CZMQAbstract*>::iterator i=notifiers.begin(); i!=notifiers.end(); ++i)
@@ -130,7 +148,169 @@ CZMQPublisherInterface::~CZMQPublisherInterface()
     }
 
     //destroy worker
-    worker->interrupt();
+    if (worker)
+        worker->interrupt();
+}
+
+void CZMQPublisherInterface::StopPublisher()
+{
+    if (!publisher)
+        return;
+
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        fStopPublisher = true;
+    }
+    condPublisher.notify_one();
+    publisher->join();
+    delete publisher;
+    publisher = NULL;
+
+    if (pactivePublisherInterface == this)
+        pactivePublisherInterface = NULL;
+}
+
+void CZMQPublisherInterface::GetStats(CZMQPublisherStats& statsOut)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    statsOut = stats;
+    statsOut.nQueueSize = queue.size();
+}
+
+void CZMQPublisherInterface::Enqueue(CZMQPublisherEvent& event)
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        if (queue.size() >= DEFAULT_ZMQ_PUBLISHER_QUEUE_SIZE) {
+            if (stats.nDropped++ % 1000 == 0)
+                LogPrint("zmq", "zmq: publisher queue full, %u events dropped so far\n", stats.nDropped);
+            return;
+        }
+        queue.push_back(std::move(event));
+        stats.nQueued++;
+    }
+    condPublisher.notify_one();
+}
+
+void CZMQPublisherInterface::SetPending(int flag)
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        if (nPendingFlags & flag) {
+            stats.nCoalesced++;
+            return;
+        }
+        if (!nPendingFlags)
+            nPendingTime = GetTimeMicros();
+        nPendingFlags |= flag;
+        stats.nQueued++;
+    }
+    condPublisher.notify_one();
+}
+
+void CZMQPublisherInterface::ThreadPublisher()
+{
+    RenameThread("shroud-zmqpub");
+
+    while (true) {
+        std::deque<CZMQPublisherEvent> events;
+        int nFlags;
+        const CBlockIndex *pindexTip;
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            while (!fStopPublisher && queue.empty() && !nPendingFlags)
+                condPublisher.wait(lock);
+            if (fStopPublisher) {
+                if (!queue.empty() || nPendingFlags)
+                    LogPrint("zmq", "zmq: publisher stopped with %u events pending\n", queue.size());
+                return;
+            }
+
+            // Take everything which accumulated since the last run as one burst
+            events.swap(queue);
+            nFlags = nPendingFlags;
+            pindexTip = pindexPendingTip;
+            nPendingFlags = 0;
+            pindexPendingTip = NULL;
+
+            int64_t nOldest = events.empty() ? nPendingTime : events.front().nTime;
+            if (nFlags && nPendingTime < nOldest)
+                nOldest = nPendingTime;
+            stats.nLastLag = GetTimeMicros() - nOldest;
+            stats.nMaxLag = std::max(stats.nMaxLag, stats.nLastLag);
+            stats.nPublished += events.size();
+            for (int flag = nFlags; flag; flag &= flag - 1)
+                stats.nPublished++;
+        }
+
+        Publish(events, nFlags, pindexTip);
+    }
+}
+
+void CZMQPublisherInterface::Publish(const std::deque<CZMQPublisherEvent>& events, int nFlags, const CBlockIndex *pindexTip)
+{
+    for (std::list<CZMQAbstract*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
+    {
+        CZMQAbstract *notifier = *i;
+        bool fSuccess = true;
+        notifier->BeginBurst();
+        try {
+            for (std::deque<CZMQPublisherEvent>::const_iterator it = events.begin(); fSuccess && it != events.end(); ++it)
+            {
+                switch (it->type) {
+                case CZMQPublisherEvent::CONNECTED_BLOCK:
+                    fSuccess = notifier->NotifyConnectedBlock(it->pindex, it->vTxHashes);
+                    break;
+                case CZMQPublisherEvent::TRANSACTION:
+                    fSuccess = notifier->NotifyTransaction(*it->tx);
+                    break;
+                case CZMQPublisherEvent::SHROUDNODE:
+                    fSuccess = notifier->NotifyShroudnodeUpdate(*it->shroudnode);
+                    break;
+                case CZMQPublisherEvent::MINT_STATUS:
+                    fSuccess = notifier->NotifyMintStatusUpdate(it->update);
+                    break;
+                case CZMQPublisherEvent::SETTINGS:
+                    fSuccess = notifier->NotifySettingsUpdate(it->update);
+                    break;
+                }
+            }
+
+            if (fSuccess && (nFlags & PENDING_BLOCK))
+                fSuccess = notifier->NotifyBlock(pindexTip);
+            if (fSuccess && (nFlags & PENDING_CONNECTIONS))
+                fSuccess = notifier->NotifyConnections();
+            if (fSuccess && (nFlags & PENDING_STATUS))
+                fSuccess = notifier->NotifyStatus();
+            if (fSuccess && (nFlags & PENDING_API_STATUS))
+                fSuccess = notifier->NotifyAPIStatus();
+            if (fSuccess && (nFlags & PENDING_SHROUDNODE_LIST))
+                fSuccess = notifier->NotifyShroudnodeList();
+            if (fSuccess && (nFlags & PENDING_BALANCE))
+                fSuccess = notifier->NotifyBalance();
+
+            if (fSuccess)
+                fSuccess = notifier->EndBurst();
+        } catch (const UniValue& objError) {
+            LogPrint("zmq", "zmq: %s failed to publish: %s\n", notifier->GetType(), objError.write());
+            notifier->EndBurst();
+            fSuccess = true;
+        } catch (const std::exception& e) {
+            LogPrint("zmq", "zmq: %s failed to publish: %s\n", notifier->GetType(), e.what());
+            notifier->EndBurst();
+            fSuccess = true;
+        }
+
+        if (fSuccess)
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
 }
 
 CZMQPublisherInterface* CZMQPublisherInterface::Create()
@@ -185,6 +365,11 @@ CZMQPublisherInterface* CZMQPublisherInterface::Create()
         delete notificationInterface;
         notificationInterface = NULL;
     }
+    else
+    {
+        notificationInterface->publisher = new boost::thread(boost::bind(&CZMQPublisherInterface::ThreadPublisher, notificationInterface));
+        pactivePublisherInterface = notificationInterface;
+    }
 
     LogPrintf("returning notificationInterface\n");
     return notificationInterface;
@@ -192,170 +377,78 @@ CZMQPublisherInterface* CZMQPublisherInterface::Create()
 
 void CZMQPublisherInterface::UpdateSyncStatus()
 {
-    for (std::list<CZMQAbstract*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
-    {
-        CZMQAbstract *notifier = *i;
-        if (notifier->NotifyStatus())
-        {
-            i++;
-        }
-        else
-        {
-            notifier->Shutdown();
-            i = notifiers.erase(i);
-        }
-    }
+    SetPending(PENDING_STATUS);
 }
 
 void CZMQPublisherInterface::NotifyAPIStatus()
 {
-    for (std::list<CZMQAbstract*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
-    {
-        CZMQAbstract *notifier = *i;
-        if (notifier->NotifyAPIStatus())
-        {
-            i++;
-        }
-        else
-        {
-            notifier->Shutdown();
-            i = notifiers.erase(i);
-        }
-    }
+    SetPending(PENDING_API_STATUS);
 }
 
 void CZMQPublisherInterface::NotifyShroudnodeList()
 {
-    for (std::list<CZMQAbstract*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
-    {
-        CZMQAbstract *notifier = *i;
-        if (notifier->NotifyShroudnodeList())
-        {
-            i++;
-        }
-        else
-        {
-            notifier->Shutdown();
-            i = notifiers.erase(i);
-        }
-    }
+    SetPending(PENDING_SHROUDNODE_LIST);
 }
 
 void CZMQPublisherInterface::NumConnectionsChanged()
 {
-    for (std::list<CZMQAbstract*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
-    {
-        CZMQAbstract *notifier = *i;
-        if (notifier->NotifyConnections())
-        {
-            i++;
-        }
-        else
-        {
-            notifier->Shutdown();
-            i = notifiers.erase(i);
-        }
-    }
+    SetPending(PENDING_CONNECTIONS);
 }
 
 void CZMQPublisherInterface::UpdatedBlockTip(const CBlockIndex *pindex)
 {
-    for (std::list<CZMQAbstract*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
     {
-        CZMQAbstract *notifier = *i;
-        if (notifier->NotifyBlock(pindex))
-        {
-            i++;
-        }
-        else
-        {
-            notifier->Shutdown();
-            i = notifiers.erase(i);
-        }
+        // Only the latest tip is published
+        boost::unique_lock<boost::mutex> lock(mutex);
+        pindexPendingTip = pindex;
     }
+    SetPending(PENDING_BLOCK);
+}
+
+void CZMQPublisherInterface::SyncTransaction(const CTransaction &tx, const CBlockIndex *pindex, const CBlock *pblock)
+{
+    // Transactions of a connected block are signalled one by one, queue the block with the last one
+    // so the publisher doesn't have to read it back from disk.
+    if (!pblock || pblock->vtx.empty() || &tx != &pblock->vtx.back())
+        return;
+
+    CZMQPublisherEvent event(CZMQPublisherEvent::CONNECTED_BLOCK);
+    event.pindex = pindex;
+    event.vTxHashes.reserve(pblock->vtx.size());
+    BOOST_FOREACH(const CTransaction& blockTx, pblock->vtx)
+        event.vTxHashes.push_back(blockTx.GetHash());
+    Enqueue(event);
 }
 
 void CZMQPublisherInterface::WalletTransaction(const CTransaction& tx)
 {
-    for (std::list<CZMQAbstract*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
-    {
-        CZMQAbstract *notifier = *i;
-        if (notifier->NotifyTransaction(tx))
-        {
-            i++;
-        }
-        else
-        {
-            notifier->Shutdown();
-            i = notifiers.erase(i);
-        }
-    }
+    CZMQPublisherEvent event(CZMQPublisherEvent::TRANSACTION);
+    event.tx = std::make_shared<const CTransaction>(tx);
+    Enqueue(event);
 }
 
 void CZMQPublisherInterface::UpdatedShroudnode(CShroudnode &shroudnode)
 {
-    for (std::list<CZMQAbstract*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
-    {
-        CZMQAbstract *notifier = *i;
-        if (notifier->NotifyShroudnodeUpdate(shroudnode))
-        {
-            i++;
-        }
-        else
-        {
-            notifier->Shutdown();
-            i = notifiers.erase(i);
-        }
-    }
+    CZMQPublisherEvent event(CZMQPublisherEvent::SHROUDNODE);
+    event.shroudnode = std::make_shared<CShroudnode>(shroudnode);
+    Enqueue(event);
 }
 
 void CZMQPublisherInterface::UpdatedMintStatus(std::string update)
 {
-    for (std::list<CZMQAbstract*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
-    {
-        CZMQAbstract *notifier = *i;
-        if (notifier->NotifyMintStatusUpdate(update))
-        {
-            i++;
-        }
-        else
-        {
-            notifier->Shutdown();
-            i = notifiers.erase(i);
-        }
-    }
+    CZMQPublisherEvent event(CZMQPublisherEvent::MINT_STATUS);
+    event.update = update;
+    Enqueue(event);
 }
 
 void CZMQPublisherInterface::UpdatedSettings(std::string update)
 {
-    for (std::list<CZMQAbstract*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
-    {
-        CZMQAbstract *notifier = *i;
-        if (notifier->NotifySettingsUpdate(update))
-        {
-            i++;
-        }
-        else
-        {
-            notifier->Shutdown();
-            i = notifiers.erase(i);
-        }
-    }
+    CZMQPublisherEvent event(CZMQPublisherEvent::SETTINGS);
+    event.update = update;
+    Enqueue(event);
 }
 
 void CZMQPublisherInterface::UpdatedBalance()
 {
-    for (std::list<CZMQAbstract*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
-    {
-        CZMQAbstract *notifier = *i;
-        if (notifier->NotifyBalance())
-        {
-            i++;
-        }
-        else
-        {
-            notifier->Shutdown();
-            i = notifiers.erase(i);
-        }
-    }
+    SetPending(PENDING_BALANCE);
 }
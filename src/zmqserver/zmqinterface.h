@@ -6,13 +6,63 @@
 #define ZCOIN_ZMQ_ZMQNOTIFICATIONINTERFACE_H
 
 #include "validationinterface.h"
+#include "primitives/transaction.h"
+#include "shroudnode.h"
+#include <deque>
 #include <string>
 #include <map>
 #include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 class CBlockIndex;
 class CZMQAbstract;
 
+/** Number of threads serving API requests on each replier port */
+static const int DEFAULT_API_WORKERS = 4;
+static const int MAX_API_WORKERS = 64;
+
+/** Maximum number of publisher events with a payload waiting for the publisher thread */
+static const size_t DEFAULT_ZMQ_PUBLISHER_QUEUE_SIZE = 1000;
+
+/** Counters of the publisher queue, reported by the apiStatus call */
+struct CZMQPublisherStats
+{
+    uint64_t nQueued;       //!< events accepted into the queue
+    uint64_t nCoalesced;    //!< events merged into an already pending one
+    uint64_t nDropped;      //!< events dropped because the queue was full
+    uint64_t nPublished;    //!< events handed to the notifiers
+    size_t nQueueSize;      //!< events currently waiting
+    int64_t nLastLag;       //!< age of the oldest event of the last batch, in microseconds
+    int64_t nMaxLag;        //!< highest nLastLag seen
+
+    CZMQPublisherStats() : nQueued(0), nCoalesced(0), nDropped(0), nPublished(0), nQueueSize(0), nLastLag(0), nMaxLag(0) {}
+};
+
+/** Returns false if the publisher isn't running */
+bool GetZMQPublisherStats(CZMQPublisherStats& stats);
+
+/** Publisher event which carries data and can't be merged with other events of its kind */
+struct CZMQPublisherEvent
+{
+    enum Type {
+        CONNECTED_BLOCK,
+        TRANSACTION,
+        SHROUDNODE,
+        MINT_STATUS,
+        SETTINGS
+    };
+
+    Type type;
+    int64_t nTime;
+    const CBlockIndex *pindex;
+    std::vector<uint256> vTxHashes;
+    std::shared_ptr<const CTransaction> tx;
+    std::shared_ptr<CShroudnode> shroudnode;
+    std::string update;
+
+    CZMQPublisherEvent(Type typeIn);
+};
+
 class CZMQInterface
 {
 public:
@@ -25,6 +75,13 @@ protected:
 };
 
 
+/**
+ * Validation interface of the API publishers. Signals are queued and published by a dedicated
+ * thread, so building and sending the API messages doesn't hold up the validation thread.
+ *
+ * Events without data (balance, connections, status...) and block tips are kept as pending flags,
+ * several signals of the same kind between two runs of the publisher thread result in one publish.
+ */
 class CZMQPublisherInterface : public CValidationInterface, CZMQInterface
 {
 public:
@@ -33,10 +90,39 @@ public:
     virtual ~CZMQPublisherInterface();
     CZMQPublisherInterface* Create();
 
+    void GetStats(CZMQPublisherStats& stats);
+
+private:
+    enum PendingFlag {
+        PENDING_BLOCK = 1 << 0,
+        PENDING_CONNECTIONS = 1 << 1,
+        PENDING_STATUS = 1 << 2,
+        PENDING_API_STATUS = 1 << 3,
+        PENDING_SHROUDNODE_LIST = 1 << 4,
+        PENDING_BALANCE = 1 << 5
+    };
+
+    boost::mutex mutex;
+    boost::condition_variable condPublisher;
+    std::deque<CZMQPublisherEvent> queue;
+    int nPendingFlags;
+    int64_t nPendingTime;
+    const CBlockIndex *pindexPendingTip;
+    bool fStopPublisher;
+    CZMQPublisherStats stats;
+    boost::thread* publisher;
+
+    void Enqueue(CZMQPublisherEvent& event);
+    void SetPending(int flag);
+    void ThreadPublisher();
+    void Publish(const std::deque<CZMQPublisherEvent>& events, int nFlags, const CBlockIndex *pindexTip);
+    void StopPublisher();
+
 protected:
     // CValidationInterface
     void WalletTransaction(const CTransaction& tx);
     void UpdatedBlockTip(const CBlockIndex *pindex);
+    void SyncTransaction(const CTransaction &tx, const CBlockIndex *pindex, const CBlock *pblock);
     void NumConnectionsChanged();
     void UpdateSyncStatus();
     void NotifyShroudnodeList();
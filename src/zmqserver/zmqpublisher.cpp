@@ -133,7 +133,28 @@ void CZMQAbstractPublisher::Shutdown()
     }
 }
 
+void CZMQAbstractPublisher::BeginBurst(){
+    fBurst = true;
+    fBurstPending = false;
+}
+
+bool CZMQAbstractPublisher::EndBurst(){
+    fBurst = false;
+    if(!fBurstPending)
+        return true;
+    fBurstPending = false;
+    return ExecuteRequest();
+}
+
 bool CZMQAbstractPublisher::Execute(){
+    if(fBurst && IsCoalesced()){
+        fBurstPending = true;
+        return true;
+    }
+    return ExecuteRequest();
+}
+
+bool CZMQAbstractPublisher::ExecuteRequest(){
     APIJSONRequest jreq;
     try {
         jreq.parse(request);
@@ -237,21 +258,8 @@ bool CZMQTransactionEvent::NotifyTransaction(const CTransaction &transaction)
 }
 
 bool CZMQBlockEvent::NotifyBlock(const CBlockIndex *pindex){
-    // We always publish on an update to wallet tx's
+    // Published once the transactions of the block are known, see NotifyConnectedBlock
     if(topic=="address"){
-        CBlock block;
-        if(!ReadBlockFromDisk(block, pindex, Params().GetConsensus())){
-            throw JSONAPIError(API_INVALID_PARAMETER, "Invalid, missing or duplicate parameter");
-        }
-        BOOST_FOREACH(const CTransaction&tx, block.vtx)
-        {
-            const CWalletTx *wtx = pwalletMain->GetWalletTx(tx.GetHash());
-            if(wtx){
-                request.replace("data", pindex->ToJSON());
-                Execute();
-                return true;
-            }
-        }
         return true;
     }
 
@@ -264,6 +272,32 @@ bool CZMQBlockEvent::NotifyBlock(const CBlockIndex *pindex){
     return true;
 }
 
+bool CZMQBlockEvent::NotifyConnectedBlock(const CBlockIndex *pindex, const std::vector<uint256>& vTxHashes){
+    // We always publish on an update to wallet tx's
+    if(topic!="address" || !pwalletMain){
+        return true;
+    }
+
+    bool fWalletTx = false;
+    {
+        // cs_main is held while the block's transactions are added to the wallet
+        LOCK2(cs_main, pwalletMain->cs_wallet);
+        BOOST_FOREACH(const uint256& hash, vTxHashes)
+        {
+            if(pwalletMain->GetWalletTx(hash)){
+                fWalletTx = true;
+                break;
+            }
+        }
+    }
+
+    if(fWalletTx){
+        request.replace("data", pindex->ToJSON());
+        Execute();
+    }
+    return true;
+}
+
 bool CZMQShroudnodeEvent::NotifyShroudnodeUpdate(CShroudnode &shroudnode){
     request.replace("data", shroudnode.ToJSON());
     Execute();
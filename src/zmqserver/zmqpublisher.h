@@ -18,6 +18,8 @@ class CBlockIndex;
 class CZMQAbstractPublisher : public CZMQAbstract
 {
 public:
+    CZMQAbstractPublisher() : fBurst(false), fBurstPending(false) { }
+
     bool Initialize();
     void Shutdown();
 
@@ -26,13 +28,26 @@ public:
 
     virtual void SetMethod() = 0;
     virtual void SetTopic() = 0;
-    
+
+    /* Topics whose message only reflects the current state publish once per burst of events,
+       with the request data of the last event. */
+    virtual bool IsCoalesced() const { return false; }
+
+    void BeginBurst();
+    bool EndBurst();
+
 protected:
     std::string method;
     UniValue request;
     UniValue publish;
     boost::thread* worker;
 
+private:
+    bool fBurst;
+    bool fBurstPending;
+
+    bool ExecuteRequest();
+
 };
 
 /* Special Instance of the CZMQAbstractPublisher class to handle threads. */
@@ -57,6 +72,7 @@ class CZMQBlockEvent : virtual public CZMQAbstractPublisher
     */
 public:
     bool NotifyBlock(const CBlockIndex *pindex);
+    bool NotifyConnectedBlock(const CBlockIndex *pindex, const std::vector<uint256>& vTxHashes);
 };
 
 
@@ -149,6 +165,7 @@ class CZMQBlockInfoTopic : public CZMQBlockEvent,
 public:
     void SetTopic(){ topic = "block";}
     void SetMethod(){ method= "blockchain";}
+    bool IsCoalesced() const { return true; }
 };
 
 class CZMQBalanceTopic : public CZMQBlockEvent, 
@@ -159,6 +176,7 @@ class CZMQBalanceTopic : public CZMQBlockEvent,
 public:
     void SetTopic(){ topic = "balance";}
     void SetMethod(){ method= "balance";}
+    bool IsCoalesced() const { return true; }
 };
 
 class CZMQTransactionTopic : public CZMQTransactionEvent
@@ -180,6 +198,7 @@ class CZMQAPIStatusTopic : public CZMQAPIStatusEvent
 public:
     void SetTopic(){ topic = "apiStatus";}
     void SetMethod(){ method= "apiStatus";}
+    bool IsCoalesced() const { return true; }
 };
 
 class CZMQShroudnodeListTopic : public CZMQShroudnodeListEvent
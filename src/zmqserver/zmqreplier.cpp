@@ -2,132 +2,102 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 #include "zmqreplier.h"
+#include "zmqinterface.h"
 #include <boost/thread/thread.hpp>
 #include <boost/chrono.hpp>
 #include "util.h"
+#include "crypto/common.h"
 #include "univalue.h"
 #include "client-api/server.h"
 #include "client-api/protocol.h"
 
 //*********** threads waiting for responses ***********//
-void* CZMQOpenReplier::Thread()
+void CZMQAbstractReplier::Proxy()
 {
-    LogPrintf("ZMQ: IN REQREP_ZMQ_open\n");
-    while (KEEPALIVE) {
-        /* Create an empty ØMQ message to hold the message part. */
-        /* message assumed to contain an API command to be executed with data */
-        rc = zmq_msg_init (&request);
-
-        /* Block until a message is available to be received from socket */
-        if(!Wait()){
-            break;
-        }
-
-        LogPrintf("ZMQ: read open request\n");
-        std::string requestStr = ReadRequest();
-        LogPrintf("requestStr: %s\n", requestStr);
-        APIJSONRequest jreq;
-        try {
-            // Parse request
-            UniValue valRequest;
-            if (!valRequest.read(requestStr))
-                throw JSONAPIError(API_PARSE_ERROR, "Parse error");
-
-            jreq.parse(valRequest);
+    RenameThread(("shroud-api-" + type).c_str());
 
-            UniValue result = tableAPI.execute(jreq, false);
+    // Hands requests from the clients to the workers and the replies back, returns once the context is shut down
+    zmq_proxy(psocket, pbackend, NULL);
+    LogPrint("api", "ZMQ: %s proxy stopped\n", type);
+}
 
-            // Send reply
-            message = JSONAPIReply(result, NullUniValue);
-            if(!SendMessage()){
-                break;
-            }
+void CZMQAbstractReplier::Worker()
+{
+    RenameThread(("shroud-api-" + type).c_str());
 
-        } catch (const UniValue& objError) {
-            message = JSONAPIReply(NullUniValue, objError);
-            if(!SendMessage()){
-                break;
-            }
-        } catch (const std::exception& e) {
-            message = JSONAPIReply(NullUniValue, JSONAPIError(API_PARSE_ERROR, e.what()));
-            if(!SendMessage()){
-                break;
-            }
-            return NULL;
-        }
+    void *pworker = zmq_socket(pcontext, ZMQ_REP);
+    if (!pworker)
+    {
+        zmqError("Failed to create worker socket");
+        return;
+    }
+    if (zmq_connect(pworker, backendAddress.c_str()) != 0)
+    {
+        zmqError("Failed to connect worker socket");
+        zmq_close(pworker);
+        return;
     }
-    return NULL;
-}
 
-void* CZMQAuthReplier::Thread(){
-    LogPrintf("ZMQ: IN REQREP_ZMQ_auth\n");
     while (KEEPALIVE) {
-        /* Create an empty ØMQ message to hold the message part. */
         /* message assumed to contain an API command to be executed with data */
-        rc = zmq_msg_init (&request);
+        zmq_msg_t request;
+        zmq_msg_init(&request);
 
         /* Block until a message is available to be received from socket */
-        if(!Wait()){
-            break;
+        if (zmq_msg_recv(&request, pworker, 0) == -1)
+        {
+            zmq_msg_close(&request);
+            if (zmq_errno() == ETERM)
+                break;
+            continue;
         }
 
+        std::string requestStr((const char*)zmq_msg_data(&request), zmq_msg_size(&request));
+        zmq_msg_close(&request);
+        LogPrint("api", "ZMQ: %s request: %s\n", type, requestStr);
+
+        std::string reply;
         APIJSONRequest jreq;
         try {
             // Parse request
             UniValue valRequest;
-            if (!valRequest.read(ReadRequest()))
+            if (!valRequest.read(requestStr))
                 throw JSONAPIError(API_PARSE_ERROR, "Parse error");
 
             jreq.parse(valRequest);
 
-            UniValue result = tableAPI.execute(jreq, true);
-
-            // Send reply
-            message = JSONAPIReply(result, NullUniValue);
-            if(!SendMessage()){
-                break;
-            }
+            UniValue result = tableAPI.execute(jreq, IsAuthPort());
 
+            reply = JSONAPIReply(result, NullUniValue);
         } catch (const UniValue& objError) {
-            message = JSONAPIReply(NullUniValue, objError);
-            if(!SendMessage()){
-                break;
-            }
+            reply = JSONAPIReply(NullUniValue, objError);
         } catch (const std::exception& e) {
-            message = JSONAPIReply(NullUniValue, JSONAPIError(API_PARSE_ERROR, e.what()));
-            if(!SendMessage()){
-                break;
-            }
-            return NULL;
+            reply = JSONAPIReply(NullUniValue, JSONAPIError(API_PARSE_ERROR, e.what()));
         }
-    }
-    return NULL;
-}
 
-// 'Wait' thread. hangs waiting for REQ
-bool CZMQAbstractReplier::Wait(){
-
-    if(rc==-1) return false;
-    /* Block until a message is available to be received from socket */
-    do {
-        rc = zmq_recvmsg (psocket, &request, ZMQ_DONTWAIT);
-        if ((EAGAIN != errno && rc==0) || !KEEPALIVE){
+        // Send reply
+        if (!SendReply(pworker, reply))
+        {
+            if (KEEPALIVE)
+                zmqError("Unable to send API reply");
             break;
         }
-        boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
-    } while(rc==-1);
-
-    if (!KEEPALIVE) return false;
+    }
 
-    return true;
+    int linger = 0;
+    zmq_setsockopt(pworker, ZMQ_LINGER, &linger, sizeof(linger));
+    zmq_close(pworker);
 }
 
-std::string CZMQAbstractReplier::ReadRequest(){
-    char* requestChars = (char*) malloc (rc + 1);
-    memcpy (requestChars, zmq_msg_data (&request), rc);
-    zmq_msg_close(&request);
-    requestChars[rc]=0;
-    return std::string(requestChars);
+/* Reply as the API message followed by a LE 4 byte sequence number, like the publisher messages */
+bool CZMQAbstractReplier::SendReply(void *socket, const std::string& reply)
+{
+    unsigned char msgseq[sizeof(uint32_t)];
+    WriteLE32(&msgseq[0], nReplySequence++);
+
+    if (zmq_send(socket, reply.c_str(), reply.length(), ZMQ_SNDMORE) == -1)
+        return false;
+    return zmq_send(socket, msgseq, sizeof(msgseq), 0) != -1;
 }
 
 bool CZMQAbstractReplier::Socket(){
@@ -144,12 +114,23 @@ bool CZMQAbstractReplier::Socket(){
 
     assert(!psocket);
 
-    psocket = zmq_socket(pcontext,ZMQ_REP);
+    psocket = zmq_socket(pcontext,ZMQ_ROUTER);
     if(!psocket){
         //TODO fail
         LogPrintf("ZMQ: Failed to create psocket\n");
         return false;
     }
+
+    pbackend = zmq_socket(pcontext,ZMQ_DEALER);
+    if(!pbackend){
+        LogPrintf("ZMQ: Failed to create backend socket\n");
+        return false;
+    }
+    backendAddress = "inproc://api-" + type;
+    if(zmq_bind(pbackend, backendAddress.c_str()) != 0){
+        zmqError("Failed to bind backend socket");
+        return false;
+    }
     return true;
 }
 
@@ -192,23 +173,38 @@ bool CZMQAbstractReplier::Initialize()
     Socket();
     Auth();
     Bind();
-    worker = new boost::thread(boost::bind(&CZMQAbstractReplier::Thread, this));
-    LogPrintf("ZMQ: created and ran thread\n");
+
+    int nWorkers = std::max(1, std::min((int)GetArg("-apiworkers", DEFAULT_API_WORKERS), MAX_API_WORKERS));
+    for (int i = 0; i < nWorkers; i++)
+        workers.push_back(new boost::thread(boost::bind(&CZMQAbstractReplier::Worker, this)));
+    proxy = new boost::thread(boost::bind(&CZMQAbstractReplier::Proxy, this));
+    LogPrintf("ZMQ: started %s with %d workers\n", type, nWorkers);
     return true;
 }
 
 void CZMQAbstractReplier::Shutdown()
 {
+    if (!pcontext)
+        return;
+
     LogPrintf("shutting down replier..\n");
-    if (pcontext) // prematurely end context in order to let threads run out
-    {
-        pcontext = 0;
-    }
 
-    KEEPALIVE = 0; // end infinite loop in thread 
-    worker->interrupt(); // terminate boost thread
+    KEEPALIVE = false; // end worker loops
+    // wake up the workers and the proxy, blocking calls fail with ETERM from now on
+    zmq_ctx_shutdown(pcontext);
 
-    boost::this_thread::sleep_for(boost::chrono::milliseconds(100)); // wait allowing thread to finish up
+    BOOST_FOREACH(boost::thread* worker, workers)
+    {
+        worker->join();
+        delete worker;
+    }
+    workers.clear();
+    if (proxy)
+    {
+        proxy->join();
+        delete proxy;
+        proxy = NULL;
+    }
 
     assert(psocket);
 
@@ -218,9 +214,16 @@ void CZMQAbstractReplier::Shutdown()
     zmq_setsockopt(psocket, ZMQ_LINGER, &linger, sizeof(linger));
     zmq_close(psocket);
     psocket = 0;
+    if (pbackend)
+    {
+        zmq_setsockopt(pbackend, ZMQ_LINGER, &linger, sizeof(linger));
+        zmq_close(pbackend);
+        pbackend = 0;
+    }
     LogPrintf("closed psocket\n");
 
     zmq_ctx_destroy(pcontext);
+    pcontext = 0;
 
     LogPrintf("replier shutdown\n");
 }
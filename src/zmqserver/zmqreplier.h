@@ -6,19 +6,30 @@
 #define ZCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
 
 #include "zmqabstract.h"
+#include <atomic>
+#include <vector>
 #include <boost/thread/thread.hpp>
 
 class CBlockIndex;
 
+/**
+ * Replier for API requests. Clients connect to a ROUTER socket, requests are handed through an
+ * in-process DEALER socket to a pool of worker threads, each with its own REP socket. Calls which
+ * change the wallet are serialized in CAPITable::execute, read-only calls run in parallel.
+ */
 class CZMQAbstractReplier : public CZMQAbstract
-{  
+{
 protected:
-    int KEEPALIVE = 1;
-    int rc;
-    zmq_msg_t request;
-    boost::thread* worker;
+    std::atomic<bool> KEEPALIVE;
+    void *pbackend;
+    std::string backendAddress;
+    boost::thread* proxy;
+    std::vector<boost::thread*> workers;
+    std::atomic<uint32_t> nReplySequence;
 
 public:
+    CZMQAbstractReplier() : KEEPALIVE(true), pbackend(0), proxy(NULL), nReplySequence(0) { }
+
     // Initialization
     bool Initialize();
     void Shutdown();
@@ -26,19 +37,19 @@ public:
     bool Bind();
 
     // Thread handling
-    std::string ReadRequest();
-    bool Wait();
-    bool SendResponse();
+    void Proxy();
+    void Worker();
+    bool SendReply(void *socket, const std::string& reply);
 
-    virtual void* Thread() = 0;
     virtual bool Auth() = 0;
+    virtual bool IsAuthPort() const = 0;
 };
 
 class CZMQAuthReplier : public CZMQAbstractReplier
 {
 public:
     bool Auth();
-    void* Thread();
+    bool IsAuthPort() const { return true; }
 
 };
 
@@ -46,7 +57,7 @@ class CZMQOpenReplier : public CZMQAbstractReplier
 {
 public:
     bool Auth(){ return true; };
-    void* Thread();
+    bool IsAuthPort() const { return false; }
 
 };
 